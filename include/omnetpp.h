@@ -50,6 +50,7 @@
 #include "omnetpp/cexpression.h"
 #include "omnetpp/chasher.h"
 #include "omnetpp/cfingerprint.h"
+#include "omnetpp/ceventprofiler.h"
 #include "omnetpp/checkandcast.h"
 #include "omnetpp/cfsm.h"
 #include "omnetpp/cfutureeventset.h"
@@ -66,11 +67,13 @@
 #include "omnetpp/simtimemath.h"
 #include "omnetpp/simtime_t.h"
 #include "omnetpp/cmessage.h"
+#include "omnetpp/cmemorypool.h"
 #include "omnetpp/cmessageprinter.h"
 #include "omnetpp/cmsgpar.h"
 #include "omnetpp/cmodelchange.h"
 #include "omnetpp/cmodule.h"
 #include "omnetpp/ceventheap.h"
+#include "omnetpp/ccalendarqueue.h"
 #include "omnetpp/cmatchexpression.h"
 #include "omnetpp/cpatternmatcher.h"
 #include "omnetpp/cnedfunction.h"
@@ -78,6 +81,7 @@
 #include "omnetpp/cvaluearray.h"
 #include "omnetpp/cvaluemap.h"
 #include "omnetpp/cnedmathfunction.h"
+#include "omnetpp/cnetworkpartitioner.h"
 #include "omnetpp/cobject.h"
 #include "omnetpp/cnamedobject.h"
 #include "omnetpp/cnullenvir.h"
@@ -92,6 +96,7 @@
 #include "omnetpp/cpsquare.h"
 #include "omnetpp/cqueue.h"
 #include "omnetpp/cpacket.h"
+#include "omnetpp/ctimeouttimer.h"
 #include "omnetpp/cpacketqueue.h"
 #include "omnetpp/cprecolldensityest.h"
 #include "omnetpp/crandom.h"
@@ -102,6 +107,7 @@
 #include "omnetpp/cscheduler.h"
 #include "omnetpp/csimplemodule.h"
 #include "omnetpp/csimulation.h"
+#include "omnetpp/cstatesaving.h"
 #include "omnetpp/cstatistic.h"
 #include "omnetpp/cstatisticbuilder.h"
 #include "omnetpp/cstddev.h"
@@ -0,0 +1,218 @@
+//==========================================================================
+//  CCALENDARQUEUE.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CCALENDARQUEUE_H
+#define __OMNETPP_CCALENDARQUEUE_H
+
+#include <vector>
+#include "cfutureeventset.h"
+#include "simtime_t.h"
+
+namespace omnetpp {
+
+/**
+ * @brief Future event set implemented as a calendar queue with adaptive
+ * bucket width.
+ *
+ * Events are hashed into an array of buckets ("days") by their arrival time,
+ * each bucket covering a fixed time interval. Within a bucket, events are
+ * kept sorted in scheduling order. Insertion and removal of the first event
+ * have amortized O(1) cost as long as the bucket width matches the typical
+ * time separation of events near the front of the FES, so this class may
+ * outperform cEventHeap for very large event sets (millions of events).
+ * The number of buckets and the bucket width are recomputed when the
+ * number of events grows or shrinks by a factor of two, by sampling events
+ * at the front of the queue.
+ *
+ * Events are ordered exactly the same way as with cEventHeap (arrival time,
+ * scheduling priority, insertion order), so simulation results and
+ * fingerprints do not depend on the choice of the FES implementation.
+ *
+ * To use it, add <tt>futureeventset-class = "omnetpp::cCalendarQueue"</tt>
+ * to the configuration.
+ *
+ * @ingroup SimSupport
+ */
+class SIM_API cCalendarQueue : public cFutureEventSet
+{
+  private:
+    // events in a bucket are stored in scheduling order in items[head..end);
+    // events removed from the front only advance head, so that the common
+    // case of removing the first event does not need to move memory
+    struct Bucket {
+        std::vector<cEvent*> items;
+        size_t head = 0;
+        bool isEmpty() const {return head == items.size();}
+        size_t size() const {return items.size() - head;}
+        cEvent *front() const {return items[head];}
+    };
+
+    std::vector<Bucket> buckets; // number of buckets is always a power of 2
+    int bucketMask;              // buckets.size()-1
+    int64_t width;               // bucket width, in raw simtime units
+    mutable int64_t currentSlot; // index of the "day" to start searching for the first event at; no event precedes it
+    int length;                  // number of events in the FES
+    int minBuckets;              // never shrink below this number of buckets
+    mutable bool needsRewidth;   // set when the first event could only be found by direct search
+    eventnumber_t insertCount;   // counts insertions; determines order of events with equal time and priority
+
+    // caches to support random access via get(k)
+    std::vector<cEvent*> snapshot;
+    bool snapshotValid = false;
+
+  private:
+    void copy(const cCalendarQueue& other);
+    int64_t slotOf(const cEvent *event) const;
+    int bucketOf(int64_t slot) const {return (int)(slot & bucketMask);}
+    int findFirstBucket() const;
+    void bucketInsert(cEvent *event);
+    void resize(int newNumBuckets);
+    int64_t computeWidth(std::vector<cEvent*>& events) const;
+    void invalidateSnapshot() {snapshotValid = false;}
+    void buildSnapshot();
+
+  public:
+    /** @name Constructors, destructor, assignment */
+    //@{
+
+    /**
+     * Copy constructor.
+     */
+    cCalendarQueue(const cCalendarQueue& other);
+
+    /**
+     * Constructor. The number of buckets is rounded up to a power of two.
+     */
+    cCalendarQueue(const char *name=nullptr, int initialBuckets=64);
+
+    /**
+     * Destructor.
+     */
+    virtual ~cCalendarQueue();
+
+    /**
+     * Assignment operator. The name member is not copied;
+     * see cOwnedObject's operator=() for more details.
+     */
+    cCalendarQueue& operator=(const cCalendarQueue& other);
+    //@}
+
+    /** @name Redefined cObject member functions. */
+    //@{
+
+    /**
+     * Creates and returns an exact copy of this object.
+     * See cObject for more details.
+     */
+    virtual cCalendarQueue *dup() const override  {return new cCalendarQueue(*this);}
+
+    /**
+     * Produces a one-line description of the object's contents.
+     * See cObject for more details.
+     */
+    virtual std::string str() const override;
+
+    /**
+     * Calls v->visit(this) for each contained object.
+     * See cObject for more details.
+     */
+    virtual void forEachChild(cVisitor *v) override;
+
+    // no parsimPack() and parsimUnpack()
+    //@}
+
+    /** @name Simulation-related operations. */
+    //@{
+    /**
+     * Insert an event into the FES.
+     */
+    virtual void insert(cEvent *event) override;
+
+    /**
+     * Peek the first event in the FES (the one with the smallest timestamp.)
+     * If the FES is empty, it returns nullptr.
+     */
+    virtual cEvent *peekFirst() const override;
+
+    /**
+     * Removes and return the first event in the FES (the one with the
+     * smallest timestamp.) If the FES is empty, it returns nullptr.
+     */
+    virtual cEvent *removeFirst() override;
+
+    /**
+     * Undo for removeFirst(): it puts back an event to the front of the FES.
+     */
+    virtual void putBackFirst(cEvent *event) override;
+
+    /**
+     * Removes and returns the given event in the FES. If the event is
+     * not in the FES, returns nullptr.
+     */
+    virtual cEvent *remove(cEvent *event) override;
+
+    /**
+     * Returns true if the FES is empty.
+     */
+    virtual bool isEmpty() const override {return length == 0;}
+
+    /**
+     * Deletes all events in the FES.
+     */
+    virtual void clear() override;
+    //@}
+
+    /** @name Random access. */
+    //@{
+
+    /**
+     * Returns the number of events in the FES.
+     */
+    virtual int getLength() const override {return length;}
+
+    /**
+     * Returns the kth event in the FES if 0 <= k < getLength(), and nullptr
+     * otherwise. Note that iteration does not necessarily return events
+     * in increasing timestamp (getArrivalTime()) order unless you called
+     * sort() before.
+     */
+    virtual cEvent *get(int k) override;
+
+    /**
+     * Sorts the contents of the FES. This is only necessary if one wants
+     * to iterate through in the FES in strict timestamp order.
+     */
+    virtual void sort() override;
+    //@}
+
+    /** @name Calendar parameters. */
+    //@{
+    /**
+     * Returns the current number of buckets.
+     */
+    int getNumBuckets() const {return (int)buckets.size();}
+
+    /**
+     * Returns the current bucket width.
+     */
+    simtime_t getBucketWidth() const {return SimTime::fromRaw(width);}
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
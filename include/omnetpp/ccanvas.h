@@ -318,7 +318,7 @@ class SIM_API cFigure : public cOwnedObject
         };
 
     private:
-        static int lastId;
+        static OPP_THREAD_LOCAL int lastId;
         static cStringPool stringPool;
         int id;
         double zIndex;
@@ -17,6 +17,7 @@
 #define __OMNETPP_CCOMMBUFFER_H
 
 #include <cstdint>
+#include <type_traits>
 #include "cobject.h"
 #include "simtime.h"
 
@@ -363,6 +364,70 @@ class SIM_API cCommBuffer : public cObject
     virtual void unpack(SimTime *d, int size) = 0;
     //@}
 
+    /** @name Bulk packing of raw data */
+    //@{
+    /**
+     * Packs the given number of bytes as raw data. It should be unpacked
+     * with unpackBytes(). Note that no conversion is made between different
+     * data representations, so this is only suitable for partitions running
+     * on machines with the same architecture.
+     */
+    void packBytes(const void *data, int size)  {pack((const char *)data, size);}
+
+    /**
+     * Unpacks raw data stored by packBytes() or packExternal().
+     */
+    void unpackBytes(void *data, int size)  {unpack((char *)data, size);}
+
+    /**
+     * Packs an array of trivially copyable objects (e.g. numbers or structs
+     * of numbers) with a single copy, instead of field by field. It should
+     * be unpacked with unpackPodArray(). The same architecture restrictions
+     * apply as with packBytes().
+     */
+    template<typename T>
+    void packPodArray(const T *d, int size) {
+        static_assert(std::is_trivially_copyable<T>::value, "packPodArray() requires a trivially copyable type");
+        packBytes(d, size * sizeof(T));
+    }
+
+    /**
+     * Unpacks an array stored with packPodArray().
+     */
+    template<typename T>
+    void unpackPodArray(T *d, int size) {
+        static_assert(std::is_trivially_copyable<T>::value, "unpackPodArray() requires a trivially copyable type");
+        unpackBytes(d, size * sizeof(T));
+    }
+
+    /**
+     * Like packBytes(), but if zero-copy packing is enabled for the buffer
+     * (see isZeroCopyEnabled()), the data may not be copied into the buffer,
+     * only a reference to it is stored, and the communications layer transmits
+     * it directly from the given location (scatter/gather). The data must then
+     * remain valid and unchanged until the buffer is sent. The receiver sees
+     * the data in place, and unpacks it with unpackBytes(). This method is
+     * useful for large payloads, e.g. in parsimPack() of packets.
+     *
+     * The default implementation copies the data via packBytes().
+     */
+    virtual void packExternal(const void *data, int size)  {packBytes(data, size);}
+
+    /**
+     * Enables or disables storing references to external data in packExternal().
+     * The communications classes enable it for buffers that are sent immediately
+     * after packing; it must be disabled for buffers that outlive the packed
+     * objects. The default implementation ignores the call.
+     */
+    virtual void setZeroCopyEnabled(bool)  {}
+
+    /**
+     * Returns true if packExternal() may store references instead of copying
+     * the data. The default implementation returns false.
+     */
+    virtual bool isZeroCopyEnabled() const  {return false;}
+    //@}
+
     /** @name Utility functions */
     //@{
     /**
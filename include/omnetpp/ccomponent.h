@@ -18,6 +18,9 @@
 
 #include <vector>
 #include "simkerneldefs.h"
+#ifdef WITH_THREADED_PARSIM
+#include <atomic>
+#endif
 #include "cownedobject.h"
 #include "cpar.h"
 #include "cdefaultowner.h"
@@ -51,7 +54,7 @@ class SIM_API cComponent : public cDefaultOwner //implies noncopyable
     friend class cComponent__SignalListenerListDescriptor;  // sim_std.msg
     friend class cPar; // needs to call handleParameterChange()
     friend class cChannel; // allow access to FL_INITIALIZED, FL_DELETING and releaseLocalListeners()
-    friend class cModule; // allow access to FL_INITIALIZED, FL_DELETING, releaseLocalListeners() and repairSignalFlags()
+    friend class cModule; // allow access to componentType, FL_INITIALIZED, FL_DELETING, releaseLocalListeners(), repairSignalFlags() and invalidateListenerChains()
     friend class cSimpleModule; // allow access to FL_INITIALIZED, FL_DELETING, releaseLocalListeners() and repairSignalFlags()
     friend class cGate;   // because of repairSignalFlags()
     friend class cSimulation; // sets componentId
@@ -107,14 +110,18 @@ class SIM_API cComponent : public cDefaultOwner //implies noncopyable
         std::map<std::string,simsignal_t> signalNameToID;
         std::map<simsignal_t,std::string> signalIDToName;
     } *signalNameMapping;  // must be dynamically allocated on first access so that registerSignal() can be invoked from static initialization code
+#ifdef WITH_THREADED_PARSIM
+    static std::atomic<int> lastSignalID;  // signal registrations are shared by all threads
+#else
     static int lastSignalID;
+#endif
 
     // for hasListeners()/mayHaveListeners()
-    static std::vector<int> signalListenerCounts;  // index: signalID, value: number of listeners anywhere
+    static OPP_THREAD_LOCAL std::vector<int> signalListenerCounts;  // index: signalID, value: number of listeners anywhere
 
     // stack of listener lists being notified, to detect concurrent modification
-    static cIListener **notificationStack[];
-    static int notificationSP;
+    static OPP_THREAD_LOCAL cIListener **notificationStack[];
+    static OPP_THREAD_LOCAL int notificationSP;
 
     // whether only signals declared in NED via @signal are allowed to be emitted
     static bool checkSignals;
@@ -126,7 +133,29 @@ class SIM_API cComponent : public cDefaultOwner //implies noncopyable
     };
 
     // for getResultRecorders(); static because we don't want to increase cComponent's size
-    static std::vector<ResultRecorderList*> cachedResultRecorderLists;
+    static OPP_THREAD_LOCAL std::vector<ResultRecorderList*> cachedResultRecorderLists;
+
+    // for fire(): the listener lists of this component and its ancestors that
+    // contain listeners for a signal, starting from this component and going up
+    struct ListenerChain {
+        struct Level {
+            cComponent *component;
+            cIListener **listeners;  // same as in the component's SignalListenerList
+        };
+        simsignal_t signalID;
+        std::vector<Level> levels;
+    };
+
+    // listener chains of signals emitted by this component; they are valid
+    // as long as version equals listenerChainVersion
+    struct ListenerChainCache {
+        uint64_t version;
+        std::vector<ListenerChain> chains;
+    };
+    ListenerChainCache *listenerChainCache; // created on first emit()
+
+    // incremented when a listener list or the module tree changes, invalidating all listener chains
+    static OPP_THREAD_LOCAL uint64_t listenerChainVersion;
 
   private:
     SignalListenerList *findListenerList(simsignal_t signalID) const;
@@ -134,7 +163,11 @@ class SIM_API cComponent : public cDefaultOwner //implies noncopyable
     void throwInvalidSignalID(simsignal_t signalID) const;
     void removeListenerList(simsignal_t signalID);
     void checkNotFiring(simsignal_t, cIListener **listenerList);
+    const ListenerChain& getListenerChain(simsignal_t signalID);
+    static void invalidateListenerChains() {listenerChainVersion++;}
     template<typename T> void fire(cComponent *src, simsignal_t signalID, T x, cObject *details);
+    template<typename T> void fireUncached(cComponent *src, simsignal_t signalID, T x, cObject *details);
+    template<typename T> void notifyListeners(cIListener **listeners, cComponent *src, simsignal_t signalID, T x, cObject *details);
     void fireFinish();
     void releaseLocalListeners();
     const SignalListenerList& getListenerList(int k) const {return (*signalTable)[k];} // for inspectors
@@ -934,6 +967,10 @@ class SIM_API cComponent : public cDefaultOwner //implies noncopyable
     bool mayHaveListeners(simsignal_t signalID) const {
         if (signalID < 0 || signalID > lastSignalID)
             throwInvalidSignalID(signalID);
+#ifdef WITH_THREADED_PARSIM
+        if (signalID >= (int)signalListenerCounts.size())
+            return false;  // registered in another thread, and nobody has subscribed to it in this one
+#endif
         return signalListenerCounts[signalID] > 0;
     }
 
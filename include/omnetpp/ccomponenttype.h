@@ -19,6 +19,12 @@
 #include <string>
 #include <map>
 #include <set>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+#ifdef WITH_THREADED_PARSIM
+#include <mutex>
+#endif
 #include "cpar.h"
 #include "cgate.h"
 #include "cownedobject.h"
@@ -134,6 +140,13 @@ class SIM_API cComponentType : public cNoncopyableOwnedObject
     // internal: returns the @signal property for the given signal, or nullptr if not found
     virtual cProperty *getSignalDeclaration(const char *signalName);
 
+#ifdef WITH_THREADED_PARSIM
+    // internal: component types and the data they cache are shared by the
+    // partitions of a threaded parallel simulation; this lock serializes
+    // component creation, parameter finalization and buildInside() among them
+    static std::recursive_mutex& getCreationMutex();
+#endif
+
   public:
     /** @name Constructors, destructor, assignment */
     //@{
@@ -198,6 +211,24 @@ class SIM_API cComponentType : public cNoncopyableOwnedObject
 class SIM_API cModuleType : public cComponentType
 {
     friend class cModule;
+  private:
+    struct CStrHash {
+        size_t operator()(const char *s) const {size_t h = 5381; while (*s) h = h * 33 + (unsigned char)*s++; return h;}
+    };
+    struct CStrEqual {
+        bool operator()(const char *s1, const char *s2) const {return strcmp(s1, s2) == 0;}
+    };
+    // gate name (incl. "name$i"/"name$o" for inout gates) -> index into the gate
+    // descriptor array of modules of this type; speeds up cModule::findGateDesc().
+    // Built from the first module created, and not modified afterwards. Keys point
+    // into gateDescNames, so lookups need no std::string.
+    std::vector<std::string> gateDescNames;
+    std::unordered_map<const char *,int,CStrHash,CStrEqual> gateDescIndices;
+    bool gateDescIndicesBuilt = false;
+
+  private:
+    void buildGateDescIndices(cModule *mod);
+
   protected:
     // internal: create the module object
     virtual cModule *createModuleObject() = 0;
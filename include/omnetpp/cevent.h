@@ -44,6 +44,12 @@ class SIM_API cEvent : public cOwnedObject
 {
     friend class cMessage;     // getArrivalTime()
     friend class cEventHeap;   // heapIndex
+    friend class cCalendarQueue; // heapIndex
+  protected:
+    enum {
+        FL_ISDEFERRED = 32,    // used by cTimeoutTimer: expiry was extended while in the FES
+        FL_ISTRACKED = 64,     // the FES listener is notified when the object is deleted
+    };
   private:
     simtime_t arrivalTime;     // time of delivery -- set internally
     short priority;            // priority -- used for scheduling events with equal arrival times
@@ -63,6 +69,17 @@ class SIM_API cEvent : public cOwnedObject
     // internal: used by cEventHeap.
     eventnumber_t getInsertOrder() const {return insertOrder;}
 
+    // internal: used by cSimulation to detect cTimeoutTimers that may need
+    // to be re-inserted into the FES instead of being executed
+    bool isDeferred() const {return flags & FL_ISDEFERRED;}
+
+    // internal: used by optimistic parallel simulation. When set, the FES listener
+    // (see cSimulation::setFESListener()) is notified when the object is deleted.
+    void setTracked(bool b) {setFlag(FL_ISTRACKED, b);}
+
+    // internal: see setTracked().
+    bool isTracked() const {return flags & FL_ISTRACKED;}
+
     // internal: called by the simulation kernel to set the value returned
     // by the getArrivalTime() method
     void setArrivalTime(simtime_t t) {arrivalTime = t;}
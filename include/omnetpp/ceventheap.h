@@ -21,24 +21,40 @@
 namespace omnetpp {
 
 /**
- * @brief The default, binary heap based implementation of the future event set.
+ * @brief The default, heap based implementation of the future event set.
  *
- * Using binary heap as the underlying data structure provides reliable
+ * Using a heap as the underlying data structure provides reliable
  * performance for most workloads. A worst case for heap is insertion at the
  * front (i.e. for the current simulation time), which is actually quite common,
  * due to the abundance of zero-delay links in models. This case is optimized
  * by employing an additional circular buffer specifically for storing events
  * inserted scheduled for the current simulation time.
  *
+ * The heap is 4-ary, and it stores a copy of the ordering fields of each event
+ * (arrival time, scheduling priority, insertion order) next to the event pointer.
+ * The keys of the four children of a node occupy exactly one cache line, so
+ * restoring the heap property costs one cache line access per level, and
+ * comparisons never need to dereference the event objects.
+ *
  * @ingroup SimSupport
  */
 class SIM_API cEventHeap : public cFutureEventSet
 {
   private:
-    // heap data structure
-    cEvent **heap;            // heap array  (heap[0] always empty)
+    // sort key of an event, stored in the heap; less() orders keys the same
+    // way as cEvent::shouldPrecede() orders the corresponding events
+    struct Key {
+        int64_t time;              // raw arrival time
+        uint64_t priorityAndOrder; // biased scheduling priority in the upper 16 bits, insertion order in the lower 48 bits
+    };
+
+    // heap data structure: node i (1-based) is stored in keys[i] and heap[i];
+    // children of node i are 4i-2..4i+1, which are cache line aligned in keys[]
+    Key *keys;                // sort keys
+    char *keyBuffer;          // allocated memory for keys[]
+    cEvent **heap;            // events, parallel to keys[]
     int heapLength;           // number of elements on the heap
-    int heapCapacity;         // allocated size of the heap[] array
+    int heapCapacity;         // allocated size of the keys[] and heap[] arrays
     eventnumber_t insertCount; // counts insertions; needed because heap's insert is not stable (does not keep order)
 
     // circular buffer for events scheduled for the current simtime (quite frequent); acts as FIFO
@@ -50,8 +66,16 @@ class SIM_API cEventHeap : public cFutureEventSet
   private:
     void copy(const cEventHeap& other);
 
+    static bool less(const Key& a, const Key& b) {return a.time < b.time || (a.time == b.time && a.priorityAndOrder < b.priorityAndOrder);}
+    static Key makeKey(const cEvent *event);
+    static int parentOf(int i) {return (i+2) >> 2;}
+    static int firstChildOf(int i) {return (i<<2) - 2;}
+
     // internal: restore heap
-    void shiftup(int from=1);
+    void siftUp(int i, const Key& key, cEvent *event);
+    void siftDown(int i, const Key& key, cEvent *event);
+    void allocateHeap(int capacity);
+    void growHeap();
 
     int cblength() const  {return (cbtail-cbhead) & (cbsize-1);}
     cEvent *cbget(int k)  {return cb[(cbhead+k) & (cbsize-1)];}
@@ -146,6 +170,14 @@ class SIM_API cEventHeap : public cFutureEventSet
      */
     virtual cEvent *remove(cEvent *event) override;
 
+    /**
+     * Changes the arrival time of an event in the FES, and moves it to its
+     * new position. Events in the heap are moved in place (sift up or down
+     * from their current position); the outcome is the same as that of
+     * remove() plus insert().
+     */
+    virtual void reschedule(cEvent *event, simtime_t t) override;
+
     /**
      * Returns true if the FES is empty.
      */
@@ -0,0 +1,233 @@
+//==========================================================================
+//  CEVENTPROFILER.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CEVENTPROFILER_H
+#define __OMNETPP_CEVENTPROFILER_H
+
+#include <string>
+#include <vector>
+#include <typeinfo>
+#include <unordered_map>
+#include "cobject.h"
+#include "clifecyclelistener.h"
+
+namespace omnetpp {
+
+class cModule;
+class cModuleType;
+
+/**
+ * @brief Collects per-module and per-message-class event execution costs.
+ *
+ * When an event profiler is installed in the simulation (see
+ * cSimulation::setEventProfiler()), the simulation kernel measures the
+ * wall-clock time spent in processing each event, and accounts it to the
+ * module that processed the event and to the class of the message (or
+ * other cEvent subclass). Insertions into the future event set are also
+ * counted, both for the module that did the insertion and for the
+ * class of the inserted event. Measuring is done with a monotonic clock,
+ * and accounting is a vector index and a hash table lookup, so the overhead
+ * is small enough to keep profiling enabled for long runs.
+ *
+ * At the end of the simulation (on LF_POST_NETWORK_FINISH), the profiler
+ * records the per-module figures as scalars (<tt>eventProfile:numEvents</tt>,
+ * <tt>eventProfile:numFesInserts</tt> and <tt>eventProfile:time</tt>),
+ * and optionally writes a JSON report that also contains the figures
+ * summed up per NED type and per event class. Modules deleted during the
+ * simulation are only included in the per-type sums. The number of messages
+ * exchanged between modules is also counted, which allows the profiler to
+ * compute a partitioning of the network for parallel simulation (see
+ * setPartitioning()). In simulations, the profiler is enabled with the
+ * <tt>event-profiling</tt> configuration option.
+ *
+ * @ingroup SimSupport
+ */
+class SIM_API cEventProfiler : public cObject, public cISimulationLifecycleListener, noncopyable
+{
+  public:
+    /**
+     * Costs accumulated for a module, module type or event class.
+     */
+    struct Stats {
+        int64_t numEvents = 0;      // number of events processed
+        int64_t numFesInserts = 0;  // number of events inserted into the FES
+        int64_t nanosecs = 0;       // wall-clock time spent in processing the events
+    };
+
+    /**
+     * The number of messages sent from one module to another.
+     */
+    struct Traffic {
+        int senderModuleId;
+        int arrivalModuleId;
+        int64_t numMessages;
+    };
+
+  private:
+    std::vector<Stats> moduleStats;  // indexed by module ID
+    std::vector<cModuleType *> moduleTypes;  // indexed by module ID; stored so that deleted modules can be included in the per-type sums
+    std::unordered_map<const std::type_info *, Stats> classStats;
+    const std::type_info *lastClass = nullptr;  // one-entry cache for classStats lookups
+    Stats *lastClassStats = nullptr;
+    Stats otherStats;  // events not processed by a module
+    std::unordered_map<uint64_t, int64_t> trafficStats;  // (senderModuleId, arrivalModuleId) -> number of messages
+    std::string reportFile;
+    bool scalarRecording;
+    int numPartitions = 0;  // if nonzero, the network is partitioned at the end
+    std::string partitionsFile;
+    double maxImbalance = 0.05;
+
+  private:
+    Stats& getModuleStats(int id) {
+        if (id >= (int)moduleStats.size())
+            growModuleStats(id);
+        return moduleStats[id];
+    }
+    void growModuleStats(int id);
+    Stats& getClassStats(const std::type_info& eventClass) {
+        if (&eventClass != lastClass) {
+            lastClass = &eventClass;
+            lastClassStats = &classStats[&eventClass];  // note: unordered_map never invalidates references
+        }
+        return *lastClassStats;
+    }
+
+  public:
+    /**
+     * Constructor. If reportFile is non-empty, a JSON report is written
+     * to that file at the end of the simulation.
+     */
+    explicit cEventProfiler(const char *reportFile=nullptr, bool recordScalars=true);
+
+    /** @name Accounting. These methods are called by the simulation kernel. */
+    //@{
+    /**
+     * Called before processing an event in the given module. It remembers
+     * the module's type, because the module may be deleted during the event.
+     */
+    void eventStarting(int moduleId, cModule *module) {
+        if (moduleId >= (int)moduleTypes.size() || moduleTypes[moduleId] == nullptr)
+            moduleStarting(moduleId, module);
+    }
+
+    /**
+     * Called after an event has been processed. moduleId is -1 for events
+     * that are not messages.
+     */
+    void eventEnded(int moduleId, const std::type_info& eventClass, int64_t nanosecs) {
+        Stats& stats = moduleId < 0 ? otherStats : getModuleStats(moduleId);
+        stats.numEvents++;
+        stats.nanosecs += nanosecs;
+        Stats& cstats = getClassStats(eventClass);
+        cstats.numEvents++;
+        cstats.nanosecs += nanosecs;
+    }
+
+    /**
+     * Called before processing a message that was sent by another module.
+     * senderModuleId is -1 if the sender is not known, e.g. because the
+     * message came from another partition.
+     */
+    void messageArrived(int senderModuleId, int arrivalModuleId) {
+        if (senderModuleId >= 0)
+            trafficStats[((uint64_t)senderModuleId << 32) | (uint32_t)arrivalModuleId]++;
+    }
+
+    /**
+     * Called when an event is inserted into the FES. moduleId is that of
+     * the context module, or -1 if there is none.
+     */
+    void eventInserted(int moduleId, const std::type_info& eventClass) {
+        (moduleId < 0 ? otherStats : getModuleStats(moduleId)).numFesInserts++;
+        getClassStats(eventClass).numFesInserts++;
+    }
+    //@}
+
+    /** @name Results. */
+    //@{
+    /**
+     * Returns the statistics of the module with the given ID.
+     */
+    const Stats& getStatsForModule(int moduleId) const;
+
+    /**
+     * Returns the statistics summed up over all (existing and deleted)
+     * modules of the given NED type.
+     */
+    Stats getStatsForType(cModuleType *type) const;
+
+    /**
+     * Returns the statistics of the given event class, summed up over
+     * all modules.
+     */
+    Stats getStatsForClass(const char *className) const;
+
+    /**
+     * Returns the statistics of events that were not processed by any
+     * module, i.e. those that are not messages.
+     */
+    const Stats& getStatsForOther() const {return otherStats;}
+
+    /**
+     * Returns the number of messages that arrived at the given module
+     * from the other given module.
+     */
+    int64_t getNumMessages(int senderModuleId, int arrivalModuleId) const;
+
+    /**
+     * Returns the number of messages sent between modules, for all pairs
+     * of modules that exchanged messages.
+     */
+    std::vector<Traffic> getTraffic() const;
+
+    /**
+     * Records the per-module results as scalars of the existing modules.
+     */
+    void recordScalars();
+
+    /**
+     * Writes a JSON report with the per-module, per-type and per-class
+     * results into the given file.
+     */
+    void writeJsonReport(const char *fileName);
+
+    /**
+     * Clears all collected statistics.
+     */
+    void clear();
+    //@}
+
+    /** @name Partitioning. */
+    //@{
+    /**
+     * If numPartitions is nonzero, the network is partitioned into that many
+     * partitions at the end of the simulation using the collected event and
+     * message counts (see cNetworkPartitioner), and the resulting
+     * <tt>partition-id</tt> settings are written into the given file.
+     * maxImbalance is passed to cNetworkPartitioner::setMaxImbalance().
+     */
+    void setPartitioning(int numPartitions, const char *fileName, double maxImbalance=0.05);
+    //@}
+
+  protected:
+    void moduleStarting(int moduleId, cModule *module);
+    virtual void lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details) override;
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
@@ -17,6 +17,7 @@
 #define __OMNETPP_CFUTUREEVENTSET_H
 
 #include "cownedobject.h"
+#include "simtime_t.h"
 
 namespace omnetpp {
 
@@ -91,6 +92,17 @@ class SIM_API cFutureEventSet : public cOwnedObject
      */
     virtual cEvent *remove(cEvent *event) = 0;
 
+    /**
+     * Changes the arrival time of an event in the FES to t, and moves it
+     * to its new position. The outcome must be the same as that of removing
+     * the event, updating its arrival time and inserting it again (i.e. the
+     * event also gets a new insertion order), and this is exactly what the
+     * default implementation does. Subclasses may override it with a more
+     * efficient, in-place operation. If the event is not in the FES, it is
+     * simply inserted.
+     */
+    virtual void reschedule(cEvent *event, simtime_t t);
+
     /**
      * Returns true if the FES is empty.
      */
@@ -130,6 +142,51 @@ class SIM_API cFutureEventSet : public cOwnedObject
     //@}
 };
 
+/**
+ * @brief Interface for objects that need to be notified about the changes the
+ * model makes to the future event set.
+ *
+ * The listener is installed with cSimulation::setFESListener(). It is notified
+ * about events inserted via cSimulation::insertEvent() (i.e. by send(),
+ * scheduleAt() and similar methods), rescheduled via cSimulation::rescheduleEvent(),
+ * and cancelled via cSimpleModule::cancelEvent(). Changes made directly through
+ * the cFutureEventSet interface are not reported. The listener is also notified
+ * when an event object marked with cEvent::setTracked() is deleted.
+ *
+ * This interface is used by optimistic parallel simulation (cTimeWarpProtocol),
+ * which needs to be able to undo the effects of events.
+ *
+ * @ingroup SimSupport
+ */
+class SIM_API cIFutureEventSetListener
+{
+  public:
+    virtual ~cIFutureEventSetListener() {}
+
+    /**
+     * Called after the event has been inserted into the FES.
+     */
+    virtual void eventInserted(cEvent *event) = 0;
+
+    /**
+     * Called after the event has been moved to a new arrival time within
+     * the FES; oldTime is its previous arrival time. For messages rescheduled
+     * via cSimpleModule::rescheduleAt(), it is called before the sending time
+     * of the message is updated, so the listener may still read the old one.
+     */
+    virtual void eventRescheduled(cEvent *event, simtime_t oldTime) = 0;
+
+    /**
+     * Called after the event has been removed from the FES by cancelEvent().
+     */
+    virtual void eventCancelled(cEvent *event) = 0;
+
+    /**
+     * Called from the destructor of event objects marked as tracked.
+     */
+    virtual void trackedEventDeleted(cEvent *event) = 0;
+};
+
 }  // namespace omnetpp
 
 #endif
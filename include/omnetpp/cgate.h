@@ -133,7 +133,7 @@ class SIM_API cGate : public cObject, noncopyable
     cGate *prevGate;    // previous and next gate in the path
     cGate *nextGate;
 
-    static int lastConnectionId;
+    static OPP_THREAD_LOCAL int lastConnectionId;
 
   protected:
     // internal: constructor is protected because only cModule is allowed to create instances
@@ -417,10 +417,10 @@ class SIM_API cLogProxy
     static nullstream dummyStream; // EV evaluates to this when in express mode (getEnvir()->disabled())
 
   private:
-    static LogBuffer buffer;  // underlying buffer that contains the text that has been written so far
-    static std::ostream stream;  // this singleton is used to avoid allocating a new stream each time a log statement executes
-    static cLogEntry currentEntry; // context of the current (last) log statement that has been executed.
-    static LogLevel previousLogLevel; // log level of the previous log statement
+    static OPP_THREAD_LOCAL LogBuffer buffer;  // underlying buffer that contains the text that has been written so far
+    static OPP_THREAD_LOCAL std::ostream stream;  // this singleton is used to avoid allocating a new stream each time a log statement executes
+    static OPP_THREAD_LOCAL cLogEntry currentEntry; // context of the current (last) log statement that has been executed.
+    static OPP_THREAD_LOCAL LogLevel previousLogLevel; // log level of the previous log statement
     static const char *previousCategory; // category of the previous log statement
 
   private:
@@ -0,0 +1,183 @@
+//==========================================================================
+//  CMEMORYPOOL.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CMEMORYPOOL_H
+#define __OMNETPP_CMEMORYPOOL_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "simkerneldefs.h"
+#include "cexception.h"
+
+namespace omnetpp {
+
+/**
+ * @brief Free list based allocator for objects of a single class.
+ *
+ * Classes that are allocated and deallocated at a high rate (cMessage,
+ * cPacket, and message classes generated with the <tt>@pooled</tt> property)
+ * redefine their <tt>operator new</tt> and <tt>operator delete</tt> to
+ * allocate memory via a cMemoryPool. Deallocated blocks are kept on a free
+ * list, and reused by subsequent allocations of the same size, bypassing
+ * the general-purpose allocator. Since only memory is recycled, constructors
+ * and destructors run as usual, so dup(), ownership tracking and object
+ * counting are not affected.
+ *
+ * A pool serves blocks of a single size. Allocation requests of a different
+ * size (e.g. those of a subclass that is not pooled itself) are passed to
+ * the global <tt>operator new</tt>. If the block size is not specified in the
+ * constructor, it is determined by the first allocation request.
+ *
+ * Pooling is off by default, and can be turned on for all pools with
+ * setPoolingEnabled() (in simulations: with the <tt>object-pooling</tt>
+ * configuration option). While pooling is off, allocate() and release()
+ * do not touch the pool at all, and no statistics are collected, so pooled
+ * classes may then be allocated from several threads concurrently. Pools
+ * are not thread-safe when pooling is on.
+ *
+ * @ingroup SimSupport
+ */
+class SIM_API cMemoryPool
+{
+  private:
+    struct FreeBlock {FreeBlock *next;};
+
+    std::string name;
+    size_t blockSize;     // 0 if not yet known
+    FreeBlock *freeList;  // recycled blocks
+    size_t numFree;       // length of the free list
+    bool alive;           // useful when the pool is a global variable
+
+    // statistics
+    uint64_t numAllocs;   // number of allocations served by this pool
+    uint64_t numReused;   // number of allocations satisfied from the free list
+    size_t numLive;       // blocks of blockSize allocated and not yet released
+    size_t peakLive;      // maximum of numLive since the last resetStatistics()
+
+    static bool poolingEnabled;
+    static std::vector<cMemoryPool*>& getPools();
+
+  public:
+    /**
+     * Constructor. The name is used in the statistics, and is usually the
+     * name of the class the pool allocates memory for. A zero blockSize
+     * means that it is determined by the first allocation request.
+     */
+    explicit cMemoryPool(const char *name, size_t blockSize=0);
+
+    /**
+     * Destructor. Frees the blocks on the free list.
+     */
+    ~cMemoryPool();
+
+    /**
+     * Allocates a block of the given size. Blocks of the pool's block size
+     * are taken from the free list if possible.
+     */
+    void *allocate(size_t size) {
+        if (!poolingEnabled)
+            return ::operator new(size);
+        if (size == blockSize && freeList) {
+            FreeBlock *block = freeList;
+            freeList = block->next;
+            numFree--;
+            numReused++;
+            countAllocation();
+            return block;
+        }
+        return allocateSlow(size);
+    }
+
+    /**
+     * Releases a block returned by allocate(). The size must be the same
+     * as the one passed to allocate().
+     */
+    void release(void *p, size_t size) {
+        if (poolingEnabled && size == blockSize && p && alive) {
+            ASSERT(numLive > 0);  // see setPoolingEnabled()
+            numLive--;
+            FreeBlock *block = static_cast<FreeBlock *>(p);
+            block->next = freeList;
+            freeList = block;
+            numFree++;
+            return;
+        }
+        ::operator delete(p);
+    }
+
+    /**
+     * Returns the memory held on the free list to the global allocator.
+     */
+    void purge();
+
+    /** @name Statistics. */
+    //@{
+    const char *getName() const {return name.c_str();}
+    size_t getBlockSize() const {return blockSize;}
+    size_t getNumFree() const {return numFree;}
+    uint64_t getNumAllocations() const {return numAllocs;}
+    uint64_t getNumReused() const {return numReused;}
+    size_t getNumLive() const {return numLive;}
+    size_t getPeakLive() const {return peakLive;}
+    //@}
+
+    /** @name Global settings and statistics of all pools. */
+    //@{
+    /**
+     * Turns pooling on or off for all pools. When it is off, allocations and
+     * deallocations go directly to the global <tt>operator new</tt> and
+     * <tt>operator delete</tt>, without any bookkeeping. Pooling may be
+     * turned off at any time, but it should only be turned on while no
+     * objects allocated with pooling off exist (e.g. at the start of a
+     * simulation run), because the pools have not counted them. The setting
+     * must not be changed while other threads allocate from the pools.
+     */
+    static void setPoolingEnabled(bool enabled) {poolingEnabled = enabled;}
+
+    /**
+     * Returns true if pooling is turned on.
+     */
+    static bool isPoolingEnabled() {return poolingEnabled;}
+
+    /**
+     * Resets the allocation counters of all pools, e.g. at the start of a
+     * simulation run. The number of live blocks is not affected.
+     */
+    static void resetStatistics();
+
+    /**
+     * Calls purge() on all pools.
+     */
+    static void purgeAll();
+
+    /**
+     * Prints the statistics of all pools that have served allocations
+     * since the last resetStatistics() call, one line per pool.
+     */
+    static void printStatistics(std::ostream& out);
+    //@}
+
+  private:
+    void countAllocation() {numAllocs++; if (++numLive > peakLive) peakLive = numLive;}
+    void *allocateSlow(size_t size);
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
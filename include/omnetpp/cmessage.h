@@ -115,11 +115,11 @@ class SIM_API cMessage : public cEvent
 
     long messageId;            // a unique message identifier assigned upon message creation
     long messageTreeId;        // a message identifier that is inherited by dup, if non dupped it is msgid
-    static long nextMessageId; // the next unique message identifier to be assigned upon message creation
+    static OPP_THREAD_LOCAL long nextMessageId; // the next unique message identifier to be assigned upon message creation
 
     // global variables for statistics
-    static long totalMsgCount;
-    static long liveMsgCount;
+    static OPP_THREAD_LOCAL long totalMsgCount;
+    static OPP_THREAD_LOCAL long liveMsgCount;
 
   private:
     // internal: create parlist
@@ -188,6 +188,27 @@ class SIM_API cMessage : public cEvent
      * are copied.
      */
     cMessage& operator=(const cMessage& msg);
+
+    /**
+     * Allocation function. When pooling is enabled (see cMemoryPool),
+     * cMessage objects are allocated from a free list of recycled blocks.
+     */
+    static void *operator new(size_t size);
+
+    /**
+     * Deallocation function, the counterpart of operator new().
+     */
+    static void operator delete(void *p, size_t size);
+
+    /**
+     * Placement new, made visible again.
+     */
+    static void *operator new(size_t, void *place) {return place;}
+
+    /**
+     * Placement delete, made visible again.
+     */
+    static void operator delete(void *, void *) {}
     //@}
 
     /**
@@ -260,8 +260,8 @@ class SIM_API cModule : public cComponent //implies noncopyable
     };
 
   private:
-    static std::string lastModuleFullPath; // cached result of last getFullPath() call
-    static const cModule *lastModuleFullPathModule; // module of lastModuleFullPath
+    static OPP_THREAD_LOCAL std::string lastModuleFullPath; // cached result of last getFullPath() call
+    static OPP_THREAD_LOCAL const cModule *lastModuleFullPathModule; // module of lastModuleFullPath
 
   private:
     enum {
@@ -283,9 +283,11 @@ class SIM_API cModule : public cComponent //implies noncopyable
     cModule *lastSubmodule;   // pointer to last submodule (needed for efficient append operation)
     cChannel *firstChannel;  // pointer to first channel in this compound module (list is needed for ChannelIterator)
     cChannel *lastChannel;   // pointer to last channel (needed for efficient append operation)
+    struct SubmoduleIndex;
+    mutable SubmoduleIndex *submoduleIndex; // name/index lookup table for submodules; built on demand (may be nullptr)
 
     typedef std::set<cGate::Name> NamePool;
-    static NamePool namePool;
+    static OPP_THREAD_LOCAL NamePool namePool;
     int gateDescArraySize;    // size of the descv array
     cGate::Desc *gateDescArray; // array with one element per gate or gate vector
 
@@ -337,6 +339,14 @@ class SIM_API cModule : public cComponent //implies noncopyable
     // internal: removes a submodule
     void removeSubmodule(cModule *mod);
 
+    // internal: maintain submoduleIndex when a submodule is inserted, removed or renamed
+    void addToSubmoduleIndex(cModule *mod);
+    void removeFromSubmoduleIndex(cModule *mod);
+    bool isInSubmoduleList(const cModule *parent) const {return parent->firstSubmodule == this || prevSibling != nullptr;}
+
+    // internal: common part of findSubmodule() and getSubmodule()
+    cModule *lookupSubmodule(const char *name, int index) const;
+
     // internal: inserts a channel. Called from cGate::connectTo()
     void insertChannel(cChannel *channel);
 
@@ -600,6 +610,8 @@ class SIM_API cModule : public cComponent //implies noncopyable
      * Finds a direct submodule with the given name and index, and returns
      * its module ID. If the submodule was not found, returns -1. Index
      * must be specified exactly if the module is member of a module vector.
+     * Lookup uses a hash table of submodule names (built on the first call),
+     * so its cost does not depend on the number of submodules.
      */
     virtual int findSubmodule(const char *name, int index=-1) const;
 
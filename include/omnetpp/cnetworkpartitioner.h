@@ -0,0 +1,205 @@
+//==========================================================================
+//  CNETWORKPARTITIONER.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CNETWORKPARTITIONER_H
+#define __OMNETPP_CNETWORKPARTITIONER_H
+
+#include <string>
+#include <vector>
+#include "cobject.h"
+
+namespace omnetpp {
+
+class cModule;
+class cEventProfiler;
+
+/**
+ * @brief Computes a balanced assignment of modules to parallel simulation
+ * partitions, and writes it out as <tt>partition-id</tt> settings.
+ *
+ * The partitioner works on a weighted graph. Vertices are the units of
+ * assignment (with extractFromNetwork(), the submodules of the network),
+ * and vertex weights express the processing load of the unit; edge weights
+ * express the amount of traffic between two units. partition() assigns the
+ * vertices to the given number of partitions so that the total vertex weight
+ * of each partition stays within the allowed imbalance of the average, and
+ * the total weight of the edges between different partitions (the cut) is
+ * small.
+ *
+ * The algorithm is a multilevel one: the graph is repeatedly coarsened by
+ * merging vertices along heavy edges, the coarsest graph is partitioned by
+ * growing regions around seed vertices, and the partitioning is projected back
+ * to the finer graphs, improving it on each level by moving boundary vertices
+ * to the partitions they are most strongly connected to.
+ *
+ * In simulations, the partitioner is used via the <tt>event-profiling-partitions</tt>
+ * configuration option: at the end of a sequential run with event profiling,
+ * the network is partitioned using the event counts and message counts
+ * measured by cEventProfiler, and the result is written into an ini file
+ * that can be included into the configuration of the parallel runs.
+ *
+ * @ingroup SimSupport
+ */
+class SIM_API cNetworkPartitioner : public cObject, noncopyable
+{
+  public:
+    struct Edge {
+        int vertex;     // the other end of the edge
+        int64_t weight;
+    };
+
+  protected:
+    // a graph on one level of the multilevel algorithm
+    struct Graph {
+        std::vector<int64_t> vertexWeights;
+        std::vector<std::vector<Edge>> edges;  // adjacency lists; every edge appears at both ends
+        std::vector<int> coarseVertex;  // the vertex of the next coarser graph this vertex was merged into
+        int getNumVertices() const {return vertexWeights.size();}
+    };
+
+    Graph graph;  // the input graph
+    std::vector<cModule *> modules;  // module of each vertex, or nullptr
+    std::vector<int> partitionOf;    // result: partition index of each vertex
+    std::vector<int64_t> partitionWeights;
+    int64_t cutWeight = 0;
+    double maxImbalance = 0.05;
+    unsigned int seed = 1;
+
+  protected:
+    virtual bool coarsen(Graph& fine, Graph& coarse, int64_t maxVertexWeight);
+    virtual void initialPartition(const Graph& g, int numPartitions, int64_t maxPartitionWeight, std::vector<int>& parts);
+    virtual void refine(const Graph& g, int numPartitions, int64_t maxPartitionWeight, std::vector<int>& parts);
+    static void addEdge(Graph& g, int u, int v, int64_t weight);
+    static std::vector<int64_t> computePartitionWeights(const Graph& g, int numPartitions, const std::vector<int>& parts);
+
+  public:
+    /**
+     * Constructor.
+     */
+    cNetworkPartitioner() {}
+
+    /** @name Building the graph. */
+    //@{
+    /**
+     * Adds a vertex with the given weight, and returns its index. The
+     * module pointer is optional; it is used by writeIniFile().
+     */
+    int addVertex(int64_t weight, cModule *module=nullptr);
+
+    /**
+     * Adds weight to the edge between the two vertices, creating the edge
+     * if it does not exist yet. Edges are undirected. Self-loops are ignored.
+     */
+    void addEdge(int u, int v, int64_t weight) {addEdge(graph, u, v, weight);}
+
+    /**
+     * Builds the graph from the network. Vertices are the submodules of
+     * the given (network) module; their weight is the number of events
+     * processed by them and their submodules according to the profiler
+     * (plus one, so that idle modules are also distributed among the
+     * partitions). Edges correspond to connections between submodules
+     * (with weight one per connection), plus the messages the profiler
+     * counted between modules inside them. The profiler may be nullptr.
+     */
+    void extractFromNetwork(cModule *network, const cEventProfiler *profiler);
+
+    /**
+     * Deletes the graph and the results.
+     */
+    void clear();
+
+    /**
+     * Returns the number of vertices.
+     */
+    int getNumVertices() const {return graph.getNumVertices();}
+
+    /**
+     * Returns the weight of the given vertex.
+     */
+    int64_t getVertexWeight(int vertex) const {return graph.vertexWeights.at(vertex);}
+
+    /**
+     * Returns the edges of the given vertex.
+     */
+    const std::vector<Edge>& getEdges(int vertex) const {return graph.edges.at(vertex);}
+
+    /**
+     * Returns the module of the given vertex, or nullptr.
+     */
+    cModule *getModule(int vertex) const {return modules.at(vertex);}
+    //@}
+
+    /** @name Partitioning. */
+    //@{
+    /**
+     * Sets the allowed imbalance: the total vertex weight of a partition
+     * may exceed the average by this fraction (unless a single vertex is
+     * heavier than that). The default is 0.05.
+     */
+    void setMaxImbalance(double d) {maxImbalance = d;}
+
+    /**
+     * Returns the allowed imbalance.
+     */
+    double getMaxImbalance() const {return maxImbalance;}
+
+    /**
+     * Sets the seed of the random numbers used to break ties. The result
+     * is deterministic for the same graph and seed.
+     */
+    void setSeed(unsigned int seed) {this->seed = seed;}
+
+    /**
+     * Partitions the graph into the given number of partitions.
+     */
+    void partition(int numPartitions);
+
+    /**
+     * Returns the partition of the given vertex after partition().
+     */
+    int getPartitionOf(int vertex) const {return partitionOf.at(vertex);}
+
+    /**
+     * Returns the total vertex weight of the given partition.
+     */
+    int64_t getPartitionWeight(int partition) const {return partitionWeights.at(partition);}
+
+    /**
+     * Returns the total weight of the edges between different partitions.
+     */
+    int64_t getCutWeight() const {return cutWeight;}
+    //@}
+
+    /** @name Output. */
+    //@{
+    /**
+     * Returns <tt>partition-id</tt> settings for the modules of the vertices,
+     * as ini file lines. Consecutive elements of a module vector that are
+     * in the same partition are assigned with a single index range.
+     */
+    std::string getIniLines() const;
+
+    /**
+     * Writes the <tt>partition-id</tt> settings (see getIniLines()) into the
+     * given file, preceded by comments with the partition weights.
+     */
+    void writeIniFile(const char *fileName) const;
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
@@ -115,11 +115,11 @@ class SIM_API cOwnedObject : public cNamedObject
   private:
     // list in which objects are accumulated if there is no simple module in context
     // (see also setDefaultOwner() and cSimulation::setContextModule())
-    static cDefaultOwner *defaultOwner;
+    static OPP_THREAD_LOCAL cDefaultOwner *defaultOwner;
 
     // global variables for statistics
-    static long totalObjectCount;
-    static long liveObjectCount;
+    static OPP_THREAD_LOCAL long totalObjectCount;
+    static OPP_THREAD_LOCAL long liveObjectCount;
 
   private:
     void copy(const cOwnedObject& obj);
@@ -125,6 +125,27 @@ class SIM_API cPacket : public cMessage
      * The name member is not copied; see cNamedObject's operator=() for more details.
      */
     cPacket& operator=(const cPacket& packet);
+
+    /**
+     * Allocation function. When pooling is enabled (see cMemoryPool),
+     * cPacket objects are allocated from a free list of recycled blocks.
+     */
+    static void *operator new(size_t size);
+
+    /**
+     * Deallocation function, the counterpart of operator new().
+     */
+    static void operator delete(void *p, size_t size);
+
+    /**
+     * Placement new, made visible again.
+     */
+    static void *operator new(size_t, void *place) {return place;}
+
+    /**
+     * Placement delete, made visible again.
+     */
+    static void operator delete(void *, void *) {}
     //@}
 
     /** @name Redefined cObject/cMessage member functions. */
@@ -61,8 +61,8 @@ class SIM_API cParImpl : public cNamedObject
     const char *baseDirectory; // stringpooled
 
     // global variables for statistics
-    static long totalParimplObjs;
-    static long liveParimplObjs;
+    static OPP_THREAD_LOCAL long totalParimplObjs;
+    static OPP_THREAD_LOCAL long liveParimplObjs;
 
   protected:
     static cStringPool stringPool;
@@ -22,6 +22,7 @@
 namespace omnetpp {
 
 class cCommBuffer;
+class cParsimProfiler;
 
 #define PARSIM_ANY_TAG  -1
 
@@ -38,6 +39,9 @@ class cCommBuffer;
  */
 class SIM_API cParsimCommunications : public cObject
 {
+  protected:
+    cParsimProfiler *profiler = nullptr;  // if set, sent and received buffers are reported to it
+
   public:
     /**
      * Virtual destructor.
@@ -110,6 +114,21 @@ class SIM_API cParsimCommunications : public cObject
      */
     virtual bool receiveNonblocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId) = 0;
     //@}
+
+    /** @name Profiling */
+    //@{
+    /**
+     * Sets the profiler which the sent and received buffers should be
+     * reported to (see the parsim-profiling configuration option).
+     * The profiler is not owned by this object.
+     */
+    void setProfiler(cParsimProfiler *profiler)  {this->profiler = profiler;}
+
+    /**
+     * Returns the profiler set with setProfiler(), or nullptr.
+     */
+    cParsimProfiler *getProfiler() const  {return profiler;}
+    //@}
 };
 
 }  // namespace omnetpp
@@ -22,6 +22,7 @@ namespace omnetpp {
 
 class cQueue;
 class cCoroutine;
+class cTimeoutTimer;
 
 /**
  * @brief Base class for all simple module classes.
@@ -74,8 +75,8 @@ class SIM_API cSimpleModule : public cModule //implies noncopyable
     cMessage *timeoutMessage;   // msg used in wait() and receive() with timeout
     cCoroutine *coroutine;
 
-    static bool stackCleanupRequested; // 'true' value asks activity() to throw a cStackCleanupException
-    static cSimpleModule *afterCleanupTransferTo; // transfer back to this module (or to main)
+    static OPP_THREAD_LOCAL bool stackCleanupRequested; // 'true' value asks activity() to throw a cStackCleanupException
+    static OPP_THREAD_LOCAL cSimpleModule *afterCleanupTransferTo; // transfer back to this module (or to main)
 
   private:
     // internal use
@@ -301,6 +302,30 @@ class SIM_API cSimpleModule : public cModule //implies noncopyable
      * the duration parameter must be zero.
      */
     virtual void sendDirect(cMessage *msg, simtime_t propagationDelay, simtime_t duration, cGate *inputGate);
+
+    /**
+     * Promises that the module will not send messages via the given output
+     * gate with a sending time (the current simulation time plus the delay
+     * of sendDelayed()) earlier than t. For example, a MAC layer may call
+     * it with the end of the current backoff period or transmission.
+     *
+     * The promise only matters in parallel simulation, and only if the
+     * connection path of the gate leads to another partition; otherwise
+     * the call does nothing. There, synchronizers that support it (the
+     * null message protocol with cLinkDelayLookahead) use the promise to
+     * tell the other partition that it will not receive messages via the
+     * link before t plus the link delay, which allows that partition to
+     * proceed further without waiting. Sending before the promised time is
+     * an error, and an unexpired promise cannot be withdrawn by making
+     * a promise with an earlier time.
+     */
+    virtual void promiseEarliestSendTime(simtime_t t, cGate *outputGate);
+
+    /**
+     * Promises that the module will not send messages via the given output
+     * gate before t. See promiseEarliestSendTime(simtime_t, cGate *) for details.
+     */
+    virtual void promiseEarliestSendTime(simtime_t t, const char *gateName, int gateIndex=-1);
     //@}
 
     /** @name Self-messages. */
@@ -349,6 +374,41 @@ class SIM_API cSimpleModule : public cModule //implies noncopyable
      * of self-messages that the module has allocated.
      */
     virtual void cancelAndDelete(cMessage *msg);
+
+    /**
+     * Reschedules a self-message to simulation time t. If the message is
+     * currently scheduled, the effect is the same as that of calling
+     * cancelEvent() and then scheduleAt(), but it is more efficient: the
+     * future events set may move the message to its new position in place,
+     * instead of removing and re-inserting it. This makes it the preferred
+     * way of restarting timers (e.g. timeouts) that are frequently rearmed
+     * before they expire. If the message is not currently scheduled, this
+     * method is equivalent to scheduleAt().
+     */
+    virtual void rescheduleAt(simtime_t t, cMessage *msg);
+
+    /**
+     * Reschedules a self-message to the current simulation time plus the
+     * given delay. Equivalent to <tt>rescheduleAt(simTime()+delay, msg)</tt>.
+     */
+    virtual void rescheduleAfter(simtime_t delay, cMessage *msg);
+
+    /**
+     * Reschedules a timeout timer to simulation time t. If the timer is
+     * scheduled and t is not earlier than its current arrival time, this
+     * method only records t as the timer's new deadline, in O(1) time and
+     * without updating the future events set; the timer is re-inserted into
+     * the FES at the deadline when its original arrival time is reached.
+     * Otherwise, this method is equivalent to rescheduleAt(). See
+     * cTimeoutTimer for the implications on event ordering.
+     */
+    virtual void rescheduleTimeoutAt(simtime_t t, cTimeoutTimer *timer);
+
+    /**
+     * Reschedules a timeout timer to the current simulation time plus the
+     * given delay. Equivalent to <tt>rescheduleTimeoutAt(simTime()+delay, timer)</tt>.
+     */
+    virtual void rescheduleTimeoutAfter(simtime_t delay, cTimeoutTimer *timer);
     //@}
 
     /** @name Receiving messages.
@@ -33,15 +33,17 @@ class cSimpleModule;
 class cSimulation;
 class cException;
 class cFutureEventSet;
+class cIFutureEventSetListener;
 class cScheduler;
 class cParsimPartition;
 class cNedFileLoader;
 class cFingerprintCalculator;
+class cEventProfiler;
 class cModuleType;
 class cEnvir;
 class cDefaultOwner;
 
-SIM_API extern cDefaultOwner defaultList; // also in globals.h
+SIM_API extern OPP_THREAD_LOCAL cDefaultOwner defaultList; // also in globals.h
 
 
 /**
@@ -64,8 +66,8 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
     friend class cSimpleModule;
   private:
     // global variables
-    static cSimulation *activeSimulation;
-    static cEnvir *activeEnvir;
+    static OPP_THREAD_LOCAL cSimulation *activeSimulation;
+    static OPP_THREAD_LOCAL cEnvir *activeEnvir;
     static cEnvir *staticEnvir; // the environment to activate when activeSimulation becomes nullptr
 
     // variables of the module vector
@@ -97,6 +99,8 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
     bool trapOnNextEvent;  // when set, next handleMessage or activity() will execute debugger interrupt
 
     cFingerprintCalculator *fingerprint; // used for fingerprint calculation
+    cEventProfiler *eventProfiler; // used for event cost profiling, or nullptr
+    cIFutureEventSetListener *fesListener; // notified about changes to the FES, or nullptr
 
   private:
     // internal
@@ -277,6 +281,14 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
      */
     static void loadNedText(const char *name, const char *nedText, const char *expectedPackage=nullptr, bool isXML=false);
 
+    /**
+     * Enables caching the parsed form of NED files in the given file, so that
+     * subsequent simulation runs only need to parse NED files that have changed
+     * in the meantime. Pass nullptr or "" to turn caching off. This method
+     * should be called before the first loadNedSourceFolder()/loadNedFile() call.
+     */
+    static void setNedAstCacheFile(const char *fileName);
+
     /**
      * To be called after all NED folders / files have been loaded
      * (see loadNedSourceFolder()/loadNedFile()/loadNedText()).
@@ -319,6 +331,19 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
      */
     cFutureEventSet *getFES() const  {return fes;}
 
+    /**
+     * Installs an object to be notified about the changes the model makes
+     * to the future event set, or removes it if the argument is nullptr.
+     * The listener object is not owned by the cSimulation object.
+     */
+    void setFESListener(cIFutureEventSetListener *listener) {fesListener = listener;}
+
+    /**
+     * Returns the object notified about changes to the future event set,
+     * or nullptr if there is none.
+     */
+    cIFutureEventSetListener *getFESListener() const {return fesListener;}
+
     /**
      * Sets the simulation stop time be scheduling an appropriate
      * "end-simulation" event. May only be called once per run.
@@ -471,6 +496,13 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
      */
     void insertEvent(cEvent *event);
 
+    /**
+     * Moves the given event, which is already in the future events queue,
+     * to arrival time t while assigning the current event to its scheduling
+     * event. Used internally by cSimpleModule::rescheduleAt().
+     */
+    void rescheduleEvent(cEvent *event, simtime_t t);
+
     /**
      * Sets the component (module or channel) in context. Used internally.
      */
@@ -566,6 +598,18 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
      * Installs a new fingerprint object, used for fingerprint calculation.
      */
     void setFingerprintCalculator(cFingerprintCalculator *fingerprint);
+
+    /**
+     * Returns the object used for profiling event costs. It returns nullptr
+     * if event profiling is not enabled during this simulation run.
+     */
+    cEventProfiler *getEventProfiler() {return eventProfiler;}
+
+    /**
+     * Installs a new event profiler, or removes the current one if the
+     * argument is nullptr. The previous profiler object is deleted.
+     */
+    void setEventProfiler(cEventProfiler *profiler);
     //@}
 };
 
@@ -0,0 +1,81 @@
+//==========================================================================
+//   CSTATESAVING.H  -  header for
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CSTATESAVING_H
+#define __OMNETPP_CSTATESAVING_H
+
+#include "simkerneldefs.h"
+
+namespace omnetpp {
+
+class cCommBuffer;
+
+/**
+ * @brief Interface for simple modules that can save and restore their state.
+ *
+ * Optimistic parallel simulation (cTimeWarpProtocol) saves the state of a
+ * module before delivering a message to it, and restores it if the event
+ * has to be rolled back. Modules may implement this interface (as an
+ * additional base class besides cSimpleModule) to specify what their state
+ * consists of. Modules that do not implement it are saved and restored via
+ * their class descriptor: the fields declared in the module class itself
+ * (and not in cSimpleModule or its base classes) are considered to be the
+ * state of the module.
+ *
+ * The state must not include pointers to messages, except to self-messages
+ * that are allocated in initialize() and kept for the whole simulation.
+ *
+ * <pre>
+ * class Queue : public cSimpleModule, public cIStateSaving
+ * {
+ *     long numServed = 0;
+ *     simtime_t busyUntil;
+ *     ...
+ *     virtual void saveState(cCommBuffer *buffer) const override {
+ *         buffer->pack(numServed);
+ *         buffer->pack(busyUntil);
+ *     }
+ *     virtual void restoreState(cCommBuffer *buffer) override {
+ *         buffer->unpack(numServed);
+ *         buffer->unpack(busyUntil);
+ *     }
+ * };
+ * </pre>
+ *
+ * @ingroup ParsimBrief
+ * @ingroup Parsim
+ */
+class SIM_API cIStateSaving
+{
+  public:
+    virtual ~cIStateSaving() {}
+
+    /**
+     * Packs the state of the module into the buffer.
+     */
+    virtual void saveState(cCommBuffer *buffer) const = 0;
+
+    /**
+     * Restores the state of the module from the buffer. The buffer contains
+     * data packed by an earlier saveState() call.
+     */
+    virtual void restoreState(cCommBuffer *buffer) = 0;
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
@@ -20,6 +20,9 @@
 #include <string>
 #include <map>
 #include "simkerneldefs.h"
+#ifdef WITH_THREADED_PARSIM
+#include <mutex>
+#endif
 
 namespace omnetpp {
 
@@ -30,6 +33,9 @@ namespace omnetpp {
  * (largely) constant strings that occur in many instances during runtime:
  * module names, gate names, property names, keys and values, etc.
  *
+ * When \opp is built with WITH_THREADED_PARSIM, the methods of this class
+ * are thread-safe.
+ *
  * @see cNamedObject::cNamedObject, cNamedObject::setNamePooling()
  * @ingroup internals
  */
@@ -47,6 +53,9 @@ class cStringPool
     typedef std::map<char *,int,strless> StringIntMap;
     StringIntMap pool; // map<string,refcount>
     bool alive; // useful when stringpool is a global variable
+#ifdef WITH_THREADED_PARSIM
+    mutable std::mutex mutex; // pooled strings may be shared by objects of different threads
+#endif
 
   public:
     /**
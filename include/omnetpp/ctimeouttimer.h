@@ -0,0 +1,133 @@
+//==========================================================================
+//  CTIMEOUTTIMER.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CTIMEOUTTIMER_H
+#define __OMNETPP_CTIMEOUTTIMER_H
+
+#include "cmessage.h"
+
+namespace omnetpp {
+
+/**
+ * @brief A self-message for modeling timeouts that are pushed later much more
+ * often than they actually expire, such as retransmission, keepalive or
+ * inactivity timers.
+ *
+ * A cTimeoutTimer is scheduled and cancelled like any other self-message,
+ * but it can also be rescheduled with cSimpleModule::rescheduleTimeoutAt()
+ * and rescheduleTimeoutAfter(). When the new expiry time is not earlier
+ * than the one the timer is currently scheduled for, these methods only
+ * record the new expiry time (the deadline) in the timer, in O(1) time,
+ * and leave the future events set (FES) untouched. When the timer's event
+ * is taken from the FES and the timer has a deadline later than the
+ * current simulation time, the simulation kernel silently re-inserts it
+ * into the FES at the deadline instead of delivering it. Thus, however many
+ * times a timeout is extended, the FES only needs to be updated about once
+ * per original expiry interval.
+ *
+ * Event ordering remains deterministic, but it differs from that of
+ * cancelEvent()+scheduleAt() in one respect: when several events with equal
+ * arrival time and priority are scheduled for the deadline, the timer is
+ * ordered according to the time it was re-inserted into the FES, not
+ * according to the time rescheduleTimeoutAt() was called.
+ *
+ * getArrivalTime() returns the time the timer is currently in the FES for;
+ * use getDeadline() to find out when it is going to expire.
+ *
+ * @ingroup SimCore
+ */
+class SIM_API cTimeoutTimer : public cMessage
+{
+  private:
+    simtime_t deadline;                // expiry time, valid if the FL_ISDEFERRED flag is set
+    eventnumber_t deadlineInsertOrder; // insertion order of the FES event the deadline belongs to
+
+  private:
+    void copy(const cTimeoutTimer& timer);
+
+  public:
+    // internal: called by cSimpleModule::rescheduleTimeoutAt() while the timer
+    // is in the FES, to set a deadline that is not earlier than the arrival time
+    void setDeadline(simtime_t t);
+
+    // internal: called by cSimulation when the timer's event has been taken
+    // from the FES. If the timer has a valid deadline later than its arrival
+    // time, it sets the arrival time to the deadline and returns true;
+    // the caller then needs to re-insert the timer into the FES.
+    bool deferToDeadline();
+
+  public:
+    /** @name Constructors, destructor, assignment */
+    //@{
+    /**
+     * Copy constructor. The deadline is not copied, as the new object is
+     * not scheduled.
+     */
+    cTimeoutTimer(const cTimeoutTimer& timer);
+
+    /**
+     * Constructor. It takes the timer name and message kind; both optional.
+     */
+    explicit cTimeoutTimer(const char *name=nullptr, short kind=0);
+
+    /**
+     * Destructor.
+     */
+    virtual ~cTimeoutTimer();
+
+    /**
+     * Assignment operator. The name member is not copied;
+     * see cNamedObject's operator=() for more details.
+     */
+    cTimeoutTimer& operator=(const cTimeoutTimer& timer);
+    //@}
+
+    /** @name Redefined cObject member functions. */
+    //@{
+    /**
+     * Creates and returns an exact copy of this object.
+     * See cObject for more details.
+     */
+    virtual cTimeoutTimer *dup() const override  {return new cTimeoutTimer(*this);}
+
+    /**
+     * Produces a one-line description of the object's contents.
+     * See cObject for more details.
+     */
+    virtual std::string str() const override;
+    //@}
+
+    /** @name Timer state. */
+    //@{
+    /**
+     * Returns true if the timer is scheduled, and its expiry has been
+     * extended beyond its arrival time in the FES.
+     */
+    bool hasDeadline() const;
+
+    /**
+     * Returns the time the timer will expire at if it is scheduled, and -1
+     * otherwise. This is the deadline set by the last rescheduleTimeoutAt()
+     * call if there is one, and the arrival time otherwise.
+     */
+    simtime_t getDeadline() const;
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
@@ -222,6 +222,56 @@ class SIM_API TimeAverageRecorder : public cNumericResultRecorder
         virtual std::string str() const override;
 };
 
+/**
+ * @brief Listener that computes the results of several basic recorders at once.
+ *
+ * Supported recording modes are count, sum, mean, min, max, avg, last,
+ * timeavg and vector; the recording mode passed to init() is a comma-separated
+ * list of these (e.g. "count,sum,vector"). cStatisticBuilder uses this class
+ * instead of a run of such recorders on the same statistic, so that each
+ * value is processed with a single listener call instead of one call per
+ * recorder. The recorded results (names, values, attributes, order) are the
+ * same as those of the individual recorders.
+ */
+class SIM_API FusedRecorder : public cNumericResultRecorder
+{
+    public:
+        enum Mode {COUNT, SUM, MEAN, MIN, MAX, AVG, LAST, TIMEAVG, VECTOR};
+    protected:
+        std::vector<std::pair<Mode,const char *>> modes;  // in recording order
+        const char *currentMode = nullptr;  // overrides getRecordingMode() while recording a result
+        bool timeWeighted = false;  // for mean
+        bool needsTimeWeighted = false;  // whether timeavg or time-weighted mean is recorded
+        bool hasVector = false;
+        long count = 0;
+        double sum = 0;
+        double min = INFINITY;
+        double max = -INFINITY;
+        double last = NAN;
+        double lastValue = NAN;  // for time-weighted results; may be NaN
+        simtime_t lastTime = SIMTIME_ZERO;
+        double weightedSum = 0;
+        simtime_t totalTime = SIMTIME_ZERO;
+        void *handle = nullptr;  // output vector
+    protected:
+        virtual void init(cComponent *component, const char *statsName, const char *recordingMode, cProperty *attrsProperty, opp_string_map *manualAttrs) override;
+        virtual void subscribedTo(cResultFilter *prev) override;
+        virtual void collect(simtime_t_cref t, double value, cObject *details) override;
+        virtual void finish(cResultFilter *prev) override;
+        double getResult(Mode mode) const;
+    public:
+        FusedRecorder() {}
+        virtual ~FusedRecorder();
+        virtual const char *getRecordingMode() const override {return currentMode ? currentMode : cNumericResultRecorder::getRecordingMode();}
+        double getTimeAverage() const;
+        virtual std::string str() const override;
+
+        /**
+         * Returns true if the given recording mode can be part of a FusedRecorder.
+         */
+        static bool supportsMode(const char *mode);
+};
+
 /**
  * @brief Listener for recording signal values via a cStatistic.
  * NaN values in the input are ignored, or in the time-weighted
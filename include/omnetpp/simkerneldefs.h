@@ -68,6 +68,19 @@
 #define ASSERT2(expr,text)  ((void)0)
 #endif
 
+/**
+ * @brief Storage class of the per-simulation global state of the simulation
+ * kernel (active simulation, message and object counters, context, etc.)
+ * When \opp is built with WITH_THREADED_PARSIM, it expands to thread_local,
+ * so that partitions of a parallel simulation can run as threads of the same
+ * process; otherwise it expands to nothing.
+ */
+#ifdef WITH_THREADED_PARSIM
+#define OPP_THREAD_LOCAL  thread_local
+#else
+#define OPP_THREAD_LOCAL
+#endif
+
 
 /**
  * @brief Sequence number of events during the simulation. Events are numbered from one.
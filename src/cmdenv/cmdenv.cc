@@ -35,6 +35,7 @@
 #include "omnetpp/csimplemodule.h"
 #include "omnetpp/ccomponenttype.h"
 #include "omnetpp/cmessage.h"
+#include "omnetpp/cmemorypool.h"
 #include "omnetpp/cconfigoption.h"
 #include "omnetpp/checkandcast.h"
 #include "omnetpp/cproperties.h"
@@ -316,6 +317,13 @@ void Cmdenv::doRun()
                 }
             }
 
+            // report allocation statistics of message pools
+            if (networkSetupDone && opt->objectPooling) {
+                out << "\nObject pool statistics:" << endl;
+                cMemoryPool::printStatistics(out);
+                out.flush();
+            }
+
             // stop redirecting into file
             stopOutputRedirection();
 
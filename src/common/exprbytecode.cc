@@ -0,0 +1,743 @@
+//==========================================================================
+//  EXPRBYTECODE.CC - part of
+//                     OMNeT++/OMNEST
+//             Discrete System Simulation in C++
+//
+//  Author: Andras Varga
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cmath>
+#include <memory>
+#include <new>
+#include <typeinfo>
+#include "exprbytecode.h"
+#include "exprnodes.h"
+#include "unitconversion.h"
+
+namespace omnetpp {
+namespace common {
+namespace expression {
+
+static const int LOCAL_STACK_SIZE = 8;  // larger stacks are allocated on the heap
+
+namespace {
+
+/**
+ * Context for evaluating the fallback copies of compiled nodes: carries the
+ * operand values computed by the program.
+ */
+struct FallbackContext : public Context
+{
+    const ExprValue *operands;
+    FallbackContext(Context *context, const ExprValue *operands) : operands(operands) {simContext = context ? context->simContext : nullptr;}
+};
+
+/**
+ * Stands for an operand in the fallback copies of compiled nodes.
+ */
+class OperandNode : public LeafNode
+{
+  protected:
+    int index;
+  protected:
+    virtual ExprValue evaluate(Context *context) const override {return static_cast<FallbackContext*>(context)->operands[index];}
+    virtual void print(std::ostream& out, int spaciousness) const override {out << getName();}
+  public:
+    OperandNode(int index) : index(index) {}
+    virtual ExprNode *dup() const override {return new OperandNode(index);}
+    virtual std::string getName() const override {return "$" + std::to_string(index);}
+};
+
+}  // namespace
+
+static const char *opcodeNames[] = {
+    "PUSH_CONST", "CALL", "JUMP", "GENERIC", "NEG", "NOT", "BITNOT",
+    "ADD", "SUB", "MUL", "DIV", "MOD", "POW",
+    "EQ", "NE", "LT", "GT", "LE", "GE", "CMP3",
+    "BITAND", "BITOR", "BITXOR", "SHL", "SHR",
+    "INTCAST", "DOUBLECAST", "UNITCONV", "MATH1", "MATH2", "MATH3",
+    "AND_LEFT", "OR_LEFT", "XOR_LEFT", "LOGICAL_RIGHT", "XOR_RIGHT", "IIF_COND"
+};
+
+// the evaluation stack is uninitialized memory, values are constructed/destroyed as they are pushed/popped
+inline void pop(ExprValue *& sp)
+{
+    (--sp)->~ExprValue();
+}
+
+inline bool isNumeric(const ExprValue& value)
+{
+    return value.getType() == ExprValue::INT || value.getType() == ExprValue::DOUBLE;
+}
+
+inline bool isLinearUnit(const char *unit)
+{
+    return unit == nullptr || UnitConversion::isLinearUnit(unit);
+}
+
+inline double ExprBytecode::toDouble(const ExprValue& value)
+{
+    // like ExprValue::convertToDouble()
+    return value.type == ExprValue::DOUBLE ? value.dbl : safeCastToDouble(value.intv);
+}
+
+ExprBytecode::~ExprBytecode()
+{
+    for (ExprNode *node : fallbacks)
+        delete node;
+}
+
+ExprBytecode *ExprBytecode::compile(const ExprNode *tree)
+{
+    std::unique_ptr<ExprBytecode> program(new ExprBytecode());
+    program->compileNode(tree);
+    if (program->code.size() == 1)
+        return nullptr;  // constant or single subtree: evaluating the tree is just as fast
+    return program.release();
+}
+
+int ExprBytecode::getOpcodeFor(const ExprNode *node)
+{
+    // note: exact type match, because subclasses may override evaluate()
+    const std::type_info& type = typeid(*node);
+    if (type == typeid(NegateNode)) return NEG;
+    if (type == typeid(NotNode)) return NOT;
+    if (type == typeid(BitwiseNotNode)) return BITNOT;
+    if (type == typeid(AddNode)) return ADD;
+    if (type == typeid(SubNode)) return SUB;
+    if (type == typeid(MulNode)) return MUL;
+    if (type == typeid(DivNode)) return DIV;
+    if (type == typeid(ModNode)) return MOD;
+    if (type == typeid(PowNode)) return POW;
+    if (type == typeid(EqualNode)) return EQ;
+    if (type == typeid(NotEqualNode)) return NE;
+    if (type == typeid(LessThanNode)) return LT;
+    if (type == typeid(GreaterThanNode)) return GT;
+    if (type == typeid(LessOrEqualNode)) return LE;
+    if (type == typeid(GreaterOrEqualNode)) return GE;
+    if (type == typeid(ThreeWayComparisonNode)) return CMP3;
+    if (type == typeid(BitwiseAndNode)) return BITAND;
+    if (type == typeid(BitwiseOrNode)) return BITOR;
+    if (type == typeid(BitwiseXorNode)) return BITXOR;
+    if (type == typeid(LShiftNode)) return SHL;
+    if (type == typeid(RShiftNode)) return SHR;
+    if (type == typeid(IntCastNode)) return INTCAST;
+    if (type == typeid(DoubleCastNode)) return DOUBLECAST;
+    if (type == typeid(UnitConversionNode)) return UNITCONV;
+    if (type == typeid(MathFunc1Node)) return MATH1;
+    if (type == typeid(MathFunc2Node)) return MATH2;
+    if (type == typeid(MathFunc3Node)) return MATH3;
+    if (type == typeid(MatchNode)) return GENERIC;
+    if (type == typeid(MatchConstPatternNode)) return GENERIC;
+    return -1;
+}
+
+bool ExprBytecode::isFoldable(const ExprNode *node)
+{
+    // math functions other than the standard ones may have side effects (e.g. draw random numbers)
+    const std::type_info& type = typeid(*node);
+    if (type == typeid(MathFunc1Node) || type == typeid(MathFunc2Node) || type == typeid(MathFunc3Node))
+        return ExprNodeFactory::supportsStdMathFunction(node->getName().c_str());
+    return true;
+}
+
+int ExprBytecode::getNumOperands(const Instruction& instr)
+{
+    switch (instr.opcode) {
+        case PUSH_CONST: case CALL: case JUMP:
+            return 0;
+        case GENERIC:
+            return instr.arg;
+        case NEG: case NOT: case BITNOT: case INTCAST: case DOUBLECAST: case UNITCONV: case MATH1:
+        case AND_LEFT: case OR_LEFT: case XOR_LEFT: case IIF_COND:
+            return 1;
+        case MATH3:
+            return 3;
+        default:
+            return 2;
+    }
+}
+
+int ExprBytecode::emit(const Instruction& instr, int stackEffect)
+{
+    code.push_back(instr);
+    stackDepth += stackEffect;
+    if (stackDepth > maxStackDepth)
+        maxStackDepth = stackDepth;
+    return code.size() - 1;
+}
+
+void ExprBytecode::emitConstant(const ExprValue& value)
+{
+    Instruction instr(PUSH_CONST);
+    instr.arg = constants.size();
+    constants.push_back(value);
+    emit(instr, 1);
+}
+
+int ExprBytecode::addFallback(const ExprNode *node)
+{
+    ExprNode *copy = node->dup();
+    std::vector<ExprNode*> operands;
+    for (int i = 0; i < (int)node->getChildren().size(); i++)
+        operands.push_back(new OperandNode(i));
+    copy->setChildren(operands);
+    fallbacks.push_back(copy);
+    return fallbacks.size() - 1;
+}
+
+bool ExprBytecode::tryFold(int start, int numConstants, int numFallbacks, int fallback, const std::vector<ExprValue>& operands)
+{
+    // evaluate the node with the constant operands; if it fails, leave the error to evaluation time
+    ExprValue value;
+    try {
+        FallbackContext context(nullptr, operands.data());
+        value = fallbacks[fallback]->tryEvaluate(&context);
+    }
+    catch (std::exception& e) {
+        return false;
+    }
+
+    // the unit may point into the node (see UnitConversionNode) which is about to be deleted
+    if (value.getUnit() != nullptr)
+        value.setUnit(ExprValue::getPooled(value.getUnit()));
+
+    // replace the code of the subtree with the result
+    code.erase(code.begin() + start, code.end());
+    constants.resize(numConstants);
+    for (int i = numFallbacks; i < (int)fallbacks.size(); i++)
+        delete fallbacks[i];
+    fallbacks.resize(numFallbacks);
+    stackDepth -= operands.size();
+    emitConstant(value);
+    return true;
+}
+
+void ExprBytecode::compileNode(const ExprNode *node)
+{
+    const std::type_info& type = typeid(*node);
+    int opcode = getOpcodeFor(node);
+    if (type == typeid(ConstantNode))
+        emitConstant(node->tryEvaluate(nullptr));
+    else if (type == typeid(AndNode))
+        compileLogicalOperator(node, AND_LEFT);
+    else if (type == typeid(OrNode))
+        compileLogicalOperator(node, OR_LEFT);
+    else if (type == typeid(XorNode))
+        compileLogicalOperator(node, XOR_LEFT);
+    else if (type == typeid(InlineIfNode))
+        compileInlineIf(node);
+    else if (opcode == -1) {
+        // leave it to the tree interpreter
+        Instruction instr(CALL);
+        instr.arg = subtrees.size();
+        subtrees.push_back(node);
+        emit(instr, 1);
+    }
+    else {
+        int start = code.size();
+        int numConstants = constants.size();
+        int numFallbacks = fallbacks.size();
+
+        // code for the operands, in the same order as the tree evaluates them
+        std::vector<ExprNode*> children = node->getChildren();
+        std::vector<ExprValue> constantOperands;
+        bool allConstant = true;
+        for (ExprNode *child : children) {
+            int childStart = code.size();
+            compileNode(child);
+            if (allConstant && isConstant(childStart, code.size()))
+                constantOperands.push_back(constants[code[childStart].arg]);
+            else
+                allConstant = false;
+        }
+
+        Instruction instr((Opcode)opcode);
+        instr.fallback = addFallback(node);
+        if (allConstant && isFoldable(node) && tryFold(start, numConstants, numFallbacks, instr.fallback, constantOperands))
+            return;
+
+        switch (instr.opcode) {
+            case GENERIC: instr.arg = children.size(); break;
+            case UNITCONV: instr.unit = ExprValue::getPooled(node->getName().c_str()); break;
+            case MATH1: instr.f1 = static_cast<const MathFunc1Node*>(node)->getFunction(); break;
+            case MATH2: instr.f2 = static_cast<const MathFunc2Node*>(node)->getFunction(); break;
+            case MATH3: instr.f3 = static_cast<const MathFunc3Node*>(node)->getFunction(); break;
+            default: break;
+        }
+        emit(instr, 1 - (int)children.size());
+    }
+}
+
+void ExprBytecode::compileLogicalOperator(const ExprNode *node, Opcode leftOpcode)
+{
+    int start = code.size();
+    int numConstants = constants.size();
+    int numFallbacks = fallbacks.size();
+    std::vector<ExprNode*> children = node->getChildren();
+
+    compileNode(children[0]);
+    bool isLeftConstant = isConstant(start, code.size());
+    ExprValue left = isLeftConstant ? constants[code[start].arg] : ExprValue();
+    if (isLeftConstant) {
+        // the right operand is not evaluated if the left one decides the result
+        bool shortcut = left.getType() == ExprValue::UNDEF ||
+                (left.getType() == ExprValue::BOOL && leftOpcode == AND_LEFT && !left.boolValue()) ||
+                (left.getType() == ExprValue::BOOL && leftOpcode == OR_LEFT && left.boolValue());
+        if (shortcut)
+            return;
+    }
+
+    Instruction leftInstr(leftOpcode);
+    leftInstr.fallback = addFallback(node);
+    int leftIndex = emit(leftInstr, 0);
+
+    int rightStart = code.size();
+    compileNode(children[1]);
+    if (isLeftConstant && isConstant(rightStart, code.size())) {
+        std::vector<ExprValue> operands {left, constants[code[rightStart].arg]};
+        if (tryFold(start, numConstants, numFallbacks, leftInstr.fallback, operands))
+            return;
+    }
+
+    Instruction rightInstr(leftOpcode == XOR_LEFT ? XOR_RIGHT : LOGICAL_RIGHT);
+    rightInstr.fallback = leftInstr.fallback;
+    emit(rightInstr, -1);
+    code[leftIndex].arg = code.size();
+}
+
+void ExprBytecode::compileInlineIf(const ExprNode *node)
+{
+    int start = code.size();
+    int numConstants = constants.size();
+    std::vector<ExprNode*> children = node->getChildren();
+
+    compileNode(children[0]);
+    if (isConstant(start, code.size())) {
+        // only one branch is needed (or none if the condition is undefined)
+        const ExprValue& cond = constants[code[start].arg];
+        if (cond.getType() == ExprValue::UNDEF)
+            return;
+        if (cond.getType() == ExprValue::BOOL) {
+            bool value = cond.boolValue();
+            code.erase(code.begin() + start, code.end());
+            constants.resize(numConstants);
+            stackDepth--;
+            compileNode(children[value ? 1 : 2]);
+            return;
+        }
+    }
+
+    Instruction condInstr(IIF_COND);
+    condInstr.fallback = addFallback(node);
+    int condIndex = emit(condInstr, -1);
+    compileNode(children[1]);
+    int jumpIndex = emit(Instruction(JUMP), 0);
+    code[condIndex].arg = code.size();
+    stackDepth--;  // the two branches start at the same stack depth
+    compileNode(children[2]);
+    code[jumpIndex].arg = code.size();
+    code[condIndex].arg2 = code.size();
+}
+
+ExprValue *ExprBytecode::callFallback(const Instruction& instr, ExprValue *sp, Context *context) const
+{
+    // note: for AND_LEFT, OR_LEFT, XOR_LEFT and IIF_COND, this is only called if the operand
+    // is of the wrong type, i.e. the fallback throws an error
+    int numOperands = getNumOperands(instr);
+    FallbackContext fallbackContext(context, sp - numOperands);
+    ExprValue result = fallbacks[instr.fallback]->tryEvaluate(&fallbackContext);
+    sp[-numOperands] = std::move(result);
+    for (int i = 1; i < numOperands; i++)
+        pop(sp);
+    return sp;
+}
+
+ExprValue ExprBytecode::evaluate(Context *context) const
+{
+    alignas(ExprValue) char localStack[LOCAL_STACK_SIZE * sizeof(ExprValue)];
+    std::unique_ptr<char[]> heapStack(maxStackDepth > LOCAL_STACK_SIZE ? new char[maxStackDepth * sizeof(ExprValue)] : nullptr);
+    ExprValue *stack = reinterpret_cast<ExprValue*>(heapStack ? heapStack.get() : localStack);
+    ExprValue *sp = stack;
+
+    // Inline paths below must not modify the operands before they are known to
+    // succeed: if they throw (e.g. on integer overflow), the instruction is
+    // repeated with the fallback, to get the same error as from the tree.
+    const Instruction *begin = code.data();
+    const Instruction *end = begin + code.size();
+    try {
+        for (const Instruction *ip = begin; ip != end; ) {
+            const Instruction& instr = *ip++;
+            try {
+                switch (instr.opcode) {
+                    case PUSH_CONST:
+                        new (sp) ExprValue(constants[instr.arg]);
+                        sp++;
+                        break;
+
+                    case CALL:
+                        new (sp) ExprValue(subtrees[instr.arg]->tryEvaluate(context));
+                        sp++;
+                        break;
+
+                    case JUMP:
+                        ip = begin + instr.arg;
+                        break;
+
+                    case GENERIC:
+                        sp = callFallback(instr, sp, context);
+                        break;
+
+                    case NEG: {
+                        ExprValue& a = sp[-1];
+                        if (a.type == ExprValue::DOUBLE && isLinearUnit(a.unit))
+                            a.dbl = -a.dbl;
+                        else if (a.type == ExprValue::INT && isLinearUnit(a.unit))
+                            a.intv = -a.intv;
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case NOT: {
+                        ExprValue& a = sp[-1];
+                        if (a.type == ExprValue::BOOL)
+                            a.bl = !a.bl;
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case BITNOT: {
+                        ExprValue& a = sp[-1];
+                        if (a.type == ExprValue::INT && a.unit == nullptr)
+                            a.intv = ~a.intv;
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case ADD: case SUB: {
+                        ExprValue& a = sp[-2];
+                        const ExprValue& b = sp[-1];
+                        if (a.type == ExprValue::INT && b.type == ExprValue::INT && a.unit == b.unit && isLinearUnit(a.unit)) {
+                            a.intv = instr.opcode == ADD ? safeAdd(a.intv, b.intv) : safeSub(a.intv, b.intv);
+                            pop(sp);
+                        }
+                        else if (isNumeric(a) && isNumeric(b) && (a.type == ExprValue::DOUBLE || b.type == ExprValue::DOUBLE) && isLinearUnit(a.unit) && isLinearUnit(b.unit)) {
+                            double x = toDouble(a), y = toDouble(b);
+                            if (a.unit != b.unit)
+                                y = UnitConversion::convertUnit(y, b.unit, a.unit);
+                            a.type = ExprValue::DOUBLE;
+                            a.dbl = instr.opcode == ADD ? x + y : x - y;
+                            pop(sp);
+                        }
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case MUL: {
+                        ExprValue& a = sp[-2];
+                        const ExprValue& b = sp[-1];
+                        if (isNumeric(a) && isNumeric(b) && (a.unit == nullptr || b.unit == nullptr) && isLinearUnit(a.unit) && isLinearUnit(b.unit)) {
+                            const char *unit = opp_isempty(a.unit) ? b.unit : a.unit;
+                            if (a.type == ExprValue::INT && b.type == ExprValue::INT)
+                                a.intv = safeMul(a.intv, b.intv);
+                            else {
+                                double x = toDouble(a), y = toDouble(b);
+                                a.type = ExprValue::DOUBLE;
+                                a.dbl = x * y;
+                            }
+                            a.unit = unit;
+                            pop(sp);
+                        }
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case DIV: {
+                        // note: division is always performed in double
+                        ExprValue& a = sp[-2];
+                        const ExprValue& b = sp[-1];
+                        if (isNumeric(a) && isNumeric(b) && (b.unit == nullptr || b.unit == a.unit) && isLinearUnit(a.unit)) {
+                            double x = toDouble(a), y = toDouble(b);
+                            a.type = ExprValue::DOUBLE;
+                            a.dbl = x / y;
+                            if (b.unit != nullptr)
+                                a.unit = nullptr;  // e.g. 2s/1s
+                            pop(sp);
+                        }
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case MOD: {
+                        ExprValue& a = sp[-2];
+                        const ExprValue& b = sp[-1];
+                        if (a.type == ExprValue::INT && b.type == ExprValue::INT && a.unit == nullptr && b.unit == nullptr) {
+                            a.intv = a.intv % b.intv;
+                            pop(sp);
+                        }
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case POW: {
+                        ExprValue& a = sp[-2];
+                        const ExprValue& b = sp[-1];
+                        if (!isNumeric(a) || !isNumeric(b) || a.unit != nullptr || b.unit != nullptr)
+                            sp = callFallback(instr, sp, context);
+                        else if (a.type == ExprValue::INT && b.type == ExprValue::INT) {
+                            if (b.intv >= 0) {
+                                a.intv = intPow(a.intv, b.intv);
+                                pop(sp);
+                            }
+                            else
+                                sp = callFallback(instr, sp, context);
+                        }
+                        else {
+                            double x = toDouble(a), y = toDouble(b);
+                            a.type = ExprValue::DOUBLE;
+                            a.dbl = pow(x, y);
+                            pop(sp);
+                        }
+                        break;
+                    }
+
+                    case EQ: case NE: case LT: case GT: case LE: case GE: case CMP3: {
+                        // compute the difference like CompareNode does
+                        ExprValue& a = sp[-2];
+                        const ExprValue& b = sp[-1];
+                        double diff;
+                        if (a.type == ExprValue::INT && b.type == ExprValue::INT && a.unit == b.unit)
+                            diff = a.intv - b.intv;
+                        else if (isNumeric(a) && isNumeric(b) && (a.type == ExprValue::DOUBLE || b.type == ExprValue::DOUBLE)) {
+                            double x = toDouble(a), y = toDouble(b);
+                            if (a.unit != b.unit)
+                                y = UnitConversion::convertUnit(y, b.unit, a.unit);
+                            diff = x == y ? 0 : x - y;
+                        }
+                        else if (a.type == ExprValue::BOOL && b.type == ExprValue::BOOL)
+                            diff = (int)a.bl - (int)b.bl;
+                        else {
+                            sp = callFallback(instr, sp, context);
+                            break;
+                        }
+                        switch (instr.opcode) {
+                            case EQ: a = diff == 0; break;
+                            case NE: a = diff != 0; break;
+                            case LT: a = diff < 0; break;
+                            case GT: a = diff > 0; break;
+                            case LE: a = diff <= 0; break;
+                            case GE: a = diff >= 0; break;
+                            default: a = std::isnan(diff) ? diff : double((0<diff) - (diff<0)); break;
+                        }
+                        a.unit = nullptr;
+                        pop(sp);
+                        break;
+                    }
+
+                    case BITAND: case BITOR: case BITXOR: case SHL: case SHR: {
+                        ExprValue& a = sp[-2];
+                        const ExprValue& b = sp[-1];
+                        if (a.type == ExprValue::INT && b.type == ExprValue::INT && a.unit == nullptr && b.unit == nullptr) {
+                            switch (instr.opcode) {
+                                case BITAND: a.intv = a.intv & b.intv; break;
+                                case BITOR: a.intv = a.intv | b.intv; break;
+                                case BITXOR: a.intv = a.intv ^ b.intv; break;
+                                case SHL: a.intv = shift(a.intv, b.intv); break;
+                                default: a.intv = shift(a.intv, -b.intv); break;
+                            }
+                            pop(sp);
+                        }
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case INTCAST: {
+                        ExprValue& a = sp[-1];
+                        if (a.type == ExprValue::INT)
+                            ;
+                        else if (a.type == ExprValue::DOUBLE) {
+                            intval_t value = checked_int_cast<intval_t>(floor(a.dbl));
+                            a.type = ExprValue::INT;
+                            a.intv = value;
+                        }
+                        else if (a.type == ExprValue::BOOL)
+                            a = (intval_t)(a.bl ? 1 : 0);
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case DOUBLECAST: {
+                        ExprValue& a = sp[-1];
+                        if (a.type == ExprValue::DOUBLE)
+                            ;
+                        else if (a.type == ExprValue::INT) {
+                            a.type = ExprValue::DOUBLE;
+                            a.dbl = (double)a.intv;
+                        }
+                        else if (a.type == ExprValue::BOOL)
+                            a = a.bl ? 1.0 : 0.0;
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case UNITCONV: {
+                        ExprValue& a = sp[-1];
+                        if (isNumeric(a) && a.unit == nullptr)
+                            a.unit = instr.unit;
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case MATH1: {
+                        ExprValue& a = sp[-1];
+                        if (isNumeric(a) && a.unit == nullptr)
+                            a = instr.f1(toDouble(a));
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case MATH2: {
+                        ExprValue& a = sp[-2];
+                        const ExprValue& b = sp[-1];
+                        if (isNumeric(a) && isNumeric(b) && a.unit == nullptr && b.unit == nullptr) {
+                            double x = toDouble(a), y = toDouble(b);
+                            a = instr.f2(x, y);
+                            pop(sp);
+                        }
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case MATH3: {
+                        ExprValue& a = sp[-3];
+                        const ExprValue& b = sp[-2];
+                        const ExprValue& c = sp[-1];
+                        if (isNumeric(a) && isNumeric(b) && isNumeric(c) && a.unit == nullptr && b.unit == nullptr && c.unit == nullptr) {
+                            double x = toDouble(a), y = toDouble(b), z = toDouble(c);
+                            a = instr.f3(x, y, z);
+                            pop(sp);
+                            pop(sp);
+                        }
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case AND_LEFT: case OR_LEFT: {
+                        const ExprValue& a = sp[-1];
+                        if (a.type == ExprValue::BOOL) {
+                            if (a.bl == (instr.opcode == OR_LEFT))
+                                ip = begin + instr.arg;  // shortcut
+                        }
+                        else if (a.type == ExprValue::UNDEF)
+                            ip = begin + instr.arg;
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case XOR_LEFT: {
+                        const ExprValue& a = sp[-1];
+                        if (a.type == ExprValue::UNDEF)
+                            ip = begin + instr.arg;
+                        else if (a.type != ExprValue::BOOL)
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case LOGICAL_RIGHT: case XOR_RIGHT: {
+                        ExprValue& a = sp[-2];
+                        const ExprValue& b = sp[-1];
+                        if (b.type == ExprValue::BOOL) {
+                            a.bl = instr.opcode == XOR_RIGHT ? a.bl != b.bl : b.bl;
+                            pop(sp);
+                        }
+                        else if (b.type == ExprValue::UNDEF) {
+                            a = ExprValue();
+                            pop(sp);
+                        }
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+
+                    case IIF_COND: {
+                        const ExprValue& a = sp[-1];
+                        if (a.type == ExprValue::BOOL) {
+                            if (!a.bl)
+                                ip = begin + instr.arg;
+                            pop(sp);
+                        }
+                        else if (a.type == ExprValue::UNDEF)
+                            ip = begin + instr.arg2;
+                        else
+                            sp = callFallback(instr, sp, context);
+                        break;
+                    }
+                }
+            }
+            catch (ExprNode::eval_error& e) {
+                throw;
+            }
+            catch (std::exception& e) {
+                if (instr.fallback == -1)
+                    throw;
+                sp = callFallback(instr, sp, context);
+            }
+        }
+    }
+    catch (...) {
+        while (sp != stack)
+            pop(sp);
+        throw;
+    }
+    Assert(sp == stack + 1);
+    ExprValue result;
+    result = std::move(stack[0]);
+    pop(sp);
+    return result;
+}
+
+void ExprBytecode::dump(std::ostream& out) const
+{
+    for (int i = 0; i < (int)code.size(); i++) {
+        const Instruction& instr = code[i];
+        out << i << ": " << opcodeNames[instr.opcode];
+        switch (instr.opcode) {
+            case PUSH_CONST: out << " " << constants[instr.arg].str(); break;
+            case CALL: out << " " << subtrees[instr.arg]->str(); break;
+            case GENERIC: out << " " << fallbacks[instr.fallback]->getName(); break;
+            case UNITCONV: out << " " << instr.unit; break;
+            case MATH1: case MATH2: case MATH3: out << " " << fallbacks[instr.fallback]->getName(); break;
+            case JUMP: case AND_LEFT: case OR_LEFT: case XOR_LEFT: out << " ->" << instr.arg; break;
+            case IIF_COND: out << " ->" << instr.arg << " undef->" << instr.arg2; break;
+            default: break;
+        }
+        out << "\n";
+    }
+}
+
+}  // namespace expression
+}  // namespace common
+}  // namespace omnetpp
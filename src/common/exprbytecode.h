@@ -0,0 +1,144 @@
+//==========================================================================
+//  EXPRBYTECODE.H - part of
+//                     OMNeT++/OMNEST
+//             Discrete System Simulation in C++
+//
+//  Author: Andras Varga
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_EXPRBYTECODE_H
+#define __OMNETPP_COMMON_EXPRBYTECODE_H
+
+#include <iostream>
+#include <vector>
+#include "exprnode.h"
+
+namespace omnetpp {
+namespace common {
+namespace expression {
+
+/**
+ * Compiled form of an expression tree: code for a stack machine that computes
+ * the same value (or throws the same error) as evaluating the tree, but without
+ * the recursive virtual calls and the copying of ExprValues between nodes.
+ *
+ * Operators, casts, unit conversion functions and math functions are compiled
+ * into instructions that work in place on a stack of ExprValues. Instructions
+ * handle the common operand types inline (bool, and int and double without
+ * a measurement unit or with the same linear unit); in all other cases
+ * (strings, undefined values, unit conversions, errors) they delegate to
+ * a copy of the original node, so the semantics of the operators is not
+ * duplicated here. Nodes not known to the compiler (variables, functions,
+ * parameter references and other context-dependent nodes) are evaluated
+ * by the tree interpreter, via tryEvaluate().
+ *
+ * Operators with constant operands are evaluated at compile time, and so are
+ * ?: and the shortcuts of && and || when the condition is constant.
+ *
+ * The program refers to the nodes of the tree it was compiled from, so the
+ * tree must outlive the program. The program is not modified by evaluate(),
+ * i.e. it may be evaluated concurrently if the tree may be.
+ */
+class COMMON_API ExprBytecode
+{
+  public:
+    enum Opcode {
+        PUSH_CONST,  // push constants[arg]
+        CALL,        // push the value of subtrees[arg], evaluated by the tree interpreter
+        JUMP,        // jump to arg
+        GENERIC,     // operator without an inline implementation; arg is the number of operands
+        NEG, NOT, BITNOT,
+        ADD, SUB, MUL, DIV, MOD, POW,
+        EQ, NE, LT, GT, LE, GE, CMP3,
+        BITAND, BITOR, BITXOR, SHL, SHR,
+        INTCAST, DOUBLECAST, UNITCONV,
+        MATH1, MATH2, MATH3,
+        AND_LEFT,    // &&: jump to arg if the left operand is false or undefined, keep it otherwise
+        OR_LEFT,     // ||: jump to arg if the left operand is true or undefined, keep it otherwise
+        XOR_LEFT,    // ##: jump to arg if the left operand is undefined, keep it otherwise
+        LOGICAL_RIGHT, // &&, ||: replace the left operand with the right one
+        XOR_RIGHT,   // ##: compute the result from the two operands
+        IIF_COND     // ?:: pop the condition, and jump to arg if it is false; jump to arg2 if it is undefined
+    };
+
+  private:
+    struct Instruction {
+        Opcode opcode;
+        int arg = -1;
+        int arg2 = -1;
+        int fallback = -1; // index into fallbacks
+        union {
+            const char *unit; // UNITCONV
+            double (*f1)(double); // MATH1
+            double (*f2)(double,double); // MATH2
+            double (*f3)(double,double,double); // MATH3
+        };
+        Instruction(Opcode opcode) : opcode(opcode), unit(nullptr) {}
+    };
+
+    std::vector<Instruction> code;
+    std::vector<ExprValue> constants;
+    std::vector<const ExprNode*> subtrees; // not owned
+    std::vector<ExprNode*> fallbacks; // copies of the compiled nodes, with placeholders for children
+    int stackDepth = 0; // during compilation
+    int maxStackDepth = 0;
+
+  private:
+    ExprBytecode() {}
+    ExprBytecode(const ExprBytecode&) = delete;
+    ExprBytecode& operator=(const ExprBytecode&) = delete;
+    static int getOpcodeFor(const ExprNode *node);
+    static bool isFoldable(const ExprNode *node);
+    static int getNumOperands(const Instruction& instr);
+    static double toDouble(const ExprValue& value);
+    int emit(const Instruction& instr, int stackEffect);
+    void emitConstant(const ExprValue& value);
+    bool isConstant(int start, int end) const {return end == start+1 && code[start].opcode == PUSH_CONST;}
+    bool tryFold(int start, int numConstants, int numFallbacks, int fallback, const std::vector<ExprValue>& operands);
+    int addFallback(const ExprNode *node);
+    void compileNode(const ExprNode *node);
+    void compileLogicalOperator(const ExprNode *node, Opcode leftOpcode);
+    void compileInlineIf(const ExprNode *node);
+    ExprValue *callFallback(const Instruction& instr, ExprValue *sp, Context *context) const;
+
+  public:
+    ~ExprBytecode();
+
+    /**
+     * Compiles the given expression tree. Returns nullptr if the expression
+     * would not evaluate faster in compiled form, e.g. if it is a constant or
+     * the whole expression is a function call left to the tree interpreter.
+     */
+    static ExprBytecode *compile(const ExprNode *tree);
+
+    /**
+     * Evaluates the expression. Throws an exception if there is an error
+     * during evaluation.
+     */
+    ExprValue evaluate(Context *context) const;
+
+    /**
+     * Returns the number of instructions in the program.
+     */
+    int getNumInstructions() const {return code.size();}
+
+    /**
+     * Prints the program, for debugging purposes.
+     */
+    void dump(std::ostream& out=std::cout) const;
+};
+
+}  // namespace expression
+}  // namespace common
+}  // namespace omnetpp
+
+
+#endif
@@ -66,8 +66,12 @@ const char *Expression::AstNode::typeName(Type type)
 
 void Expression::copy(const Expression& other)
 {
+    delete bytecode;
+    bytecode = nullptr;
     delete tree;
     tree = other.tree->dupTree();
+    if (other.bytecode)
+        bytecode = ExprBytecode::compile(tree);
 }
 
 Expression& Expression::operator=(const Expression& other)
@@ -97,9 +101,13 @@ ExprNode *Expression::parseAndTranslate(const char *expr, AstTranslator *transla
 void Expression::setExpressionTree(ExprNode* exprTree)
 {
     Assert(exprTree);
+    delete bytecode;
+    bytecode = nullptr;
     if (tree)
         delete tree;
     tree = exprTree;
+    if (bytecodeEnabled)
+        bytecode = ExprBytecode::compile(tree);
 }
 
 void Expression::dumpAst(AstNode *node, std::ostream& out, int indentLevel) const
@@ -212,7 +220,7 @@ ExprValue Expression::evaluate(Context *context) const
 {
     if (!tree)
         throw opp_runtime_error("Cannot evaluate empty expression");
-    return tree->tryEvaluate(context);
+    return bytecode ? bytecode->evaluate(context) : tree->tryEvaluate(context);
 }
 
 bool Expression::boolValue(Context *context) const
@@ -421,6 +429,8 @@ static OperatorAstTranslator operatorAstTranslator;
 static StdMathAstTranslator stdMathAstTranslator;
 static UnitConversionAstTranslator unitConversionAstTranslator;
 
+bool Expression::bytecodeEnabled = false;
+
 Expression::MultiAstTranslator Expression::defaultTranslator({
     &operatorAstTranslator,
     &stdMathAstTranslator,
@@ -19,6 +19,7 @@
 #include "commondefs.h"
 #include "exprvalue.h"
 #include "exprnode.h"
+#include "exprbytecode.h"
 #include "stringpool.h"
 
 namespace omnetpp {
@@ -33,6 +34,7 @@ public:
     typedef omnetpp::common::expression::ExprValue ExprValue;
     typedef omnetpp::common::expression::ExprNode ExprNode;
     typedef omnetpp::common::expression::Context Context;
+    typedef omnetpp::common::expression::ExprBytecode ExprBytecode;
 
     /**
      * Node type for the expression AST, an intermediate representation which
@@ -117,7 +119,9 @@ public:
 
   protected:
     ExprNode *tree = nullptr;
+    ExprBytecode *bytecode = nullptr; // compiled form of tree, if enabled
     static MultiAstTranslator defaultTranslator;
+    static bool bytecodeEnabled;
 
   protected:
     void copy(const Expression& other);
@@ -134,12 +138,20 @@ public:
     static const std::vector<AstTranslator*>& getInstalledAstTranslators() {return defaultTranslator.getTranslators();}
     static MultiAstTranslator *getDefaultAstTranslator() {return &defaultTranslator;}
 
+    /**
+     * Enables or disables compiling expressions into bytecode (see ExprBytecode)
+     * for faster evaluation. The setting affects expressions parsed (or whose
+     * expression tree is set) afterwards. The default is disabled.
+     */
+    static void setBytecodeEnabled(bool enabled) {bytecodeEnabled = enabled;}
+    static bool isBytecodeEnabled() {return bytecodeEnabled;}
+
     /**
      * Constructor.
      */
     Expression() {}
     Expression(const Expression& other) {copy(other);}
-    virtual ~Expression() {delete tree;}
+    virtual ~Expression() {delete bytecode; delete tree;}
     Expression& operator=(const Expression& other);
 
     /**
@@ -206,7 +218,10 @@ public:
     // direct access to the expression evaluator tree
     virtual void setExpressionTree(ExprNode *exprTree);
     virtual const ExprNode *getExpressionTree() const {return tree;}
-    virtual ExprNode *removeExpressionTree() {ExprNode *result = tree; tree = nullptr; return result;}
+    virtual ExprNode *removeExpressionTree() {delete bytecode; bytecode = nullptr; ExprNode *result = tree; tree = nullptr; return result;}
+
+    // the compiled form of the expression tree, or nullptr if it was not compiled
+    virtual const ExprBytecode *getBytecode() const {return bytecode;}
 
     // various stages of the expression parsing and translation, as utility functions
     virtual AstNode *parseToAst(const char *text) const;
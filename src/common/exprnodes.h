@@ -445,6 +445,7 @@ public:
     MathFunc0Node(const char *name, double (*f)()) : name(name), f(f) {}
     virtual ExprNode *dup() const override {return new MathFunc0Node(name.c_str(), f);}
     virtual std::string getName() const override {return name;}
+    double (*getFunction() const)() {return f;}
     virtual Precedence getPrecedence() const override {return ELEM;}
 };
 
@@ -459,6 +460,7 @@ public:
     MathFunc1Node(const char *name, double (*f)(double)) : name(name), f(f) {}
     virtual ExprNode *dup() const override {return new MathFunc1Node(name.c_str(), f);}
     virtual std::string getName() const override {return name;}
+    double (*getFunction() const)(double) {return f;}
     virtual Precedence getPrecedence() const override {return ELEM;}
 };
 
@@ -473,6 +475,7 @@ public:
     MathFunc2Node(const char *name, double (*f)(double,double)) : name(name), f(f) {}
     virtual ExprNode *dup() const override {return new MathFunc2Node(name.c_str(), f);}
     virtual std::string getName() const override {return name;}
+    double (*getFunction() const)(double,double) {return f;}
     virtual Precedence getPrecedence() const override {return ELEM;}
 };
 
@@ -487,6 +490,7 @@ public:
     MathFunc3Node(const char *name, double (*f)(double,double,double)) : name(name), f(f) {}
     virtual ExprNode *dup() const override {return new MathFunc3Node(name.c_str(), f);}
     virtual std::string getName() const override {return name;}
+    double (*getFunction() const)(double,double,double) {return f;}
     virtual Precedence getPrecedence() const override {return ELEM;}
 };
 
@@ -501,6 +505,7 @@ public:
     MathFunc4Node(const char *name, double (*f)(double,double,double,double)) : name(name), f(f) {}
     virtual ExprNode *dup() const override {return new MathFunc4Node(name.c_str(), f);}
     virtual std::string getName() const override {return name;}
+    double (*getFunction() const)(double,double,double,double) {return f;}
     virtual Precedence getPrecedence() const override {return ELEM;}
 };
 
@@ -71,6 +71,7 @@ class COMMON_API ExprValue
     friend class MathFunc4Node;
     friend class FunctionNode;
     friend class MethodNode;
+    friend class ExprBytecode;
     friend class omnetpp::common::MatchExpression;
 
   public:
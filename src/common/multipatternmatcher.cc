@@ -0,0 +1,297 @@
+//==========================================================================
+//  MULTIPATTERNMATCHER.CC - part of
+//                     OMNeT++/OMNEST
+//             Discrete System Simulation in C++
+//
+//  Author: Andras Varga
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstring>
+#include <algorithm>
+#include "opp_ctype.h"
+#include "multipatternmatcher.h"
+
+namespace omnetpp {
+namespace common {
+
+// Same syntax as PatternMatcher::parseNumRange(): "{n..m}" or "[n..m]", with n and m optional.
+// On success, returns the position of the closing character.
+static const char *skipNumRange(const char *s, char closingChar)
+{
+    s++;  // skip "[" or "{"
+    while (opp_isdigit(*s))
+        s++;
+    if (*s != '.' || *(s+1) != '.')
+        return nullptr;
+    s += 2;
+    while (opp_isdigit(*s))
+        s++;
+    return *s == closingChar ? s : nullptr;
+}
+
+void MultiPatternMatcher::clear()
+{
+    nodes.clear();
+    nameIds.clear();
+    numPatterns = 0;
+    addNode();  // root
+}
+
+int MultiPatternMatcher::addNode()
+{
+    nodes.push_back(Node());
+    return nodes.size() - 1;
+}
+
+int MultiPatternMatcher::getNameId(const std::string& name) const
+{
+    auto it = nameIds.find(name);
+    return it == nameIds.end() ? -1 : it->second;
+}
+
+int MultiPatternMatcher::getOrCreateNameId(const std::string& name)
+{
+    auto it = nameIds.find(name);
+    if (it != nameIds.end())
+        return it->second;
+    int id = nameIds.size();
+    nameIds[name] = id;
+    return id;
+}
+
+bool MultiPatternMatcher::splitPattern(const char *pattern, std::vector<std::string>& segments, std::vector<bool>& isWildcard)
+{
+    // Split the pattern at dots, except for those within numeric ranges.
+    // Refuse patterns where elements of the pattern may match (or contain) a dot.
+    segments.clear();
+    isWildcard.clear();
+    std::string segment;
+    bool wildcard = false;
+    for (const char *s = pattern; ; s++) {
+        if (*s == '\0' || *s == '.') {
+            if (wildcard && segment != "*" && segment != "**" && segment.find("**") != std::string::npos)
+                return false;  // "**" mixed with other characters, e.g. "**foo" or "a**b"
+            segments.push_back(segment);
+            isWildcard.push_back(wildcard);
+            if (*s == '\0')
+                break;
+            segment.clear();
+            wildcard = false;
+        }
+        else if (*s == '\\') {
+            return false;
+        }
+        else if (*s == '{' || *s == '[') {
+            const char *end = skipNumRange(s, *s == '{' ? '}' : ']');
+            if (end) {
+                segment.append(s, end - s + 1);
+                wildcard = true;
+                s = end;
+            }
+            else if (*s == '{')
+                return false;  // character set; it might match a dot
+            else
+                segment += *s;
+        }
+        else {
+            if (*s == '*' || *s == '?')
+                wildcard = true;
+            segment += *s;
+        }
+    }
+    return true;
+}
+
+bool MultiPatternMatcher::isSupportedPattern(const char *pattern)
+{
+    std::vector<std::string> segments;
+    std::vector<bool> isWildcard;
+    return splitPattern(pattern, segments, isWildcard);
+}
+
+bool MultiPatternMatcher::addPattern(const char *pattern, int id)
+{
+    std::vector<std::string> segments;
+    std::vector<bool> isWildcard;
+    if (!splitPattern(pattern, segments, isWildcard))
+        return false;
+
+    // create the nodes, starting from the last segment (see computeFinalStates() for the reason);
+    // note: indices are used instead of references, as addNode() may reallocate
+    int current = 0;
+    for (int i = segments.size() - 1; i >= 0; i--) {
+        const std::string& segment = segments[i];
+        int next;
+        if (!isWildcard[i]) {
+            int nameId = getOrCreateNameId(segment);
+            auto& children = nodes[current].literalChildren;
+            auto it = std::lower_bound(children.begin(), children.end(), std::make_pair(nameId, -1));
+            if (it != children.end() && it->first == nameId)
+                next = it->second;
+            else {
+                next = nodes.size();
+                children.insert(it, std::make_pair(nameId, next));
+                addNode();  // note: invalidates "children"
+            }
+        }
+        else if (segment == "*") {
+            next = nodes[current].anySegmentChild;
+            if (next == -1) {
+                next = addNode();
+                nodes[current].anySegmentChild = next;
+            }
+        }
+        else if (segment == "**") {
+            next = nodes[current].anySequenceChild;
+            if (next == -1) {
+                next = addNode();
+                nodes[current].anySequenceChild = next;
+                nodes[next].selfLoop = true;
+            }
+        }
+        else {
+            // compute literal prefix
+            size_t prefixLength = std::min(segment.find_first_of("*?{"), segment.size());
+            for (size_t pos = segment.find('['); pos < prefixLength; pos = segment.find('[', pos+1))
+                if (skipNumRange(segment.c_str() + pos, ']'))
+                    prefixLength = pos + 1;  // "[" of "[n..m]" is matched literally, the number is not
+            std::string prefix = segment.substr(0, prefixLength);
+
+            // find or create child
+            size_t bracketPos = prefix.find('[');
+            int nameId = bracketPos == std::string::npos ? -1 : getOrCreateNameId(prefix.substr(0, bracketPos));
+            auto& children = nodes[current].patternChildren;
+            auto it = std::find_if(children.begin(), children.end(), [&](const PatternChild& child) {return child.source == segment;});
+            if (it != children.end())
+                next = it->node;
+            else {
+                PatternChild child;
+                child.source = segment;
+                child.prefix = prefix;
+                child.nameId = nameId;
+                child.matcher.setPattern(segment.c_str(), true, true, true);
+                child.node = next = nodes.size();
+                children.push_back(child);
+                addNode();  // note: invalidates "children"
+            }
+        }
+        current = next;
+    }
+    std::vector<int>& ids = nodes[current].acceptedIds;
+    ids.insert(std::upper_bound(ids.begin(), ids.end(), id), id);
+    numPatterns++;
+    return true;
+}
+
+void MultiPatternMatcher::computeFinalStates(const char *path, std::vector<int>& outStates) const
+{
+    // The path is processed from its last segment backwards: keys are typically
+    // of the form "**.host[*].app[0]", so the last segments are the selective ones,
+    // and "**" nodes only become active near the end.
+    std::vector<int>& states = outStates;
+    states.reserve(16);
+    states.assign(1, 0); // start from the root
+    std::vector<int> nextStates;
+    nextStates.reserve(16);
+    std::string segment;
+    const char *end = path + strlen(path);
+    while (true) {
+        const char *start = end;
+        while (start != path && *(start-1) != '.')
+            start--;
+        segment.assign(start, end - start);
+
+        // look up the segment and its name part (the part before "[") among the names in the patterns
+        int nameId = getNameId(segment);
+        size_t bracketPos = segment.find('[');
+        int stemId = bracketPos == std::string::npos ? nameId : getNameId(segment.substr(0, bracketPos));
+
+        // advance all states with the segment
+        nextStates.clear();
+        for (int state : states) {
+            const Node& node = nodes[state];
+            if (nameId != -1 && !node.literalChildren.empty()) {
+                auto it = std::lower_bound(node.literalChildren.begin(), node.literalChildren.end(), std::make_pair(nameId, -1));
+                if (it != node.literalChildren.end() && it->first == nameId)
+                    nextStates.push_back(it->second);
+            }
+            if (node.anySegmentChild != -1)
+                nextStates.push_back(node.anySegmentChild);
+            if (node.anySequenceChild != -1)
+                nextStates.push_back(node.anySequenceChild);
+            if (node.selfLoop)
+                nextStates.push_back(state);
+            for (const auto& child : node.patternChildren)
+                if ((child.nameId == -1 || child.nameId == stemId) && segment.compare(0, child.prefix.size(), child.prefix) == 0 && child.matcher.matches(segment.c_str()))
+                    nextStates.push_back(child.node);
+        }
+        if (nextStates.empty()) {
+            outStates.clear();
+            return;
+        }
+        if (nextStates.size() > 1) {
+            std::sort(nextStates.begin(), nextStates.end());
+            nextStates.erase(std::unique(nextStates.begin(), nextStates.end()), nextStates.end());
+        }
+        states.swap(nextStates);
+
+        if (start == path)
+            break;
+        end = start - 1;
+    }
+
+}
+
+void MultiPatternMatcher::matches(const char *path, std::vector<int>& outIds) const
+{
+    std::vector<int> states;
+    computeFinalStates(path, states);
+
+    // collect ids of patterns accepted in the final states
+    outIds.clear();
+    for (int state : states)
+        outIds.insert(outIds.end(), nodes[state].acceptedIds.begin(), nodes[state].acceptedIds.end());
+    if (outIds.size() > 1) {
+        std::sort(outIds.begin(), outIds.end());
+        outIds.erase(std::unique(outIds.begin(), outIds.end()), outIds.end());
+    }
+}
+
+int MultiPatternMatcher::findFirstMatch(const char *path, const std::function<bool(int)>& accept) const
+{
+    std::vector<int> states;
+    computeFinalStates(path, states);
+
+    // merge the (sorted) id lists of the final states, and stop at the first accepted id
+    std::vector<std::pair<const int *, const int *>> lists; // (current, end) pairs
+    lists.reserve(states.size());
+    for (int state : states)
+        if (!nodes[state].acceptedIds.empty())
+            lists.push_back(std::make_pair(nodes[state].acceptedIds.data(), nodes[state].acceptedIds.data() + nodes[state].acceptedIds.size()));
+    int lastId = -1;
+    while (!lists.empty()) {
+        int minIndex = 0;
+        for (int i = 1; i < (int)lists.size(); i++)
+            if (*lists[i].first < *lists[minIndex].first)
+                minIndex = i;
+        int id = *lists[minIndex].first++;
+        if (lists[minIndex].first == lists[minIndex].second)
+            lists.erase(lists.begin() + minIndex);
+        if (id != lastId && accept(id))
+            return id;
+        lastId = id;
+    }
+    return -1;
+}
+
+} // namespace common
+}  // namespace omnetpp
+
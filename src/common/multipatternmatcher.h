@@ -0,0 +1,143 @@
+//==========================================================================
+//  MULTIPATTERNMATCHER.H - part of
+//                     OMNeT++/OMNEST
+//             Discrete System Simulation in C++
+//
+//  Author: Andras Varga
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_MULTIPATTERNMATCHER_H
+#define __OMNETPP_COMMON_MULTIPATTERNMATCHER_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include "commondefs.h"
+#include "patternmatcher.h"
+
+namespace omnetpp {
+namespace common {
+
+/**
+ * Matches a dotted path (e.g. a module full path) against a set of
+ * PatternMatcher patterns in one pass, and reports which patterns match.
+ * Patterns are interpreted as with PatternMatcher in dottedpath, fullstring
+ * and case sensitive mode.
+ *
+ * The patterns are compiled into a trie over path segments: literal segments
+ * are looked up by name, "*" and "**" segments are special nodes, and other
+ * wildcarded segments (e.g. "host[*]" or "a{0..3}") are matched using a
+ * PatternMatcher; those starting with a name followed by "[" (the usual form
+ * for module vectors) are only tried if the path segment has the same name.
+ * The path is then run through the trie as a nondeterministic automaton, so
+ * patterns with a common part are only matched once. The trie is built and
+ * traversed from the last segment backwards, because in typical patterns like
+ * "**.host[*].app[0]" the last segments are the selective ones.
+ *
+ * Patterns that cannot be split into segments reliably (those that contain
+ * a backslash, a character set, or "**" together with other characters
+ * within a segment, like "**foo" or "net.**host") are refused by
+ * addPattern(); the caller is expected to match those separately.
+ *
+ * The matches() method is const and keeps no state in the object, so it may
+ * be called from multiple threads concurrently.
+ */
+class COMMON_API MultiPatternMatcher
+{
+  private:
+    struct PatternChild {
+        std::string source;   // the segment pattern, e.g. "host[*]"
+        std::string prefix;   // its literal prefix, e.g. "host["; used for quick rejection
+        int nameId;           // if prefix contains "[": id of the name before it, otherwise -1
+        PatternMatcher matcher;
+        int node;
+    };
+    struct Node {
+        std::vector<std::pair<int,int>> literalChildren; // (name id, node index), ordered by name id
+        std::vector<PatternChild> patternChildren; // wildcarded segments
+        int anySegmentChild = -1;  // "*"
+        int anySequenceChild = -1; // "**"
+        bool selfLoop = false;     // true for "**" nodes: they consume one or more segments
+        std::vector<int> acceptedIds; // ids of patterns that end at this node
+    };
+    std::vector<Node> nodes;  // nodes[0] is the root
+    std::unordered_map<std::string,int> nameIds; // literal segments and names in "name[...]" segments
+    int numPatterns = 0;
+
+  private:
+    static bool splitPattern(const char *pattern, std::vector<std::string>& segments, std::vector<bool>& isWildcard);
+    int getNameId(const std::string& name) const;
+    int getOrCreateNameId(const std::string& name);
+    void computeFinalStates(const char *path, std::vector<int>& outStates) const;
+    int addNode();
+
+  public:
+    /**
+     * Constructor.
+     */
+    MultiPatternMatcher() {clear();}
+
+    /**
+     * Removes all patterns.
+     */
+    void clear();
+
+    /**
+     * Returns true if the pattern can be added to this matcher, i.e. if
+     * addPattern() would accept it.
+     */
+    static bool isSupportedPattern(const char *pattern);
+
+    /**
+     * Adds a pattern with the given id. Several patterns may have the same id.
+     * Returns false (and does not add the pattern) if the pattern is not
+     * supported by this class; see isSupportedPattern().
+     */
+    bool addPattern(const char *pattern, int id);
+
+    /**
+     * Returns the number of patterns added.
+     */
+    int getNumPatterns() const {return numPatterns;}
+
+    /**
+     * Returns true if no patterns have been added.
+     */
+    bool isEmpty() const {return numPatterns == 0;}
+
+    /**
+     * Matches the path against all patterns, and stores the ids of the ones
+     * that match into outIds, in ascending order and without duplicates.
+     */
+    void matches(const char *path, std::vector<int>& outIds) const;
+
+    /**
+     * Convenience variant of matches(const char *, std::vector<int>&).
+     */
+    std::vector<int> matches(const char *path) const {std::vector<int> ids; matches(path, ids); return ids;}
+
+    /**
+     * Calls accept() with the ids of the patterns that match the path, in
+     * ascending order, until it returns true. Returns the id accepted, or -1
+     * if there was none. This is cheaper than matches() when only the first
+     * matching pattern (with some additional condition) is needed.
+     */
+    int findFirstMatch(const char *path, const std::function<bool(int)>& accept) const;
+};
+
+} // namespace common
+}  // namespace omnetpp
+
+
+#endif
+
+
@@ -33,6 +33,7 @@
 #include "common/commonutil.h"
 #include "common/ver.h"
 #include "common/fileutil.h"  // splitFileName
+#include "common/expression.h"
 #include "omnetpp/ccoroutine.h"
 #include "omnetpp/csimulation.h"
 #include "omnetpp/cscheduler.h"
@@ -44,11 +45,13 @@
 #include "omnetpp/ccanvas.h"
 #include "omnetpp/cmodule.h"
 #include "omnetpp/cmessage.h"
+#include "omnetpp/cmemorypool.h"
 #include "omnetpp/ccomponenttype.h"
 #include "omnetpp/cxmlelement.h"
 #include "omnetpp/cobjectfactory.h"
 #include "omnetpp/checkandcast.h"
 #include "omnetpp/cfingerprint.h"
+#include "omnetpp/ceventprofiler.h"
 #include "omnetpp/cconfigoption.h"
 #include "omnetpp/cnedmathfunction.h"
 #include "omnetpp/cnedfunction.h"
@@ -81,6 +84,11 @@
 #include "sim/parsim/cparsimpartition.h"
 #include "sim/parsim/cparsimsynchr.h"
 #include "sim/parsim/creceivedexception.h"
+#include "sim/parsim/cthreadcomm.h"
+#endif
+
+#ifdef WITH_THREADED_PARSIM
+#include <mutex>
 #endif
 
 #ifdef USE_PORTABLE_COROUTINES  /* coroutine stacks reside in main stack area */
@@ -139,15 +147,23 @@ Register_PerRunConfigOption(CFGID_EVENTLOGMANAGER_CLASS, "eventlogmanager-class"
 Register_PerRunConfigOption(CFGID_OUTPUTVECTORMANAGER_CLASS, "outputvectormanager-class", CFG_STRING, DEFAULT_OUTPUTVECTORMANAGER_CLASS, "Part of the Envir plugin mechanism: selects the output vector manager class to be used to record data from output vectors. The class has to implement the `cIOutputVectorManager` interface.");
 Register_PerRunConfigOption(CFGID_OUTPUTSCALARMANAGER_CLASS, "outputscalarmanager-class", CFG_STRING, DEFAULT_OUTPUTSCALARMANAGER_CLASS, "Part of the Envir plugin mechanism: selects the output scalar manager class to be used to record data passed to recordScalar(). The class has to implement the `cIOutputScalarManager` interface.");
 Register_PerRunConfigOption(CFGID_SNAPSHOTMANAGER_CLASS, "snapshotmanager-class", CFG_STRING, "omnetpp::envir::FileSnapshotManager", "Part of the Envir plugin mechanism: selects the class to handle streams to which snapshot() writes its output. The class has to implement the `cISnapshotManager` interface.");
-Register_PerRunConfigOption(CFGID_FUTUREEVENTSET_CLASS, "futureeventset-class", CFG_STRING, "omnetpp::cEventHeap", "Part of the Envir plugin mechanism: selects the class for storing the future events in the simulation. The class has to implement the `cFutureEventSet` interface.");
+Register_PerRunConfigOption(CFGID_FUTUREEVENTSET_CLASS, "futureeventset-class", CFG_STRING, "omnetpp::cEventHeap", "Part of the Envir plugin mechanism: selects the class for storing the future events in the simulation. The class has to implement the `cFutureEventSet` interface. Built-in implementations are `omnetpp::cEventHeap` (binary heap) and `omnetpp::cCalendarQueue` (calendar queue, may be faster for very large event sets).");
 Register_GlobalConfigOption(CFGID_IMAGE_PATH, "image-path", CFG_PATH, "./images", "A semicolon-separated list of directories that contain module icons and other resources. This list will be concatenated with the contents of the `OMNETPP_IMAGE_PATH` environment variable or with a compile-time, hardcoded image path if the environment variable is empty.");
 Register_GlobalConfigOption(CFGID_FNAME_APPEND_HOST, "fname-append-host", CFG_BOOL, nullptr, "Turning it on will cause the host name and process Id to be appended to the names of output files (e.g. omnetpp.vec, omnetpp.sca). This is especially useful with distributed simulation. The default value is true if parallel simulation is enabled, false otherwise.");
 Register_PerRunConfigOption(CFGID_DEBUG_ON_ERRORS, "debug-on-errors", CFG_BOOL, "false", "When set to true, runtime errors will cause the simulation program to break into the C++ debugger (if the simulation is running under one, or just-in-time debugging is activated). Once in the debugger, you can view the stack trace or examine variables.");
+Register_PerRunConfigOption(CFGID_OBJECT_POOLING, "object-pooling", CFG_BOOL, "false", "Enables recycling the memory of deleted message and packet objects (`cMessage`, `cPacket`, and message classes generated with the `@pooled` property) via per-class free lists, instead of returning it to the general-purpose allocator. Allocation statistics of the pools are printed at the end of the run.");
+Register_PerRunConfigOption(CFGID_EVENT_PROFILING, "event-profiling", CFG_BOOL, "false", "Enables measuring the wall-clock time spent in processing events, and counting events and future event set insertions, per module and per message class. The per-module results are recorded as scalars (`eventProfile:numEvents`, `eventProfile:numFesInserts`, `eventProfile:time`) at the end of the run. See also `event-profiling-file`.");
+Register_PerRunConfigOption(CFGID_EVENT_PROFILING_FILE, "event-profiling-file", CFG_FILENAME, nullptr, "When `event-profiling` is enabled, a JSON report with the per-module, per-NED-type and per-message-class results is written into this file at the end of the run. Example: `${resultdir}/${configname}-${iterationvarsf}#${repetition}.prof.json`. The default is no report file.");
+Register_PerRunConfigOption(CFGID_EVENT_PROFILING_PARTITIONS, "event-profiling-partitions", CFG_INT, "0", "When `event-profiling` is enabled and this is set to a positive number, the network is partitioned into that many partitions at the end of the run for parallel simulation, using the measured event counts of the submodules of the network and the number of messages exchanged between them. The result is written as `partition-id` settings into the file given with `event-profiling-partitions-file`, which can then be included in the configuration of the parallel runs.");
+Register_PerRunConfigOption(CFGID_EVENT_PROFILING_PARTITIONS_FILE, "event-profiling-partitions-file", CFG_FILENAME, "${resultdir}/${configname}-partitions.ini", "The file into which the partitioning computed with `event-profiling-partitions` is written.");
+Register_PerRunConfigOption(CFGID_EVENT_PROFILING_PARTITIONS_IMBALANCE, "event-profiling-partitions-imbalance", CFG_DOUBLE, "0.05", "The allowed imbalance of the partitioning computed with `event-profiling-partitions`: the total event count of a partition may exceed the average by this fraction. Larger values allow fewer messages between partitions.");
 Register_PerRunConfigOption(CFGID_PRINT_UNDISPOSED, "print-undisposed", CFG_BOOL, "true", "Whether to report objects left (that is, not deallocated by simple module destructors) after network cleanup.");
 Register_GlobalConfigOption(CFGID_SIMTIME_SCALE, "simtime-scale", CFG_INT, "-12", "DEPRECATED in favor of simtime-resolution. Sets the scale exponent, and thus the resolution of time for the 64-bit fixed-point simulation time representation. Accepted values are -18..0; for example, -6 selects microsecond resolution. -12 means picosecond resolution, with a maximum simtime of ~110 days.");
 Register_GlobalConfigOption(CFGID_SIMTIME_RESOLUTION, "simtime-resolution", CFG_CUSTOM, "ps", "Sets the resolution for the 64-bit fixed-point simulation time representation. Accepted values are: second-or-smaller time units (`s`, `ms`, `us`, `ns`, `ps`, `fs` or as), power-of-ten multiples of such units (e.g. 100ms), and base-10 scale exponents in the -18..0 range. The maximum representable simulation time depends on the resolution. The default is picosecond resolution, which offers a range of ~110 days.");
 Register_GlobalConfigOption(CFGID_NED_PATH, "ned-path", CFG_PATH, "", "A semicolon-separated list of directories. The directories will be regarded as roots of the NED package hierarchy, and all NED files will be loaded from their subdirectory trees. This option is normally left empty, as the OMNeT++ IDE sets the NED path automatically, and for simulations started outside the IDE it is more convenient to specify it via command-line option (-n) or via environment variable (OMNETPP_NED_PATH, NEDPATH).");
 Register_GlobalConfigOption(CFGID_NED_EXCLUSION_PATH, "ned-exclusion-path", CFG_PATH, "", "A semicolon-separated list of directories to be skipped when loading NED files. Relative paths are interpreted as relative to root of the NED folder being loaded, i.e. specifying 'tests' will skip the 'tests' subdirectory in each folder in the NED path. The NED exclusion path may also be specified via command-line option (-x) and environment variable (OMNETPP_NED_EXCLUSION_PATH).");
+Register_GlobalConfigOption(CFGID_NED_AST_CACHE_FILE, "ned-ast-cache-file", CFG_FILENAME, nullptr, "Name of a file for caching the parsed form of NED files between simulation runs. When set, NED files that have not changed since they were cached (as determined by their modification time and size) are not parsed again, which speeds up the startup of simulations with large models. The file is created on the first run, and updated when NED files change. It may be shared by simulation processes running in parallel.");
+Register_GlobalConfigOption(CFGID_EXPRESSION_BYTECODE, "expression-bytecode", CFG_BOOL, "false", "When enabled, NED and ini file expressions (e.g. volatile parameters and statistic filters) are compiled into bytecode for faster repeated evaluation. Parameter references, functions and other context-dependent parts of the expressions are still evaluated by the expression tree interpreter.");
 Register_GlobalConfigOption(CFGID_DEBUGGER_ATTACH_ON_STARTUP, "debugger-attach-on-startup", CFG_BOOL, "false", "When set to true, the simulation program will launch an external debugger attached to it (if not already present), allowing you to set breakpoints before proceeding. The debugger command is configurable. Note that debugging (i.e. attaching to) a non-child process needs to be explicitly enabled on some systems, e.g. Ubuntu.");
 Register_GlobalConfigOption(CFGID_DEBUGGER_ATTACH_ON_ERROR, "debugger-attach-on-error", CFG_BOOL, "false", "When set to true, runtime errors and crashes will trigger an external debugger to be launched (if not already present), allowing you to perform just-in-time debugging on the simulation process. The debugger command is configurable. Note that debugging (i.e. attaching to) a non-child process needs to be explicitly enabled on some systems, e.g. Ubuntu.");
 Register_GlobalConfigOption(CFGID_DEBUGGER_ATTACH_COMMAND, "debugger-attach-command", CFG_STRING, nullptr, "Command line to launch the debugger. It must contain exactly one percent sign, as `%u`, which will be replaced by the PID of this process. The command must not block (i.e. it should end in `&` on Unix-like systems). Default on this platform: `" DEFAULT_DEBUGGER_COMMAND "`. This default can be overridden with the `OMNETPP_DEBUGGER_COMMAND` environment variable.");
@@ -282,6 +298,11 @@ EnvirOptions::EnvirOptions()
     verbose = true;
     useStderr = true;
     printUndisposed = true;
+    objectPooling = false;
+    expressionBytecode = false;
+    eventProfiling = false;
+    eventProfilingPartitions = 0;
+    eventProfilingPartitionsImbalance = 0.05;
     realTimeLimit = 0;
     cpuTimeLimit = 0;
 }
@@ -511,6 +532,12 @@ void EnvirBase::printRunInfo(const char *configName, const char *runFilter, cons
 bool EnvirBase::setup()
 {
     try {
+#ifdef WITH_THREADED_PARSIM
+        // partitions that run as threads are set up one at a time
+        static std::mutex setupMutex;
+        std::lock_guard<std::mutex> lock(setupMutex);
+#endif
+
         // ensure correct numeric format in output files
         setPosixLocale();
 
@@ -558,33 +585,15 @@ bool EnvirBase::setup()
 #endif
         }
 
-        // load NED files embedded into the simulation program as string literals
-        if (!embeddedNedFiles.empty()) {
-            if (opt->verbose)
-                out << "Loading embedded NED files: " << embeddedNedFiles.size() << endl;
-            for (const auto& file : embeddedNedFiles) {
-                std::string nedText = file.nedText;
-                if (!file.garblephrase.empty())
-                    nedText = opp_ungarble(file.nedText, file.garblephrase);
-                getSimulation()->loadNedText(file.fileName.c_str(), nedText.c_str());
-            }
-        }
-
-        // load NED files from folders on the NED path
-        StringTokenizer tokenizer(opt->nedPath.c_str(), PATH_SEPARATOR);
-        std::set<std::string> foldersLoaded;
-        while (tokenizer.hasMoreTokens()) {
-            const char *folder = tokenizer.nextToken();
-            if (foldersLoaded.find(folder) == foldersLoaded.end()) {
-                if (opt->verbose)
-                    out << "Loading NED files from " << folder << ": ";
-                int count = getSimulation()->loadNedSourceFolder(folder, opt->nedExclusionPath.c_str());
-                if (opt->verbose)
-                    out << " " << count << endl;
-                foldersLoaded.insert(folder);
-            }
-        }
-        getSimulation()->doneLoadingNedFiles();
+#ifdef WITH_THREADED_PARSIM
+        // NED types are shared by partitions that run as threads; the first one loads them
+        static bool nedFilesLoaded = false;
+        if (!nedFilesLoaded)
+            loadNedFiles();
+        nedFilesLoaded = true;
+#else
+        loadNedFiles();
+#endif
 
         // notify listeners when global setup is complete
         notifyLifecycleListeners(LF_ON_STARTUP);
@@ -597,6 +606,40 @@ bool EnvirBase::setup()
     return true;
 }
 
+void EnvirBase::loadNedFiles()
+{
+    if (!opt->nedAstCacheFile.empty())
+        getSimulation()->setNedAstCacheFile(opt->nedAstCacheFile.c_str());
+
+    // load NED files embedded into the simulation program as string literals
+    if (!embeddedNedFiles.empty()) {
+        if (opt->verbose)
+            out << "Loading embedded NED files: " << embeddedNedFiles.size() << endl;
+        for (const auto& file : embeddedNedFiles) {
+            std::string nedText = file.nedText;
+            if (!file.garblephrase.empty())
+                nedText = opp_ungarble(file.nedText, file.garblephrase);
+            getSimulation()->loadNedText(file.fileName.c_str(), nedText.c_str());
+        }
+    }
+
+    // load NED files from folders on the NED path
+    StringTokenizer tokenizer(opt->nedPath.c_str(), PATH_SEPARATOR);
+    std::set<std::string> foldersLoaded;
+    while (tokenizer.hasMoreTokens()) {
+        const char *folder = tokenizer.nextToken();
+        if (foldersLoaded.find(folder) == foldersLoaded.end()) {
+            if (opt->verbose)
+                out << "Loading NED files from " << folder << ": ";
+            int count = getSimulation()->loadNedSourceFolder(folder, opt->nedExclusionPath.c_str());
+            if (opt->verbose)
+                out << " " << count << endl;
+            foldersLoaded.insert(folder);
+        }
+    }
+    getSimulation()->doneLoadingNedFiles();
+}
+
 void EnvirBase::printHelp()
 {
     out << "Command line options:\n";
@@ -1214,8 +1257,13 @@ void EnvirBase::processFileName(std::string& fname)
                                 "or COMPUTERNAME (Windows) environment variable", fname.c_str());
         int pid = getpid();
 
-        // append
-        fname += opp_stringf(".%s.%d%s", hostname, pid, extension.c_str());
+        // append; partitions running as threads share the pid, so they need their procId as well
+        std::string procIdSuffix;
+#ifdef WITH_THREADED_PARSIM
+        if (cThreadCommunications::getThreadProcId() != -1)
+            procIdSuffix = opp_stringf(".%d", cThreadCommunications::getThreadProcId());
+#endif
+        fname += opp_stringf(".%s.%d%s%s", hostname, pid, procIdSuffix.c_str(), extension.c_str());
     }
 }
 
@@ -1329,6 +1377,13 @@ void EnvirBase::readOptions()
     nedExclusionPath = opp_join(";", nedExclusionPath, opp_nulltoempty(getenv("OMNETPP_NED_EXCLUSION_PATH")));
     opt->nedExclusionPath = nedExclusionPath;
 
+    // NED AST cache
+    opt->nedAstCacheFile = getConfig()->getAsFilename(CFGID_NED_AST_CACHE_FILE);
+
+    // must be set before NED files and expressions in the configuration are parsed
+    opt->expressionBytecode = getConfig()->getAsBool(CFGID_EXPRESSION_BYTECODE);
+    Expression::setBytecodeEnabled(opt->expressionBytecode);
+
     // Image path similarly to NED path, except that we have compile-time default as well,
     // in the OMNETPP_IMAGE_PATH macro.
     std::string imagePath;
@@ -1367,6 +1422,26 @@ void EnvirBase::readPerRunOptions()
     opt->snapshotmanagerClass = cfg->getAsString(CFGID_SNAPSHOTMANAGER_CLASS);
     debugOnErrors = cfg->getAsBool(CFGID_DEBUG_ON_ERRORS);
     opt->printUndisposed = cfg->getAsBool(CFGID_PRINT_UNDISPOSED);
+    opt->objectPooling = cfg->getAsBool(CFGID_OBJECT_POOLING);
+#ifdef WITH_THREADED_PARSIM
+    // with partitions running as threads, pooling is turned off (and statistics
+    // are reset) once by the thread that starts the partitions, see startup.cc
+    bool isPartitionThread = cThreadCommunications::getThreadProcId() != -1;
+    if (opt->objectPooling && isPartitionThread)
+        throw cRuntimeError("object-pooling cannot be used when the partitions of a parallel simulation run as threads (memory pools are not thread-safe)");
+    if (!isPartitionThread) {
+        cMemoryPool::setPoolingEnabled(opt->objectPooling);
+        cMemoryPool::resetStatistics();
+    }
+#else
+    cMemoryPool::setPoolingEnabled(opt->objectPooling);
+    cMemoryPool::resetStatistics();
+#endif
+    opt->eventProfiling = cfg->getAsBool(CFGID_EVENT_PROFILING);
+    opt->eventProfilingFile = cfg->getAsFilename(CFGID_EVENT_PROFILING_FILE);
+    opt->eventProfilingPartitions = cfg->getAsInt(CFGID_EVENT_PROFILING_PARTITIONS);
+    opt->eventProfilingPartitionsFile = cfg->getAsFilename(CFGID_EVENT_PROFILING_PARTITIONS_FILE);
+    opt->eventProfilingPartitionsImbalance = cfg->getAsDouble(CFGID_EVENT_PROFILING_PARTITIONS_IMBALANCE);
 
     // make time limits effective
     stopwatch.setCPUTimeLimit(opt->cpuTimeLimit);
@@ -1420,6 +1495,17 @@ void EnvirBase::readPerRunOptions()
     }
     getSimulation()->setFingerprintCalculator(fingerprint);
 
+    // install event profiler
+    cEventProfiler *eventProfiler = nullptr;
+    if (opt->eventProfilingPartitions != 0 && !opt->eventProfiling)
+        throw cRuntimeError("The event-profiling-partitions option requires event-profiling=true");
+    if (opt->eventProfiling) {
+        eventProfiler = new cEventProfiler(opt->eventProfilingFile.c_str());
+        eventProfiler->setPartitioning(opt->eventProfilingPartitions, opt->eventProfilingPartitionsFile.c_str(), opt->eventProfilingPartitionsImbalance);
+        addLifecycleListener(eventProfiler);
+    }
+    getSimulation()->setEventProfiler(eventProfiler);
+
     cComponent::setCheckSignals(opt->checkSignals);
 
     // run RNG self-test on RNG class selected for this run
@@ -87,6 +87,8 @@ struct ENVIR_API EnvirOptions
     std::string imagePath;
     std::string nedPath;
     std::string nedExclusionPath;
+    std::string nedAstCacheFile;
+    bool expressionBytecode;
 
     int numRNGs;
     std::string rngClass;
@@ -111,6 +113,12 @@ struct ENVIR_API EnvirOptions
     bool verbose;
     bool warnings;
     bool printUndisposed;
+    bool objectPooling;
+    bool eventProfiling;
+    std::string eventProfilingFile;
+    int eventProfilingPartitions;
+    std::string eventProfilingPartitionsFile;
+    double eventProfilingPartitionsImbalance;
 
     simtime_t simtimeLimit;
     simtime_t warmupPeriod;
@@ -301,6 +309,7 @@ class ENVIR_API EnvirBase : public cRunnableEnvir
     // functions added locally
     virtual bool simulationRequired();
     virtual bool setup();  // does not throw; returns true if OK to go on
+    virtual void loadNedFiles();
     virtual void run();  // does not throw; delegates to doRun()
     virtual void shutdown(); // does not throw
     virtual void doRun() = 0;
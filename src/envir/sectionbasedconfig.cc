@@ -16,6 +16,7 @@
 *--------------------------------------------------------------*/
 
 #include <cassert>
+#include <climits>
 #include <algorithm>
 #include <sstream>
 #include "common/opp_ctype.h"
@@ -163,7 +164,7 @@ void SectionBasedConfiguration::clear()
     entries.clear();
     config.clear();
     suffixBins.clear();
-    wildcardSuffixBin.entries.clear();
+    wildcardSuffixBin = SuffixBin();
     variables.clear();
 }
 
@@ -313,7 +314,7 @@ void SectionBasedConfiguration::activateGlobalConfig()
             addEntry(Entry(basedirRef, e.getKey(), value.c_str()));
         }
     }
-
+    compileSuffixBins();
 }
 
 void SectionBasedConfiguration::activateConfig(const char *configName, int runNumber)
@@ -365,6 +366,7 @@ void SectionBasedConfiguration::activateConfig(const char *configName, int runNu
             addEntry(Entry(basedirRef, e.getKey(), value.c_str()));
         }
     }
+    compileSuffixBins();
 }
 
 inline std::string unquote(const std::string& txt)
@@ -942,6 +944,75 @@ void SectionBasedConfiguration::addEntry(const Entry& entry)
     }
 }
 
+// Replaces vector indices in the path with zero, e.g. "Net.host[12].eth0" becomes
+// "Net.host[0].eth0". For patterns accepted by isIndexInsensitivePattern(), the
+// result of matching the normalized path is the same as that of the original one.
+static void normalizePath(const char *path, std::string& result)
+{
+    result.clear();
+    for (const char *s = path; *s; s++) {
+        result += *s;
+        if (*s == '[' && opp_isdigit(*(s+1))) {
+            result += '0';
+            while (opp_isdigit(*(s+1)))
+                s++;
+        }
+    }
+}
+
+// Returns true if the pattern cannot tell apart paths that only differ in vector
+// indices. This holds if it contains no "?", numeric range or character set, and
+// every digit in it is part of a name like "eth0": then digits of an index can only
+// be matched by "*" or "**", and those match any nonempty digit sequence equally well.
+static bool isIndexInsensitivePattern(const char *pattern)
+{
+    if (strpbrk(pattern, "?{\\") || strstr(pattern, "[..]"))
+        return false;
+    for (const char *s = pattern; *s; s++)
+        if (opp_isdigit(*s) && s != pattern && !opp_isdigit(*(s-1)) && !opp_isalpha(*(s-1)) && *(s-1) != '_')
+            return false;  // includes "[3]" and "[0..3]"
+    return pattern[0] == '\0' || !opp_isdigit(pattern[0]);
+}
+
+void SectionBasedConfiguration::compileSuffixBins()
+{
+    for (auto& suffixBin : suffixBins)
+        compileSuffixBin(suffixBin.second);
+    compileSuffixBin(wildcardSuffixBin);
+}
+
+void SectionBasedConfiguration::compileSuffixBin(SuffixBin& bin)
+{
+    // with only a few entries, matching them one by one is just as fast
+    const int MIN_ENTRIES_TO_COMPILE = 4;
+
+    bin.ownerMatcher.clear();
+    bin.uncompiledEntries.clear();
+    bin.cache.clear();
+    bin.compiled = (int)bin.entries.size() >= MIN_ENTRIES_TO_COMPILE;
+    bin.cacheable = false;
+    if (!bin.compiled)
+        return;
+
+    // lookups can be cached if no key can distinguish between vector indices, see normalizePath()
+    bin.cacheable = true;
+    for (const auto& entry : bin.entries)
+        if (!isIndexInsensitivePattern(entry.key.c_str()))
+            bin.cacheable = false;
+
+    for (int i = 0; i < (int)bin.entries.size(); i++) {
+        const MatchableEntry& entry = bin.entries[i];
+        bool added = false;
+        if (entry.ownerPattern) {
+            std::string ownerName, suffix;
+            splitKey(entry.key.c_str(), ownerName, suffix);
+            added = bin.ownerMatcher.addPattern(ownerName.c_str(), i);
+        }
+        if (!added)
+            bin.uncompiledEntries.push_back(i);
+    }
+}
+
 void SectionBasedConfiguration::splitKey(const char *key, std::string& outOwnerName, std::string& outBinName)
 {
     std::string tmp = key;
@@ -1256,14 +1327,76 @@ const cConfiguration::KeyValue& SectionBasedConfiguration::getParameterEntry(con
     const SuffixBin *bin = it == suffixBins.end() ? &wildcardSuffixBin : &it->second;
 
     // find first match in the bin
-    for (const auto & entry : bin->entries) {
-        if (entryMatches(entry, moduleFullPath, paramName))
-            if (hasDefaultValue || entry.value != "default")
-                return entry;
-    }
+    const MatchableEntry *entry = findFirstMatch(*bin, moduleFullPath, paramName, hasDefaultValue);
+    if (entry)
+        return *entry;
     return nullEntry;  // not found
 }
 
+const SectionBasedConfiguration::MatchableEntry *SectionBasedConfiguration::findFirstMatch(const SuffixBin& bin, const char *ownerFullPath, const char *suffix, bool acceptDefault)
+{
+    if (!bin.cacheable)
+        return findFirstMatchUncached(bin, ownerFullPath, suffix, acceptDefault);
+
+    // limit memory use with networks that consist of many differently named modules
+    const size_t MAX_CACHE_SIZE = 100000;
+
+    std::string key;
+    normalizePath(ownerFullPath, key);
+    key += ' ';
+    key += suffix;
+    key += acceptDefault ? '+' : '-';
+    auto it = bin.cache.find(key);
+    if (it != bin.cache.end())
+        return it->second;
+
+    const MatchableEntry *entry = findFirstMatchUncached(bin, ownerFullPath, suffix, acceptDefault);
+    if (bin.cache.size() >= MAX_CACHE_SIZE)
+        bin.cache.clear();
+    bin.cache[key] = entry;
+    return entry;
+}
+
+const SectionBasedConfiguration::MatchableEntry *SectionBasedConfiguration::findFirstMatchUncached(const SuffixBin& bin, const char *ownerFullPath, const char *suffix, bool acceptDefault)
+{
+    if (!bin.compiled) {
+        for (const auto & entry : bin.entries)
+            if (entryMatches(entry, ownerFullPath, suffix))
+                if (acceptDefault || entry.value != "default")
+                    return &entry;
+        return nullptr;
+    }
+
+    // take the entries matched by ownerMatcher in order, and check the uncompiled
+    // entries in between them, so that the first matching entry wins
+    const MatchableEntry *result = nullptr;
+    auto otherIt = bin.uncompiledEntries.begin();
+    auto findUncompiledMatchBefore = [&](int limit) -> bool {
+        for ( ; otherIt != bin.uncompiledEntries.end() && *otherIt < limit; ++otherIt) {
+            const MatchableEntry& entry = bin.entries[*otherIt];
+            if (entryMatches(entry, ownerFullPath, suffix) && (acceptDefault || entry.value != "default")) {
+                result = &entry;
+                return true;
+            }
+        }
+        return false;
+    };
+    bin.ownerMatcher.findFirstMatch(ownerFullPath, [&](int index) -> bool {
+        if (findUncompiledMatchBefore(index))
+            return true;
+        const MatchableEntry& entry = bin.entries[index];
+        if (entry.suffixPattern && !entry.suffixPattern->matches(suffix))
+            return false;
+        if (!acceptDefault && entry.value == "default")
+            return false;
+        result = &entry;
+        return true;
+    });
+    if (!result)
+        findUncompiledMatchBefore(INT_MAX);
+    return result;
+}
+
 bool SectionBasedConfiguration::entryMatches(const MatchableEntry& entry, const char *moduleFullPath, const char *paramName)
 {
     if (!entry.fullPathPattern) {
@@ -1340,10 +1473,9 @@ const cConfiguration::KeyValue& SectionBasedConfiguration::getPerObjectConfigEnt
     const SuffixBin *suffixBin = &it->second;
 
     // find first match in the bin
-    for (const auto & entry : suffixBin->entries) {
-        if (entryMatches(entry, objectFullPath, keySuffix))
-            return entry;  // found value
-    }
+    const MatchableEntry *entry = findFirstMatch(*suffixBin, objectFullPath, keySuffix, true);
+    if (entry)
+        return *entry;  // found value
     return nullEntry;  // not found
 }
 
@@ -19,10 +19,12 @@
 #define __OMNETPP_ENVIR_SECTIONBASEDCONFIG_H
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <set>
 #include <string>
 #include "common/stringpool.h"
+#include "common/multipatternmatcher.h"
 #include "omnetpp/cconfiguration.h"
 #include "omnetpp/cconfigreader.h"
 #include "envirdefs.h"
@@ -49,6 +51,7 @@ class ENVIR_API SectionBasedConfiguration : public cConfigurationEx
   private:
     typedef omnetpp::common::StringPool StringPool;
     typedef omnetpp::common::PatternMatcher PatternMatcher;
+    typedef omnetpp::common::MultiPatternMatcher MultiPatternMatcher;
     typedef std::set<std::string> StringSet;
     typedef std::map<std::string,std::string> StringMap;
 
@@ -119,8 +122,28 @@ class ENVIR_API SectionBasedConfiguration : public cConfigurationEx
     //   **.tcp.eedVector.record-interval ==> goes into the "record-interval" bin; ownerPattern="**.tcp.eedVector"
     //   **.tcp.eedVector.record-*"       ==> goes into the wildcard bin; ownerPattern="**.tcp.eedVector", suffixPattern="record-*"
     //
+    // Bins may still contain many entries (e.g. "**.host[*].app[0].sendInterval",
+    // "**.router*.app[0].sendInterval", etc.), so once all entries have been added,
+    // the owner patterns of each bin are compiled into a MultiPatternMatcher that
+    // matches a module path against all of them in one pass. Entries whose pattern
+    // cannot be compiled (e.g. fullPathPattern entries) are matched one by one,
+    // merged in order with the results of the matcher, so that the first matching
+    // entry is still the one that wins.
+    //
+    // Large networks consist of many instances of the same few module types,
+    // whose paths only differ in the vector indices ("Net.host[12].app[0]" vs
+    // "Net.host[13].app[0]"). If none of the keys in a bin can tell indices apart
+    // (i.e. there are no keys like "**.host[0].app[*].x" or "**.host[0..9].x"),
+    // replacing each index in the path with 0 provably does not change the
+    // result of the lookup, so results are cached by that normalized path.
+    //
     struct SuffixBin {
         std::vector<MatchableEntry> entries;
+        MultiPatternMatcher ownerMatcher; // ids are indices into entries[]; only filled in if bin is compiled
+        std::vector<int> uncompiledEntries; // indices of entries not covered by ownerMatcher
+        bool compiled = false;
+        bool cacheable = false; // whether lookups may be cached by normalized path
+        mutable std::unordered_map<std::string,const MatchableEntry *> cache; // normalized path+suffix -> first match
     };
 
   private:
@@ -168,6 +191,10 @@ class ENVIR_API SectionBasedConfiguration : public cConfigurationEx
     std::vector<int> computeSectionChain(int sectionId) const;
     std::vector<int> getBaseConfigIds(int sectionId) const;
     void addEntry(const Entry& entry);
+    void compileSuffixBins();
+    static void compileSuffixBin(SuffixBin& bin);
+    static const MatchableEntry *findFirstMatch(const SuffixBin& bin, const char *ownerFullPath, const char *suffix, bool acceptDefault);
+    static const MatchableEntry *findFirstMatchUncached(const SuffixBin& bin, const char *ownerFullPath, const char *suffix, bool acceptDefault);
     static void splitKey(const char *key, std::string& outOwnerName, std::string& outBinName);
     static bool entryMatches(const MatchableEntry& entry, const char *moduleFullPath, const char *paramName);
     std::vector<Scenario::IterationVariable> collectIterationVariables(const std::vector<int>& sectionChain, StringMap& outLocationToNameMap) const;
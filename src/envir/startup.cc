@@ -19,6 +19,11 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdint>
+#include <vector>
+#include <algorithm>
+#ifdef WITH_THREADED_PARSIM
+#include <thread>
+#endif
 
 #include "common/opp_ctype.h"
 #include "common/fnamelisttokenizer.h"
@@ -27,6 +32,7 @@
 #include "omnetpp/distrib.h"
 #include "omnetpp/cconfigoption.h"
 #include "omnetpp/cmodule.h"
+#include "omnetpp/cmemorypool.h"
 #include "common/ver.h"
 #include "envirbase.h" // ARGSPEC
 #include "args.h"
@@ -45,6 +51,9 @@
 #include "omnetppoutvectormgr.h"
 #include "sqliteoutscalarmgr.h"
 #include "sqliteoutvectormgr.h"
+#ifdef WITH_THREADED_PARSIM
+#include "sim/parsim/cthreadcomm.h"
+#endif
 
 using namespace omnetpp::common;
 
@@ -53,8 +62,12 @@ namespace envir {
 
 Register_GlobalConfigOption(CFGID_LOAD_LIBS, "load-libs", CFG_FILENAMES, "", "A space-separated list of dynamic libraries to be loaded on startup. The libraries should be given without the `.dll` or `.so` suffix -- that will be automatically appended.");
 Register_GlobalConfigOption(CFGID_CONFIGURATION_CLASS, "configuration-class", CFG_STRING, "", "Part of the Envir plugin mechanism: selects the class from which all configuration information will be obtained. This option lets you replace omnetpp.ini with some other implementation, e.g. database input. The simulation program still has to bootstrap from an omnetpp.ini (which contains the configuration-class setting). The class should implement the `cConfigurationEx` interface.");
+Register_GlobalConfigOption(CFGID_PARSIM_THREADCOMM_NUMPARTITIONS, "parsim-threadcommunications-numpartitions", CFG_INT, "0", "When `cThreadCommunications` is selected as parsim communications class: the number of partitions. The partitions are started as threads of the simulation process, instead of as separate processes. Must be set in the `[General]` section. Requires OMNeT++ to be built with `WITH_THREADED_PARSIM=yes`.");
 Register_GlobalConfigOption(CFGID_USER_INTERFACE, "user-interface", CFG_STRING, "", "Selects the user interface to be started. Known good values are Cmdenv and Qtenv. This option is normally left empty, as it is more convenient to specify the user interface via a command-line option or the IDE's Run and Debug dialogs. New user interfaces can be defined by subclassing `cRunnableEnvir`.");
 
+extern cConfigOption *CFGID_PARALLEL_SIMULATION;
+extern cConfigOption *CFGID_PARSIM_COMMUNICATIONS_CLASS;
+
 // helper macro
 #define CREATE_BY_CLASSNAME(var, classname, baseclass, description) \
     baseclass *var ## _tmp = (baseclass *)createOne(classname); \
@@ -94,6 +107,75 @@ static std::ostream& err()
     return err;
 }
 
+static SectionBasedConfiguration *readConfiguration(ArgList& args)
+{
+    InifileReader *iniReader = new InifileReader();
+    const char *fname;
+    int inifilesRead = 0;
+    for (int k = 0; (fname = args.optionValue('f', k)) != nullptr; k++, inifilesRead++)
+        iniReader->readFile(fname);
+    for (int k = 0; (fname = args.argument(k)) != nullptr; k++, inifilesRead++)
+        iniReader->readFile(fname);
+    if (inifilesRead == 0) {
+        fname = "omnetpp.ini";
+        if (fileExists(fname))
+            iniReader->readFile(fname);
+        else if (!args.optionGiven('v') && !args.optionGiven('h') && !args.longOptionGiven("network"))
+            throw cRuntimeError("Missing configuration: No ini files specified and no 'omnetpp.ini' in the current working directory (specify at least --network=<name> to suppress this message)");
+    }
+
+    // activate [General] section so that we can read global settings from it
+    SectionBasedConfiguration *config = new SectionBasedConfiguration();
+    config->setConfigurationReader(iniReader);
+    config->setCommandLineConfigOptions(args.getLongOptions(), getWorkingDir().c_str());
+    return config;
+}
+
+static int runPartitionsAsThreads(int numPartitions, cOmnetAppRegistration *appReg, cRunnableEnvir *app, cConfigurationEx *config, ArgList& args, int argc, char *argv[])
+{
+#ifdef WITH_THREADED_PARSIM
+    // every partition needs its own user interface and configuration object,
+    // because they hold the state of the run; the first one gets the existing ones
+    std::vector<cRunnableEnvir *> apps = { app };
+    std::vector<cConfigurationEx *> configs = { config };
+    for (int i = 1; i < numPartitions; i++) {
+        configs.push_back(readConfiguration(args));
+        apps.push_back(appReg->createOne());
+    }
+
+    // memory pools are not thread-safe; with pooling off, they are bypassed entirely
+    cMemoryPool::setPoolingEnabled(false);
+    cMemoryPool::resetStatistics();
+
+    cThreadCommunications::createMailboxes(numPartitions);
+    std::vector<int> exitCodes(numPartitions, 0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numPartitions; i++) {
+        threads.push_back(std::thread([&, i]() {
+            cThreadCommunications::setThreadProcId(i);
+            cSimulation *simulation = nullptr;
+            try {
+                simulation = new cSimulation("simulation", apps[i]);
+                cSimulation::setActiveSimulation(simulation);
+                exitCodes[i] = apps[i]->run(argc, argv, configs[i]);
+            }
+            catch (std::exception& e) {
+                err() << e.what() << endl;
+                exitCodes[i] = 1;
+            }
+            cSimulation::setActiveSimulation(nullptr);
+            delete simulation;  // will delete app as well
+        }));
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    cThreadCommunications::deleteMailboxes();
+    return *std::max_element(exitCodes.begin(), exitCodes.end());
+#else
+    throw cRuntimeError("Cannot run partitions as threads (parsim-threadcommunications-numpartitions): OMNeT++ was compiled without WITH_THREADED_PARSIM=yes");
+#endif
+}
+
 int setupUserInterface(int argc, char *argv[])
 {
     //
@@ -101,6 +183,8 @@ int setupUserInterface(int argc, char *argv[])
     //
     cSimulation *simulation = nullptr;
     cRunnableEnvir *app = nullptr;
+    cOmnetAppRegistration *appReg = nullptr;
+    ArgList args;
     SectionBasedConfiguration *bootConfig = nullptr;
     cConfigurationEx *config = nullptr;
     bool verbose = false;
@@ -113,7 +197,6 @@ int setupUserInterface(int argc, char *argv[])
         verifyIntTypes();
 
         // args
-        ArgList args;
         args.parse(argc, argv, ARGSPEC);
 
         useStderr = !args.optionGiven('m');
@@ -130,25 +213,7 @@ int setupUserInterface(int argc, char *argv[])
         // First, load the ini file(s). It might contain the name of the user interface
         // to instantiate.
         //
-        InifileReader *iniReader = new InifileReader();
-        const char *fname;
-        int inifilesRead = 0;
-        for (int k = 0; (fname = args.optionValue('f', k)) != nullptr; k++, inifilesRead++)
-            iniReader->readFile(fname);
-        for (int k = 0; (fname = args.argument(k)) != nullptr; k++, inifilesRead++)
-            iniReader->readFile(fname);
-        if (inifilesRead == 0) {
-            fname = "omnetpp.ini";
-            if (fileExists(fname))
-                iniReader->readFile(fname);
-            else if (!args.optionGiven('v') && !args.optionGiven('h') && !args.longOptionGiven("network"))
-                throw cRuntimeError("Missing configuration: No ini files specified and no 'omnetpp.ini' in the current working directory (specify at least --network=<name> to suppress this message)");
-        }
-
-        // activate [General] section so that we can read global settings from it
-        bootConfig = new SectionBasedConfiguration();
-        bootConfig->setConfigurationReader(iniReader);
-        bootConfig->setCommandLineConfigOptions(args.getLongOptions(), getWorkingDir().c_str());
+        bootConfig = readConfiguration(args);
 
         //
         // Load all libraries specified on the command line ('-l' options),
@@ -200,7 +265,6 @@ int setupUserInterface(int argc, char *argv[])
         if (appName.empty())
             appName = config->getAsString(CFGID_USER_INTERFACE);
 
-        cOmnetAppRegistration *appReg = nullptr;
         if (!appName.empty()) {
             // look up specified user interface
             appReg = static_cast<cOmnetAppRegistration *>(omnetapps.getInstance()->lookup(appName.c_str()));
@@ -245,7 +309,21 @@ int setupUserInterface(int argc, char *argv[])
     // RUN
     //
     try {
-        if (app) {
+        int numThreadPartitions = 0;
+        if (app && config->getAsBool(CFGID_PARALLEL_SIMULATION))
+            numThreadPartitions = config->getAsInt(CFGID_PARSIM_THREADCOMM_NUMPARTITIONS);
+        if (numThreadPartitions > 0) {
+            // partitions of the parallel simulation run as threads of this process
+            std::string commClass = config->getAsString(CFGID_PARSIM_COMMUNICATIONS_CLASS);
+            if (commClass != "cThreadCommunications" && commClass != "omnetpp::cThreadCommunications")
+                throw cRuntimeError("parsim-threadcommunications-numpartitions requires parsim-communications-class=\"cThreadCommunications\"");
+            if (config != bootConfig)
+                throw cRuntimeError("Running partitions as threads is not supported with a custom configuration-class");
+            cRunnableEnvir *firstApp = app;
+            app = nullptr;  // will be deleted by its simulation
+            exitCode = runPartitionsAsThreads(numThreadPartitions, appReg, firstApp, config, args, argc, argv);
+        }
+        else if (app) {
             simulation = new cSimulation("simulation", app);
             cSimulation::setActiveSimulation(simulation);
             exitCode = app->run(argc, argv, config);
@@ -291,6 +291,7 @@ void MsgAnalyzer::analyzeClassOrStruct(ClassInfo& classInfo, const std::string&
     classInfo.subclassable = getPropertyAsBool(classInfo.props, PROP_SUBCLASSABLE, !isPrimitive);
     classInfo.supportsPtr = getPropertyAsBool(classInfo.props, PROP_SUPPORTSPTR, !isPrimitive);
     classInfo.isEditable = getPropertyAsBool(classInfo.props, PROP_EDITABLE, isPrimitive);
+    classInfo.triviallyCopyable = getPropertyAsBool(classInfo.props, PROP_TRIVIALLYCOPYABLE, false);
 
     classInfo.defaultValue = getProperty(classInfo.props, PROP_DEFAULTVALUE, "");
 
@@ -314,6 +315,9 @@ void MsgAnalyzer::analyzeClassOrStruct(ClassInfo& classInfo, const std::string&
         errors->addError(classInfo.astNode, "class name may only contain '::' when generating descriptor for an existing class");
 
     classInfo.customize = getPropertyAsBool(classInfo.props, PROP_CUSTOMIZE, false);
+    classInfo.pooled = getPropertyAsBool(classInfo.props, PROP_POOLED, false);
+    if (classInfo.pooled && classInfo.keyword == "struct")
+        errors->addError(classInfo.astNode, "@pooled is only supported for classes, messages and packets");
 
     if (classInfo.customize) {
         classInfo.className = classInfo.name + "_Base";
@@ -402,6 +406,8 @@ void MsgAnalyzer::analyzeField(ClassInfo& classInfo, FieldInfo *field, const std
     field->isFixedArray = field->isArray && !field->arraySize.empty();
 
     field->nopack = getPropertyAsBool(field->props, PROP_NOPACK, false);
+    bool isTriviallyCopyableDefault = fieldClassInfo.triviallyCopyable && !hasProperty(field->props, PROP_CPPTYPE);  // a different C++ type may not be
+    field->isTriviallyCopyable = getPropertyAsBool(field->props, PROP_TRIVIALLYCOPYABLE, isTriviallyCopyableDefault);
     field->isOpaque = getPropertyAsBool(field->props, PROP_OPAQUE, fieldClassInfo.isOpaque);
     field->overrideGetter = getPropertyAsBool(field->props, PROP_OVERRIDEGETTER, false) || getPropertyAsBool(field->props, "override", false);
     field->overrideSetter = getPropertyAsBool(field->props, PROP_OVERRIDESETTER, false) || getPropertyAsBool(field->props, "override", false);
@@ -674,6 +680,7 @@ MsgAnalyzer::ClassInfo MsgAnalyzer::extractClassInfoFromEnum(EnumElement *enumEl
     classInfo.byValue = true;
     classInfo.subclassable = false;
     classInfo.supportsPtr = false;
+    classInfo.triviallyCopyable = true;
 
     classInfo.dataTypeBase = classInfo.qname;
     classInfo.argTypeBase = classInfo.qname;
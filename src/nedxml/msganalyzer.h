@@ -116,6 +116,7 @@ class NEDXML_API MsgAnalyzer
     static constexpr const char* PROP_BEFORECHANGE = "beforeChange";
     static constexpr const char* PROP_IMPLEMENTS = "implements";
     static constexpr const char* PROP_NOPACK = "nopack";
+    static constexpr const char* PROP_TRIVIALLYCOPYABLE = "triviallyCopyable";
     static constexpr const char* PROP_OWNED = "owned";
     static constexpr const char* PROP_EDITABLE = "editable";
     static constexpr const char* PROP_REPLACEABLE = "replaceable";
@@ -134,6 +135,7 @@ class NEDXML_API MsgAnalyzer
     static constexpr const char* PROP_ALLOWREPLACE = "allowReplace";
     static constexpr const char* PROP_STR = "str";
     static constexpr const char* PROP_CUSTOMIZE = "customize";
+    static constexpr const char* PROP_POOLED = "pooled";
     static constexpr const char* PROP_OVERWRITEPREVIOUSDEFINITION = "overwritePreviousDefinition";
     static constexpr const char* PROP_CUSTOM = "custom";
 };
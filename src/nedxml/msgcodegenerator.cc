@@ -199,6 +199,27 @@ static const char *PARSIMPACK_BOILERPLATE =
     "        doParsimUnpacking(b, t[i]);\n"
     "}\n"
     "\n"
+    "// Pack/unpack consecutive trivially copyable data members from 'first' to 'last' (inclusive) as one block of raw data\n"
+    "template<typename F, typename L>\n"
+    "void doParsimBulkPacking(omnetpp::cCommBuffer *b, const F& first, const L& last)\n"
+    "{\n"
+    "    b->packBytes(&first, (const char *)(&last + 1) - (const char *)&first);\n"
+    "}\n"
+    "\n"
+    "template<typename F, typename L>\n"
+    "void doParsimBulkUnpacking(omnetpp::cCommBuffer *b, F& first, L& last)\n"
+    "{\n"
+    "    b->unpackBytes(&first, (char *)(&last + 1) - (char *)&first);\n"
+    "}\n"
+    "\n"
+    "// Pack a dynamic array of trivially copyable elements as one block of raw data; a large array\n"
+    "// may be transmitted directly from the message instead of being copied (see cCommBuffer::packExternal())\n"
+    "template<typename T>\n"
+    "void doParsimPodArrayPacking(omnetpp::cCommBuffer *b, const T *t, int n)\n"
+    "{\n"
+    "    b->packExternal(t, n * sizeof(T));\n"
+    "}\n"
+    "\n"
     "// Default rule to prevent compiler from choosing base class' doParsimPacking() function\n"
     "template<typename T>\n"
     "void doParsimPacking(omnetpp::cCommBuffer *, const T& t)\n"
@@ -465,6 +486,12 @@ void MsgCodeGenerator::generateClassDecl(const ClassInfo& classInfo, const std::
     if (!classInfo.customize) {
         H << "    " << classInfo.className << "& operator=(const " << classInfo.className << "& other);\n";
     }
+    if (classInfo.pooled) {
+        H << "    static void *operator new(size_t size);\n";
+        H << "    static void operator delete(void *p, size_t size);\n";
+        H << "    static void *operator new(size_t, void *place) {return place;}\n";
+        H << "    static void operator delete(void *, void *) {}\n";
+    }
     if (classInfo.iscObject) {
         H << "    virtual " << classInfo.className << " *dup() const override ";
         if (classInfo.customize)
@@ -538,6 +565,26 @@ inline std::string varElem(const MsgTypeTable::FieldInfo& field)
     return str("this->") + field.var + (field.isArray ? "[i]" : "");
 }
 
+// whether the field's value (or array elements) can be packed as raw data
+inline bool isPodField(const MsgTypeTable::FieldInfo& field)
+{
+    return field.isTriviallyCopyable && !field.isPointer && !field.isConst && !field.isAbstract && !field.isCustom;
+}
+
+// Returns the end of the run of fields starting at index i that can be packed
+// as a single block of raw data: consecutive data members that are trivially
+// copyable scalars or fixed-size arrays. Returns i if there is no such run.
+static size_t findBulkPackingRun(const MsgTypeTable::ClassInfo::Fieldlist& fields, size_t i)
+{
+    size_t end = i;
+    while (end < fields.size() && isPodField(fields[end]) && !fields[end].isDynamicArray && !fields[end].nopack)
+        end++;
+    // a single scalar is packed as usual, it would not be any faster
+    if (end == i + 1 && !fields[i].isArray)
+        return i;
+    return end;
+}
+
 inline std::string forEachIndex(const MsgTypeTable::FieldInfo& field)
 {
     return str("    for (") + field.sizeType + " i = 0; i < " + field.sizeVar + "; i++)";
@@ -550,6 +597,20 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
     if (!classInfo.customize && classInfo.iscObject)
         CC << "Register_Class(" << classInfo.className << ")\n\n";
 
+    if (classInfo.pooled) {
+        // with @customize, the pool's block size is determined by the first allocation (that of the user's subclass)
+        std::string poolVar = classInfo.className + "_pool";
+        CC << "static omnetpp::cMemoryPool " << poolVar << "(\"" << classInfo.realClass << "\", " << (classInfo.customize ? "0" : str("sizeof(") + classInfo.className + ")") << ");\n\n";
+        CC << "void *" << classInfo.className << "::operator new(size_t size)\n";
+        CC << "{\n";
+        CC << "    return " << poolVar << ".allocate(size);\n";
+        CC << "}\n\n";
+        CC << "void " << classInfo.className << "::operator delete(void *p, size_t size)\n";
+        CC << "{\n";
+        CC << "    " << poolVar << ".release(p, size);\n";
+        CC << "}\n\n";
+    }
+
     // constructor:
     bool isMessage = classInfo.keyword == "message" || classInfo.keyword == "packet";
     std::string ctorArgs = isMessage ? "(const char *name, short kind)" : classInfo.iscNamedObject ? "(const char *name)" : "()";
@@ -738,7 +799,14 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
             CC << "    doParsimPacking(b,(::" << classInfo.baseClass << "&)*this);\n";  // this would do for cOwnedObject too, but the other is nicer
         }
     }
-    for (const auto& field : classInfo.fieldList) {
+    for (size_t i = 0; i < classInfo.fieldList.size(); i++) {
+        const FieldInfo& field = classInfo.fieldList[i];
+        size_t runEnd = findBulkPackingRun(classInfo.fieldList, i);
+        if (runEnd > i) {
+            CC << "    doParsimBulkPacking(b," << var(field) << "," << var(classInfo.fieldList[runEnd-1]) << ");\n";
+            i = runEnd - 1;
+            continue;
+        }
         if (field.nopack)
             continue; // @nopack specified
         if (field.isAbstract || field.isCustom) {
@@ -748,7 +816,10 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
             if (field.isArray) {
                 if (field.isDynamicArray)
                     CC << "    b->pack(" << field.sizeVar << ");\n";
-                CC << "    doParsimArrayPacking(b," << var(field) << "," << field.sizeVar << ");\n";
+                if (field.isDynamicArray && isPodField(field))
+                    CC << "    doParsimPodArrayPacking(b," << var(field) << "," << field.sizeVar << ");\n";
+                else
+                    CC << "    doParsimArrayPacking(b," << var(field) << "," << field.sizeVar << ");\n";
             }
             else {
                 CC << "    doParsimPacking(b," << var(field) << ");\n";
@@ -769,7 +840,14 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
             CC << "    doParsimUnpacking(b,(::" << classInfo.baseClass << "&)*this);\n";  // this would do for cOwnedObject too, but the other is nicer
         }
     }
-    for (const auto& field : classInfo.fieldList) {
+    for (size_t i = 0; i < classInfo.fieldList.size(); i++) {
+        const FieldInfo& field = classInfo.fieldList[i];
+        size_t runEnd = findBulkPackingRun(classInfo.fieldList, i);
+        if (runEnd > i) {
+            CC << "    doParsimBulkUnpacking(b," << var(field) << "," << var(classInfo.fieldList[runEnd-1]) << ");\n";
+            i = runEnd - 1;
+            continue;
+        }
         if (field.nopack)
             continue; // @nopack specified
         if (field.isAbstract || field.isCustom) {
@@ -787,7 +865,10 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
                     CC << "        " << var(field) << " = nullptr;\n";
                     CC << "    } else {\n";
                     CC << "        " << var(field) << " = new " << field.dataType << "[" << field.sizeVar << "];\n";
-                    CC << "        doParsimArrayUnpacking(b," << var(field) << "," << field.sizeVar << ");\n";
+                    if (isPodField(field))
+                        CC << "        b->unpackPodArray(" << var(field) << "," << field.sizeVar << ");\n";
+                    else
+                        CC << "        doParsimArrayUnpacking(b," << var(field) << "," << field.sizeVar << ");\n";
                     CC << "    }\n";
                 }
             }
@@ -1047,7 +1128,14 @@ void MsgCodeGenerator::generateStructImpl(const ClassInfo& classInfo)
     CC << "{\n";
     if (!classInfo.baseClass.empty())
         CC << "    doParsimPacking(b,(::" << classInfo.baseClass << "&)a);\n";
-    for (const auto& field : classInfo.fieldList) {
+    for (size_t i = 0; i < classInfo.fieldList.size(); i++) {
+        const FieldInfo& field = classInfo.fieldList[i];
+        size_t runEnd = findBulkPackingRun(classInfo.fieldList, i);
+        if (runEnd > i) {
+            CC << "    doParsimBulkPacking(b,a." << field.var << ",a." << classInfo.fieldList[runEnd-1].var << ");\n";
+            i = runEnd - 1;
+            continue;
+        }
         if (field.isCustom)
             continue;
         if (field.isArray)
@@ -1062,7 +1150,14 @@ void MsgCodeGenerator::generateStructImpl(const ClassInfo& classInfo)
     CC << "{\n";
     if (!classInfo.baseClass.empty())
         CC << "    doParsimUnpacking(b,(::" << classInfo.baseClass << "&)a);\n";
-    for (const auto& field : classInfo.fieldList) {
+    for (size_t i = 0; i < classInfo.fieldList.size(); i++) {
+        const FieldInfo& field = classInfo.fieldList[i];
+        size_t runEnd = findBulkPackingRun(classInfo.fieldList, i);
+        if (runEnd > i) {
+            CC << "    doParsimBulkUnpacking(b,a." << field.var << ",a." << classInfo.fieldList[runEnd-1].var << ");\n";
+            i = runEnd - 1;
+            continue;
+        }
         if (field.isCustom)
             continue;
         if (field.isArray)
@@ -36,6 +36,7 @@ const char *MsgCompiler::BUILTIN_DEFINITIONS =
         R"ENDMARK(
         @property[property](type=any; usage=file; desc="Property for declaring properties.");
         @property[customize](type=bool; usage=class; desc="If true: Customize the class via inheritance. Generates base class <name>_Base.");
+        @property[pooled](type=bool; usage=class; desc="If true: Allocate instances of the class from a per-class memory pool (cMemoryPool) that recycles the memory of deleted instances. Pooling needs to be enabled at runtime as well.");
         @property[str](type=string; usage=class; desc="Expression to be returned from the generated str() method.");
         @property[primitive](type=bool; usage=field,class; desc="Shortcut for @opaque @byValue @editable @subclassable(false) @supportsPtr(false).");
         @property[opaque](type=bool; usage=field,class; desc="If true: Treat the field as atomic (non-compound) type, i.e. having no descriptor class. When specified on a class, it determines the default for fields of that type.");
@@ -57,6 +58,7 @@ const char *MsgCompiler::BUILTIN_DEFINITIONS =
         @property[beforeChange](type=string; usage=class; desc="Method to be called before mutator code (in setters, non-const getters, operator=, etc.).");
         @property[implements](type=stringlist; usage=class; desc="Names of additional base classes.");
         @property[nopack](type=bool; usage=field; desc="If true: Ignore this field in parsimPack/parsimUnpack methods.");
+        @property[triviallyCopyable](type=bool; usage=field,class; desc="If true: Values of the type can be copied with memcpy(). Consecutive trivially copyable fields and arrays are packed as a single block of raw data in parsimPack/parsimUnpack methods. When specified on a class, it determines the default for fields of that type.");
         @property[editable](type=bool; usage=field,class; desc="Specifies whether field value (or value of fields that are instances of this type) can be set via the class descriptor's setFieldValueFromString() method.");
         @property[replaceable](type=bool; usage=field; desc="If true: Field is a pointer whose value can be set via the class descriptor's setFieldStructValuePointer() method.");
         @property[resizable](type=bool; usage=field; desc="If true: Field is a variable-size array whose size can be set via the class descriptor's setFieldArraySize() method.");
@@ -77,34 +79,34 @@ const char *MsgCompiler::BUILTIN_DEFINITIONS =
         @property[owned](type=bool; usage=field; desc="For pointers and pointer arrays: Whether allocated memory is owned by the object (needs to be duplicated in dup(), and deleted in destructor). If field type is also a cOwnedObject, take()/drop() calls are also generated.");
         @property[custom](type=bool; usage=field; desc="If true: Do not generate any data or code for the field, only add it to the descriptor. Indicates that the field's implementation will be added to the class via targeted cplusplus blocks.");
 
-        class __bool { @actually(bool); @primitive; @fromString(string2bool($)); @toString(bool2string($)); @defaultValue(false); }
-        class __float { @actually(float); @primitive; @fromString(string2double($)); @toString(double2string($)); @defaultValue(0); }
-        class __double { @actually(double); @primitive; @fromString(string2double($)); @toString(double2string($)); @defaultValue(0); }
+        class __bool { @actually(bool); @primitive; @triviallyCopyable; @fromString(string2bool($)); @toString(bool2string($)); @defaultValue(false); }
+        class __float { @actually(float); @primitive; @triviallyCopyable; @fromString(string2double($)); @toString(double2string($)); @defaultValue(0); }
+        class __double { @actually(double); @primitive; @triviallyCopyable; @fromString(string2double($)); @toString(double2string($)); @defaultValue(0); }
         class __string { @actually(string); @primitive; @cppType(omnetpp::opp_string); @argType(const char *); @returnType(const char *); @getterConversion(.c_str()); @fromString(($)); @toString(oppstring2string($)); }
-        class __char { @actually(char); @primitive; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
-        class __short { @actually(short); @primitive; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
-        class __int { @actually(int); @primitive; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
-        class __long { @actually(long); @primitive; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
-        class __uchar { @actually(unsigned char); @primitive; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
-        class __ushort { @actually(unsigned short); @primitive; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
-        class __uint { @actually(unsigned int); @primitive; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
-        class __ulong { @actually(unsigned long); @primitive; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
-        class int8_t { @primitive; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
-        class int16_t { @primitive; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
-        class int32_t { @primitive; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
-        class int64_t { @primitive; @fromString(string2int64($)); @toString(int642string($)); @defaultValue(0); }
-        class uint8_t { @primitive; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
-        class uint16_t { @primitive; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
-        class uint32_t { @primitive; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
-        class uint64_t { @primitive; @fromString(string2uint64($)); @toString(uint642string($)); @defaultValue(0); }
-        class int8 { @primitive; @cppType(int8_t); @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
-        class int16 { @primitive; @cppType(int16_t); @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
-        class int32 { @primitive; @cppType(int32_t); @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
-        class int64 { @primitive; @cppType(int64_t); @fromString(string2int64($)); @toString(int642string($)); @defaultValue(0); }
-        class uint8 { @primitive; @cppType(uint8_t); @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
-        class uint16 { @primitive; @cppType(uint16_t); @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
-        class uint32 { @primitive; @cppType(uint32_t); @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
-        class uint64 { @primitive; @cppType(uint64_t); @fromString(string2uint64($)); @toString(uint642string($)); @defaultValue(0); }
+        class __char { @actually(char); @primitive; @triviallyCopyable; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
+        class __short { @actually(short); @primitive; @triviallyCopyable; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
+        class __int { @actually(int); @primitive; @triviallyCopyable; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
+        class __long { @actually(long); @primitive; @triviallyCopyable; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
+        class __uchar { @actually(unsigned char); @primitive; @triviallyCopyable; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
+        class __ushort { @actually(unsigned short); @primitive; @triviallyCopyable; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
+        class __uint { @actually(unsigned int); @primitive; @triviallyCopyable; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
+        class __ulong { @actually(unsigned long); @primitive; @triviallyCopyable; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
+        class int8_t { @primitive; @triviallyCopyable; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
+        class int16_t { @primitive; @triviallyCopyable; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
+        class int32_t { @primitive; @triviallyCopyable; @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
+        class int64_t { @primitive; @triviallyCopyable; @fromString(string2int64($)); @toString(int642string($)); @defaultValue(0); }
+        class uint8_t { @primitive; @triviallyCopyable; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
+        class uint16_t { @primitive; @triviallyCopyable; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
+        class uint32_t { @primitive; @triviallyCopyable; @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
+        class uint64_t { @primitive; @triviallyCopyable; @fromString(string2uint64($)); @toString(uint642string($)); @defaultValue(0); }
+        class int8 { @primitive; @triviallyCopyable; @cppType(int8_t); @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
+        class int16 { @primitive; @triviallyCopyable; @cppType(int16_t); @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
+        class int32 { @primitive; @triviallyCopyable; @cppType(int32_t); @fromString(string2long($)); @toString(long2string($)); @defaultValue(0); }
+        class int64 { @primitive; @triviallyCopyable; @cppType(int64_t); @fromString(string2int64($)); @toString(int642string($)); @defaultValue(0); }
+        class uint8 { @primitive; @triviallyCopyable; @cppType(uint8_t); @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
+        class uint16 { @primitive; @triviallyCopyable; @cppType(uint16_t); @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
+        class uint32 { @primitive; @triviallyCopyable; @cppType(uint32_t); @fromString(string2ulong($)); @toString(ulong2string($)); @defaultValue(0); }
+        class uint64 { @primitive; @triviallyCopyable; @cppType(uint64_t); @fromString(string2uint64($)); @toString(uint642string($)); @defaultValue(0); }
         )ENDMARK";
 
 extern const char *SIM_STD_DEFINITIONS;  // contents of sim/sim_std.msg, stringified into sim_std_msg.cc
@@ -132,6 +132,7 @@ class NEDXML_API MsgTypeTable
         std::string enumName;   // from @enum
         std::string enumQName;  // fully qualified type name of enum
         bool nopack;            // @nopack(true)
+        bool isTriviallyCopyable = false; // @triviallyCopyable, or inherited from the field type; allows packing the value as raw data
         bool isOpaque;          // @opaque(true), means that field type is treated as atomic (has no fields), i.e. has no descriptor
         bool overrideGetter;    // @overrideGetter|@override, used when field getter function overrides a function in base class
         bool overrideSetter;    // @overrideSetter|@override, used when field setter function overrides a function in base class
@@ -162,6 +163,7 @@ class NEDXML_API MsgTypeTable
         std::string extendsName;       // base type's name from MSG
         bool customize;                // from @customize
         bool omitGetVerb;              // from @omitGetVerb
+        bool pooled = false;           // from @pooled
         bool isClass;                  // true=class, false=struct
         bool iscObject;                // whether type is subclassed from cObject
         bool iscNamedObject;           // whether type is subclassed from cNamedObject
@@ -196,6 +198,7 @@ class NEDXML_API MsgTypeTable
         std::string defaultValue;      // default value (or empty)
         bool isOpaque;                 // from @opaque
         bool byValue;                  // from @byValue, default value is false
+        bool triviallyCopyable = false; // from @triviallyCopyable; values can be copied with memcpy(); true for enums
         bool isEditable;               // from @editable
         std::string dataTypeBase;      // member C++ datatype
         std::string argTypeBase;       // setter C++ argument type
@@ -0,0 +1,416 @@
+//==========================================================================
+// NEDASTCACHE.CC -
+//
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2002-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+#include "omnetpp/platdep/platmisc.h"  // getpid()
+#include "common/fileutil.h"
+#include "common/stringutil.h"
+#include "exception.h"
+#include "nedastcache.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace nedxml {
+
+// Cache file layout (integers in native byte order, as the file is not meant to be portable):
+//   header: magic, format version, tag code count of the NED DTD, number of entries
+//   entries: name length, name, mtime, size, data length, data
+// Data of an entry is a string table followed by the node tree, both using
+// variable-length (LEB128) unsigned integers:
+//   string table: count, then (length, bytes) for each string
+//   node: tag code, source location (string index), source region (4 numbers),
+//         number of attributes, attribute values (string indices), number of children, children
+static const char MAGIC[8] = {'O', 'P', 'P', 'N', 'E', 'D', 'A', 'C'};
+static const uint32_t FORMAT_VERSION = 1;
+
+namespace {
+
+class ParseError {};
+
+class Reader
+{
+  private:
+    const char *p;
+    const char *end;
+    std::vector<std::string> stringStorage;
+    NedAstNodeFactory factory;
+
+  public:
+    Reader(const char *data, size_t length) : p(data), end(data + length) {}
+
+    uint64_t readVarint() {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end)
+                throw ParseError();
+            unsigned char byte = *p++;
+            result |= (uint64_t)(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+                return result;
+        }
+        throw ParseError();
+    }
+
+    int readInt() {
+        uint64_t value = readVarint();
+        if (value > INT32_MAX)
+            throw ParseError();
+        return (int)value;
+    }
+
+    const char *readStringRef() {
+        uint64_t index = readVarint();
+        if (index >= stringStorage.size())
+            throw ParseError();
+        return stringStorage[index].c_str();
+    }
+
+    void readStringTable() {
+        uint64_t count = readVarint();
+        if (count > (uint64_t)(end - p))
+            throw ParseError();
+        stringStorage.reserve(count);
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t length = readVarint();
+            if (length > (uint64_t)(end - p))
+                throw ParseError();
+            stringStorage.emplace_back(p, length);
+            p += length;
+        }
+    }
+
+    ASTNode *readNode() {
+        int tagCode = readInt();
+        ASTNode *node;
+        try {
+            node = factory.createElementWithTag(tagCode);
+        }
+        catch (NedException&) {
+            throw ParseError();
+        }
+        try {
+            node->setSourceLocation(readStringRef());
+            SourceRegion region;
+            region.startLine = readInt();
+            region.startColumn = readInt();
+            region.endLine = readInt();
+            region.endColumn = readInt();
+            node->setSourceRegion(region);
+            int numAttrs = readInt();
+            if (numAttrs != node->getNumAttributes())
+                throw ParseError();
+            for (int i = 0; i < numAttrs; i++)
+                node->setAttribute(i, readStringRef());
+            int numChildren = readInt();
+            for (int i = 0; i < numChildren; i++)
+                node->appendChild(readNode());
+        }
+        catch (...) {
+            delete node;
+            throw;
+        }
+        return node;
+    }
+
+    bool atEnd() const {return p == end;}
+};
+
+class Writer
+{
+  private:
+    std::map<std::string,int> stringIndices;
+    std::vector<const std::string *> strings;
+    std::string nodeData;
+
+    static void writeVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back((char)((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back((char)value);
+    }
+
+    void writeStringRef(const std::string& s) {
+        auto it = stringIndices.find(s);
+        if (it == stringIndices.end()) {
+            it = stringIndices.insert(std::make_pair(s, (int)strings.size())).first;
+            strings.push_back(&it->first);
+        }
+        writeVarint(nodeData, it->second);
+    }
+
+  public:
+    void writeNode(ASTNode *node) {
+        writeVarint(nodeData, node->getTagCode());
+        writeStringRef(node->getSourceLocation());
+        const SourceRegion& region = node->getSourceRegion();
+        writeVarint(nodeData, region.startLine);
+        writeVarint(nodeData, region.startColumn);
+        writeVarint(nodeData, region.endLine);
+        writeVarint(nodeData, region.endColumn);
+        int numAttrs = node->getNumAttributes();
+        writeVarint(nodeData, numAttrs);
+        for (int i = 0; i < numAttrs; i++)
+            writeStringRef(opp_nulltoempty(node->getAttribute(i)));
+        writeVarint(nodeData, node->getNumChildren());
+        for (ASTNode *child = node->getFirstChild(); child; child = child->getNextSibling())
+            writeNode(child);
+    }
+
+    std::string getResult() {
+        std::string result;
+        writeVarint(result, strings.size());
+        for (const std::string *s : strings) {
+            writeVarint(result, s->size());
+            result += *s;
+        }
+        result += nodeData;
+        return result;
+    }
+};
+
+template<typename T>
+bool readRaw(const char *& p, const char *end, T& value)
+{
+    if ((size_t)(end - p) < sizeof(T))
+        return false;
+    memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+template<typename T>
+void writeRaw(FILE *f, const T& value)
+{
+    fwrite(&value, sizeof(T), 1, f);
+}
+
+}  // namespace
+
+NedAstCache::NedAstCache(const char *fileName) : fileName(fileName)
+{
+    readCacheFile();
+    if (mappedData && !parseIndex()) {
+        // unusable (corrupt, or written by a different version): ignore, it will be overwritten
+        entries.clear();
+        unmapCacheFile();
+    }
+}
+
+NedAstCache::~NedAstCache()
+{
+    unmapCacheFile();
+}
+
+void NedAstCache::readCacheFile()
+{
+#ifndef _WIN32
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd == -1)
+        return;  // no cache file yet
+    struct stat statbuf;
+    if (fstat(fd, &statbuf) == 0 && statbuf.st_size > 0) {
+        void *p = mmap(nullptr, statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            mappedData = (const char *)p;
+            mappedSize = statbuf.st_size;
+        }
+    }
+    close(fd);
+#else
+    FILE *f = fopen(fileName.c_str(), "rb");
+    if (!f)
+        return;  // no cache file yet
+    char buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        fileContents.append(buf, n);
+    fclose(f);
+    if (!fileContents.empty()) {
+        mappedData = fileContents.data();
+        mappedSize = fileContents.size();
+    }
+#endif
+}
+
+void NedAstCache::unmapCacheFile()
+{
+#ifndef _WIN32
+    if (mappedData)
+        munmap((void *)mappedData, mappedSize);
+#else
+    fileContents.clear();
+#endif
+    mappedData = nullptr;
+    mappedSize = 0;
+}
+
+bool NedAstCache::parseIndex()
+{
+    const char *p = mappedData;
+    const char *end = mappedData + mappedSize;
+    if (mappedSize < sizeof(MAGIC) || memcmp(p, MAGIC, sizeof(MAGIC)) != 0)
+        return false;
+    p += sizeof(MAGIC);
+    uint32_t version, numTags, numEntries;
+    if (!readRaw(p, end, version) || version != FORMAT_VERSION)
+        return false;
+    if (!readRaw(p, end, numTags) || numTags != NED_UNKNOWN)
+        return false;
+    if (!readRaw(p, end, numEntries))
+        return false;
+    for (uint32_t i = 0; i < numEntries; i++) {
+        uint32_t nameLength;
+        if (!readRaw(p, end, nameLength) || nameLength > (size_t)(end - p))
+            return false;
+        std::string name(p, nameLength);
+        p += nameLength;
+        Entry& entry = entries[name];
+        uint64_t length;
+        if (!readRaw(p, end, entry.mtime) || !readRaw(p, end, entry.size) || !readRaw(p, end, length) || length > (uint64_t)(end - p))
+            return false;
+        entry.data = p;
+        entry.length = length;
+        p += length;
+    }
+    return p == end;
+}
+
+bool NedAstCache::getFileStat(const char *fname, int64_t& mtime, int64_t& size)
+{
+    struct opp_stat_t statbuf;
+    if (opp_stat(fname, &statbuf) != 0)
+        return false;
+#if defined(__linux__)
+    mtime = (int64_t)statbuf.st_mtim.tv_sec * 1000000000 + statbuf.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+    mtime = (int64_t)statbuf.st_mtimespec.tv_sec * 1000000000 + statbuf.st_mtimespec.tv_nsec;
+#else
+    mtime = (int64_t)statbuf.st_mtime * 1000000000;
+#endif
+    size = statbuf.st_size;
+    return true;
+}
+
+NedFileElement *NedAstCache::get(const char *nedFileName, int64_t mtime, int64_t size)
+{
+    auto it = entries.find(nedFileName);
+    if (it == entries.end())
+        return nullptr;
+    Entry& entry = it->second;
+    if (mtime != entry.mtime || size != entry.size)
+        return nullptr;  // file changed since cached
+
+    ASTNode *tree = nullptr;
+    try {
+        Reader reader(entry.data, entry.length);
+        reader.readStringTable();
+        tree = reader.readNode();
+        if (!reader.atEnd() || tree->getTagCode() != NED_NED_FILE) {
+            delete tree;
+            tree = nullptr;
+        }
+    }
+    catch (ParseError&) {
+    }
+    catch (NedException&) {  // e.g. invalid attribute value
+    }
+    if (!tree) {
+        // corrupt entry: drop it
+        entries.erase(it);
+        dirty = true;
+    }
+    return (NedFileElement *)tree;
+}
+
+void NedAstCache::put(const char *nedFileName, NedFileElement *tree, int64_t mtime, int64_t size)
+{
+    Writer writer;
+    writer.writeNode(tree);
+    Entry& entry = entries[nedFileName];
+    entry.mtime = mtime;
+    entry.size = size;
+    entry.ownData = writer.getResult();
+    entry.data = entry.ownData.data();
+    entry.length = entry.ownData.size();
+    dirty = true;
+}
+
+void NedAstCache::save()
+{
+    if (!dirty)
+        return;
+
+    // forget files that have been deleted
+    for (auto it = entries.begin(); it != entries.end(); ) {
+        int64_t mtime, size;
+        if (!getFileStat(it->first.c_str(), mtime, size))
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+
+    // write into a temp file, then rename, so that concurrent readers always see a complete file
+    std::string dir = directoryOf(fileName.c_str());
+    mkPath(dir.c_str());
+    std::string tmpFileName = opp_stringf("%s.%d.tmp", fileName.c_str(), (int)getpid());
+    FILE *f = fopen(tmpFileName.c_str(), "wb");
+    if (!f)
+        throw NedException("Cannot open NED cache file '%s' for write: %s", tmpFileName.c_str(), strerror(errno));
+    fwrite(MAGIC, sizeof(MAGIC), 1, f);
+    writeRaw(f, FORMAT_VERSION);
+    writeRaw(f, (uint32_t)NED_UNKNOWN);
+    writeRaw(f, (uint32_t)entries.size());
+    for (const auto& pair : entries) {
+        const Entry& entry = pair.second;
+        writeRaw(f, (uint32_t)pair.first.size());
+        fwrite(pair.first.data(), 1, pair.first.size(), f);
+        writeRaw(f, entry.mtime);
+        writeRaw(f, entry.size);
+        writeRaw(f, (uint64_t)entry.length);
+        fwrite(entry.data, 1, entry.length, f);
+    }
+    bool ok = !ferror(f);
+    if (fclose(f) != 0)
+        ok = false;
+    if (!ok) {
+        remove(tmpFileName.c_str());
+        throw NedException("Cannot write NED cache file '%s'", tmpFileName.c_str());
+    }
+#ifdef _WIN32
+    remove(fileName.c_str());  // rename() does not overwrite on Windows
+#endif
+    if (rename(tmpFileName.c_str(), fileName.c_str()) != 0) {
+        int err = errno;
+        remove(tmpFileName.c_str());
+        throw NedException("Cannot rename '%s' to '%s': %s", tmpFileName.c_str(), fileName.c_str(), strerror(err));
+    }
+    dirty = false;
+}
+
+} // namespace nedxml
+}  // namespace omnetpp
+
@@ -0,0 +1,128 @@
+//==========================================================================
+// NEDASTCACHE.H -
+//
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2002-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+
+#ifndef __OMNETPP_NEDXML_NEDASTCACHE_H
+#define __OMNETPP_NEDXML_NEDASTCACHE_H
+
+#include <map>
+#include <string>
+#include <cstdint>
+#include "nedelements.h"
+
+namespace omnetpp {
+namespace nedxml {
+
+/**
+ * @brief On-disk cache of parsed NED files, used by NedResourceCache.
+ *
+ * The cache file stores the AST of NED files in a compact binary form,
+ * together with the modification time and size of the source file.
+ * get() returns the AST of a file only if the file has not changed since
+ * it was cached; the caller is expected to parse the file otherwise, and
+ * to add the result via put(). The caller obtains the file's modification
+ * time and size with getFileStat() before parsing, so that changes made to
+ * the file during parsing are detected in the next run. Trees stored in
+ * the cache are assumed to be already validated.
+ *
+ * The cache file is memory-mapped on load, and only the entries actually
+ * asked for are decoded. save() writes the file only if there were changes;
+ * it writes a temporary file first and renames it, so that several
+ * simulation processes may share the same cache file. A corrupt or
+ * incompatible cache file is ignored, and overwritten on the next save().
+ *
+ * @ingroup NedResources
+ */
+class NEDXML_API NedAstCache
+{
+  protected:
+    struct Entry {
+        int64_t mtime = 0;          // modification time of the NED file, in nanoseconds
+        int64_t size = 0;           // size of the NED file
+        const char *data = nullptr; // serialized AST; points into mappedData or into ownData
+        size_t length = 0;
+        std::string ownData;        // storage for entries added via put()
+    };
+
+    std::string fileName;
+    std::map<std::string,Entry> entries;  // key: canonical NED file name
+    bool dirty = false;
+
+    // the cache file, mapped into memory (or read into fileContents where mmap() is not available)
+    const char *mappedData = nullptr;
+    size_t mappedSize = 0;
+    std::string fileContents;
+
+  protected:
+    virtual void readCacheFile();
+    virtual void unmapCacheFile();
+    virtual bool parseIndex();
+
+  public:
+    /**
+     * Constructor. Loads the given cache file if it exists.
+     */
+    NedAstCache(const char *fileName);
+
+    /**
+     * Destructor. Does NOT save the cache; call save() for that.
+     */
+    virtual ~NedAstCache();
+
+    /**
+     * Returns the name of the cache file.
+     */
+    const char *getFileName() const {return fileName.c_str();}
+
+    /**
+     * Returns the number of NED files in the cache.
+     */
+    int getNumEntries() const {return entries.size();}
+
+    /**
+     * Determines the modification time (in nanoseconds) and size of the given
+     * file, as stored in the cache. Returns false if the file cannot be stat'ed.
+     */
+    static bool getFileStat(const char *fname, int64_t& mtime, int64_t& size);
+
+    /**
+     * Returns a newly created AST of the given NED file, or nullptr if the
+     * file is not in the cache or it was cached with a different modification
+     * time or size than the given ones (see getFileStat()). The file name is
+     * expected in canonical form.
+     */
+    virtual NedFileElement *get(const char *nedFileName, int64_t mtime, int64_t size);
+
+    /**
+     * Stores the AST of the given NED file in the cache, with the modification
+     * time and size the file had before it was parsed. The tree is not
+     * retained, it is serialized immediately.
+     */
+    virtual void put(const char *nedFileName, NedFileElement *tree, int64_t mtime, int64_t size);
+
+    /**
+     * Writes the cache file if its contents have changed. Entries of NED files
+     * that no longer exist are dropped. Throws NedException on failure.
+     */
+    virtual void save();
+};
+
+} // namespace nedxml
+}  // namespace omnetpp
+
+
+#endif
+
@@ -32,6 +32,7 @@
 #include "nedsyntaxvalidator.h"
 #include "nedcrossvalidator.h"
 #include "xmlastparser.h"
+#include "nedastcache.h"
 
 using namespace omnetpp::common;
 
@@ -53,6 +54,15 @@ NedResourceCache::~NedResourceCache()
         delete file;
     for (auto & nedType : nedTypes)
         delete nedType.second;
+    delete astCache;
+}
+
+void NedResourceCache::setAstCacheFile(const char *fileName)
+{
+    delete astCache;
+    astCache = nullptr;
+    if (!opp_isempty(fileName))
+        astCache = new NedAstCache(fileName);
 }
 
 void NedResourceCache::registerBuiltinDeclarations()
@@ -162,6 +172,14 @@ void NedResourceCache::doLoadNedFileOrText(const char *nedFilename, const char *
 
 NedFileElement *NedResourceCache::parseAndValidateNedFileOrText(const char *fname, const char *nedText, bool isXML)
 {
+    // files already parsed and validated in a previous run come from the cache;
+    // stat the file before parsing, so that a change during parsing invalidates the entry
+    int64_t mtime = 0, size = 0;
+    bool useAstCache = astCache && !nedText && !isXML && NedAstCache::getFileStat(fname, mtime, size);
+    if (useAstCache)
+        if (NedFileElement *nedFileElement = astCache->get(fname, mtime, size))
+            return nedFileElement;
+
     // load file
     ASTNode *tree = nullptr;
     ErrorStore errors;
@@ -200,6 +218,8 @@ NedFileElement *NedResourceCache::parseAndValidateNedFileOrText(const char *fnam
     NedFileElement *nedFileElement = dynamic_cast<NedFileElement*>(tree);
     if (!nedFileElement)
         throw NedException("<ned-file> expected as root element, in file %s", fname);
+    if (useAstCache)
+        astCache->put(fname, nedFileElement, mtime, size);
     return nedFileElement;
 }
 
@@ -225,6 +245,11 @@ std::string NedResourceCache::getFirstError(ErrorStore *errors, const char *pref
     return message;
 }
 
+void NedResourceCache::printWarning(const char *message)
+{
+    fprintf(stderr, "Warning: %s\n", message);
+}
+
 void NedResourceCache::loadNedFile(const char *nedFilename, const char *expectedPackage, bool isXML)
 {
     if (!nedFilename)
@@ -289,6 +314,19 @@ void NedResourceCache::doneLoadingNedFiles()
         throw NedException("NedResourceCache::doneLoadingNedFiles() may only be called once");
     doneLoadingNedFilesCalled = true;
 
+    // write back newly parsed NED files into the cache; the cache is only an
+    // optimization, so if that fails, continue without it
+    if (astCache) {
+        try {
+            astCache->save();
+        }
+        catch (NedException& e) {
+            printWarning(opp_stringf("Cannot save NED AST cache, continuing without it: %s", e.what()).c_str());
+            delete astCache;
+            astCache = nullptr;
+        }
+    }
+
     // collect package.ned files
     for (NedFileElement *nedFile : nedFiles) {
         const char *fileName = nedFile->getFilename();
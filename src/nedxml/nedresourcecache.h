@@ -28,6 +28,7 @@ namespace omnetpp {
 namespace nedxml {
 
 class ErrorStore;
+class NedAstCache;
 
 /**
  * @brief Context of NED type lookup, for NedResourceCache.
@@ -108,6 +109,9 @@ class NEDXML_API NedResourceCache
     // storage for NED components not resolved yet because of missing dependencies
     std::vector<PendingNedType> pendingList;
 
+    // on-disk cache of parsed NED files (optional)
+    NedAstCache *astCache = nullptr;
+
   protected:
     virtual void addFile(const char *fname, NedFileElement *node);
     virtual void registerBuiltinDeclarations();
@@ -122,6 +126,7 @@ class NEDXML_API NedResourceCache
     virtual void registerPendingNedTypes();
     virtual void registerNedType(const char *qname, bool isInnerType, ASTNode *node);
     virtual std::string getFirstError(ErrorStore *errors, const char *prefix=nullptr);
+    virtual void printWarning(const char *message);
 
   public:
     /** Constructor */
@@ -166,6 +171,19 @@ class NEDXML_API NedResourceCache
      */
     virtual void loadNedText(const char *name, const char *nedtext, const char *expectedPackage, bool isXML);
 
+    /**
+     * Enables caching the parsed form of NED files in the given file. When
+     * a NED file is loaded, its AST is taken from the cache unless the file
+     * has been modified since it was cached, sparing the parsing and
+     * validation of the file. The cache file is updated in
+     * doneLoadingNedFiles() if any NED file had to be parsed. Pass nullptr
+     * or "" to turn caching off.
+     *
+     * This method should be called before the first loadNedSourceFolder()/
+     * loadNedFile() call.
+     */
+    virtual void setAstCacheFile(const char *fileName);
+
     /**
      * To be called after all NED folders / files have been loaded. May be
      * redefined to issue errors for components that could not be fully
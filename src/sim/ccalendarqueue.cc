@@ -0,0 +1,363 @@
+//=========================================================================
+//  CCALENDARQUEUE.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//   Member functions of
+//    cCalendarQueue : future event set, implemented as calendar queue
+//
+//   The algorithm follows R. Brown: Calendar Queues: A Fast O(1) Priority
+//   Queue Implementation for the Simulation Event Set Problem (CACM, 1988).
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <sstream>
+#include "omnetpp/globals.h"
+#include "omnetpp/cevent.h"
+#include "omnetpp/ccalendarqueue.h"
+
+namespace omnetpp {
+
+Register_Class(cCalendarQueue);
+
+#define SAMPLE_SIZE       25   // number of events at the front of the queue to compute bucket width from
+#define COMPACT_LIMIT     32   // compact a bucket if this many slots at its front are unused
+
+static inline bool precedes(cEvent *a, cEvent *b)
+{
+    return a->shouldPrecede(b);
+}
+
+cCalendarQueue::cCalendarQueue(const char *name, int initialBuckets) : cFutureEventSet(name)
+{
+    int n = 2;
+    while (n < initialBuckets)
+        n *= 2;
+    buckets.resize(n);
+    bucketMask = n-1;
+    minBuckets = n;
+    width = 1;  // will be adjusted as soon as events arrive
+    currentSlot = 0;
+    length = 0;
+    needsRewidth = false;
+    insertCount = 0;
+}
+
+cCalendarQueue::cCalendarQueue(const cCalendarQueue& other) : cFutureEventSet(other)
+{
+    length = 0;
+    copy(other);
+}
+
+cCalendarQueue::~cCalendarQueue()
+{
+    clear();
+}
+
+std::string cCalendarQueue::str() const
+{
+    if (isEmpty())
+        return std::string("empty");
+    std::stringstream out;
+    out << "length=" << getLength() << ", buckets=" << getNumBuckets() << ", width=" << getBucketWidth();
+    return out.str();
+}
+
+void cCalendarQueue::forEachChild(cVisitor *v)
+{
+    sort();
+
+    for (int i = 0; i < (int)snapshot.size(); i++)
+        v->visit(snapshot[i]);
+}
+
+void cCalendarQueue::clear()
+{
+    for (Bucket& bucket : buckets) {
+        for (size_t i = bucket.head; i < bucket.items.size(); i++)
+            dropAndDelete(bucket.items[i]);
+        bucket.items.clear();
+        bucket.head = 0;
+    }
+    length = 0;
+    snapshot.clear();
+    invalidateSnapshot();
+}
+
+void cCalendarQueue::copy(const cCalendarQueue& other)
+{
+    buckets.clear();
+    buckets.resize(other.buckets.size());
+    for (int b = 0; b < (int)buckets.size(); b++) {
+        const Bucket& otherBucket = other.buckets[b];
+        for (size_t i = otherBucket.head; i < otherBucket.items.size(); i++) {
+            cEvent *event = otherBucket.items[i]->dup();
+            take(event);
+            event->heapIndex = b;
+            event->insertOrder = otherBucket.items[i]->insertOrder;
+            buckets[b].items.push_back(event);
+        }
+    }
+    bucketMask = other.bucketMask;
+    width = other.width;
+    currentSlot = other.currentSlot;
+    length = other.length;
+    minBuckets = other.minBuckets;
+    needsRewidth = other.needsRewidth;
+    insertCount = other.insertCount;
+    invalidateSnapshot();
+}
+
+cCalendarQueue& cCalendarQueue::operator=(const cCalendarQueue& other)
+{
+    if (this == &other)
+        return *this;
+    cFutureEventSet::operator=(other);
+    clear();
+    copy(other);
+    return *this;
+}
+
+int64_t cCalendarQueue::slotOf(const cEvent *event) const
+{
+    return event->getArrivalTime().raw() / width;
+}
+
+cEvent *cCalendarQueue::get(int k)
+{
+    if (k < 0 || k >= length)
+        return nullptr;
+
+    if (!snapshotValid)
+        buildSnapshot();
+    return snapshot[k];
+}
+
+void cCalendarQueue::sort()
+{
+    buildSnapshot();
+    std::sort(snapshot.begin(), snapshot.end(), precedes);
+}
+
+void cCalendarQueue::buildSnapshot()
+{
+    // collect events in bucket order (also when the FES is empty, so that
+    // no pointers to already removed events remain)
+    snapshot.clear();
+    for (const Bucket& bucket : buckets)
+        snapshot.insert(snapshot.end(), bucket.items.begin() + bucket.head, bucket.items.end());
+    snapshotValid = true;
+}
+
+void cCalendarQueue::insert(cEvent *event)
+{
+    take(event);
+
+    event->insertOrder = insertCount++;
+    bucketInsert(event);
+    length++;
+    invalidateSnapshot();
+
+    if (length > 2 * (int)buckets.size())
+        resize(2 * buckets.size());
+}
+
+void cCalendarQueue::bucketInsert(cEvent *event)
+{
+    int64_t slot = slotOf(event);
+    if (length == 0 || slot < currentSlot)
+        currentSlot = slot;
+
+    int b = bucketOf(slot);
+    Bucket& bucket = buckets[b];
+    std::vector<cEvent *>& items = bucket.items;
+    if (items.size() == bucket.head || !event->shouldPrecede(items.back()))
+        items.push_back(event);  // most common case: goes to the end of its bucket
+    else {
+        auto begin = items.begin() + bucket.head;
+        auto it = std::upper_bound(begin, items.end(), event, precedes);
+        if (it == begin && bucket.head > 0)
+            items[--bucket.head] = event;
+        else
+            items.insert(it, event);
+    }
+    event->heapIndex = b;
+}
+
+int cCalendarQueue::findFirstBucket() const
+{
+    if (length == 0)
+        return -1;
+
+    // look at the buckets one "day" at a time, for at most one "year"
+    int numBuckets = buckets.size();
+    int64_t slot = currentSlot;
+    for (int i = 0; i < numBuckets; i++, slot++) {
+        const Bucket& bucket = buckets[bucketOf(slot)];
+        if (!bucket.isEmpty() && slotOf(bucket.front()) <= slot) {
+            currentSlot = slot;
+            return bucketOf(slot);
+        }
+    }
+
+    // all events are more than a year ahead: fall back to direct search
+    int best = -1;
+    for (int b = 0; b < numBuckets; b++)
+        if (!buckets[b].isEmpty() && (best == -1 || buckets[b].front()->shouldPrecede(buckets[best].front())))
+            best = b;
+    currentSlot = slotOf(buckets[best].front());
+    needsRewidth = true;  // bucket width is likely too small
+    return best;
+}
+
+cEvent *cCalendarQueue::peekFirst() const
+{
+    int b = findFirstBucket();
+    return b == -1 ? nullptr : buckets[b].front();
+}
+
+cEvent *cCalendarQueue::removeFirst()
+{
+    int b = findFirstBucket();
+    if (b == -1)
+        return nullptr;
+
+    Bucket& bucket = buckets[b];
+    cEvent *event = bucket.items[bucket.head++];
+    if (bucket.head == bucket.items.size()) {
+        bucket.items.clear();
+        bucket.head = 0;
+    }
+    else if (bucket.head >= COMPACT_LIMIT && 2 * bucket.head >= bucket.items.size()) {
+        bucket.items.erase(bucket.items.begin(), bucket.items.begin() + bucket.head);
+        bucket.head = 0;
+    }
+    length--;
+    invalidateSnapshot();
+
+    drop(event);
+    event->heapIndex = -1;
+
+    if (length < (int)buckets.size() / 2 && (int)buckets.size() > minBuckets)
+        resize(buckets.size() / 2);
+    else if (needsRewidth && length >= 2)
+        resize(buckets.size());
+    return event;
+}
+
+cEvent *cCalendarQueue::remove(cEvent *event)
+{
+    // make sure it is really in the queue
+    if (event->heapIndex == -1)
+        return nullptr;
+
+    Bucket& bucket = buckets[event->heapIndex];
+    std::vector<cEvent *>& items = bucket.items;
+    auto begin = items.begin() + bucket.head;
+    auto it = std::lower_bound(begin, items.end(), event, precedes);
+    if (it == items.end() || *it != event)
+        it = std::find(begin, items.end(), event);  // event's ordering fields were changed while scheduled
+    ASSERT(it != items.end());  // sanity check
+
+    if (it == begin)
+        bucket.head++;
+    else
+        items.erase(it);
+    if (bucket.head == items.size()) {
+        items.clear();
+        bucket.head = 0;
+    }
+    length--;
+    invalidateSnapshot();
+
+    drop(event);
+    event->heapIndex = -1;
+
+    if (length < (int)buckets.size() / 2 && (int)buckets.size() > minBuckets)
+        resize(buckets.size() / 2);
+    return event;
+}
+
+void cCalendarQueue::putBackFirst(cEvent *event)
+{
+    take(event);
+
+    bucketInsert(event);  // keeps original insertOrder, so it will be first again
+    length++;
+    invalidateSnapshot();
+}
+
+int64_t cCalendarQueue::computeWidth(std::vector<cEvent *>& events) const
+{
+    // bucket width is ~3 times the average separation of events at the front
+    // of the queue, with outliers (separations over twice the average) ignored
+    int m = std::min((int)events.size(), SAMPLE_SIZE);
+    if (m < 2)
+        return width;
+    std::partial_sort(events.begin(), events.begin() + m, events.end(), precedes);
+
+    int64_t span = events[m-1]->getArrivalTime().raw() - events[0]->getArrivalTime().raw();
+    if (span == 0)
+        return width;
+    int64_t averageSeparation = span / (m-1);
+
+    int64_t sum = 0;
+    int count = 0;
+    for (int i = 1; i < m; i++) {
+        int64_t separation = events[i]->getArrivalTime().raw() - events[i-1]->getArrivalTime().raw();
+        if (separation <= 2 * averageSeparation) {
+            sum += separation;
+            count++;
+        }
+    }
+    if (count > 0 && sum > 0)
+        averageSeparation = sum / count;
+
+    if (averageSeparation > INT64_MAX / 3)
+        return INT64_MAX / 3;
+    return std::max(averageSeparation * 3, (int64_t)1);
+}
+
+void cCalendarQueue::resize(int newNumBuckets)
+{
+    // collect all events, and redistribute them among the new buckets
+    std::vector<cEvent *> events;
+    events.reserve(length);
+    for (Bucket& bucket : buckets)
+        events.insert(events.end(), bucket.items.begin() + bucket.head, bucket.items.end());
+
+    width = computeWidth(events);
+    needsRewidth = false;
+
+    buckets.clear();
+    buckets.resize(newNumBuckets);
+    bucketMask = newNumBuckets-1;
+
+    if (events.empty())
+        return;
+    currentSlot = INT64_MAX;
+    for (cEvent *event : events) {
+        int64_t slot = slotOf(event);
+        if (slot < currentSlot)
+            currentSlot = slot;
+        int b = bucketOf(slot);
+        buckets[b].items.push_back(event);
+        event->heapIndex = b;
+    }
+    for (Bucket& bucket : buckets)
+        if (bucket.items.size() > 1)
+            std::sort(bucket.items.begin(), bucket.items.end(), precedes);
+}
+
+}  // namespace omnetpp
+
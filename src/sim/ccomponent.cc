@@ -14,6 +14,9 @@
 *--------------------------------------------------------------*/
 
 #include <algorithm>
+#ifdef WITH_THREADED_PARSIM
+#include <mutex>
+#endif
 #include "common/stringutil.h"
 #include "omnetpp/ccomponent.h"
 #include "omnetpp/ccomponenttype.h"
@@ -43,11 +46,16 @@ namespace omnetpp {
 Register_PerObjectConfigOption(CFGID_PARAM_RECORD_AS_SCALAR, "param-record-as-scalar", KIND_PARAMETER, CFG_BOOL, "false", "Applicable to module parameters: specifies whether the module parameter should be recorded into the output scalar file. Set it for parameters whose value you will need for result analysis.");
 
 cComponent::SignalNameMapping *cComponent::signalNameMapping = nullptr;
+#ifdef WITH_THREADED_PARSIM
+std::atomic<int> cComponent::lastSignalID(-1);
+static std::mutex signalRegistrationMutex;
+#else
 int cComponent::lastSignalID = -1;
+#endif
 
 static const int NOTIFICATION_STACK_SIZE = 64;
-cIListener **cComponent::notificationStack[NOTIFICATION_STACK_SIZE];
-int cComponent::notificationSP = 0;
+OPP_THREAD_LOCAL cIListener **cComponent::notificationStack[NOTIFICATION_STACK_SIZE];
+OPP_THREAD_LOCAL int cComponent::notificationSP = 0;
 
 bool cComponent::checkSignals;
 
@@ -56,13 +64,15 @@ simsignal_t POST_MODEL_CHANGE = cComponent::registerSignal("POST_MODEL_CHANGE");
 
 EXECUTE_ON_SHUTDOWN(cComponent::clearSignalRegistrations());
 
-std::vector<int> cComponent::signalListenerCounts;
+OPP_THREAD_LOCAL std::vector<int> cComponent::signalListenerCounts;
+
+OPP_THREAD_LOCAL uint64_t cComponent::listenerChainVersion = 0;
 
 // Calling registerSignal in static initializers of runtime loaded dynamic
 // libraries would cause an assertion failure without this:
 EXECUTE_ON_STARTUP(cComponent::clearSignalState());
 
-std::vector<cComponent::ResultRecorderList*> cComponent::cachedResultRecorderLists;
+OPP_THREAD_LOCAL std::vector<cComponent::ResultRecorderList*> cComponent::cachedResultRecorderLists;
 
 EXECUTE_ON_SHUTDOWN(cComponent::invalidateCachedResultRecorderLists())
 
@@ -80,6 +90,7 @@ cComponent::cComponent(const char *name) : cDefaultOwner(name)
     displayString = nullptr;
 
     signalTable = nullptr;
+    listenerChainCache = nullptr;
 
     setLogLevel(LOGLEVEL_TRACE);
 }
@@ -93,6 +104,7 @@ cComponent::~cComponent()
     delete[] rngMap;
     delete[] parArray;
     delete displayString;
+    delete listenerChainCache;
 }
 
 void cComponent::forEachChild(cVisitor *v)
@@ -240,6 +252,10 @@ void cComponent::finalizeParameters()
     if (parametersFinalized())
         throw cRuntimeError(this, "finalizeParameters() already called for this module or channel");
 
+#ifdef WITH_THREADED_PARSIM
+    std::lock_guard<std::recursive_mutex> lock(cComponentType::getCreationMutex());
+#endif
+
     // temporarily switch context
     cContextSwitcher tmp(this);
     cContextTypeSwitcher tmp2(CTX_BUILD);
@@ -440,6 +456,9 @@ int cComponent::SignalListenerList::findListener(cIListener *l) const
 
 simsignal_t cComponent::registerSignal(const char *name)
 {
+#ifdef WITH_THREADED_PARSIM
+    std::lock_guard<std::mutex> lock(signalRegistrationMutex);
+#endif
     if (signalNameMapping == nullptr)
         signalNameMapping = new SignalNameMapping;
 
@@ -450,8 +469,12 @@ simsignal_t cComponent::registerSignal(const char *name)
         signalNameMapping->signalNameToID[name] = signalID;
         signalNameMapping->signalIDToName[signalID] = name;
         if (cStaticFlag::insideMain()) { // otherwise signalListenerCount[] may not have been initialized by C++ yet
+#ifdef WITH_THREADED_PARSIM
+            signalListenerCounts.resize(lastSignalID+1);  // other threads' counts are resized on demand
+#else
             signalListenerCounts.push_back(0);
             ASSERT((int)signalListenerCounts.size() == lastSignalID+1);
+#endif
         }
         return signalID;
     }
@@ -462,6 +485,9 @@ simsignal_t cComponent::registerSignal(const char *name)
 
 const char *cComponent::getSignalName(simsignal_t signalID)
 {
+#ifdef WITH_THREADED_PARSIM
+    std::lock_guard<std::mutex> lock(signalRegistrationMutex);
+#endif
     if (!signalNameMapping)
         return nullptr;
     std::map<simsignal_t,std::string>::iterator it = signalNameMapping->signalIDToName.find(signalID);
@@ -479,6 +505,8 @@ void cComponent::clearSignalState()
 
     // clear notification stack
     notificationSP = 0;
+
+    invalidateListenerChains();
 }
 
 void cComponent::clearSignalRegistrations()
@@ -634,33 +662,86 @@ void cComponent::emit(simsignal_t signalID, cObject *obj, cObject *details)
         fire(this, signalID, obj, details);
 }
 
+const cComponent::ListenerChain& cComponent::getListenerChain(simsignal_t signalID)
+{
+    if (!listenerChainCache)
+        listenerChainCache = new ListenerChainCache;
+    else if (listenerChainCache->version != listenerChainVersion)
+        listenerChainCache->chains.clear();
+    listenerChainCache->version = listenerChainVersion;
+
+    std::vector<ListenerChain>& chains = listenerChainCache->chains;
+    for (auto& chain : chains)
+        if (chain.signalID == signalID)
+            return chain;
+
+    // not found, collect the listener lists from this component upwards
+    chains.push_back(ListenerChain());
+    ListenerChain& chain = chains.back();
+    chain.signalID = signalID;
+    for (cComponent *component = this; component; component = component->getParentModule()) {
+        SignalListenerList *listenerList = component->findListenerList(signalID);
+        if (listenerList && listenerList->hasListener())
+            chain.levels.push_back(ListenerChain::Level {component, listenerList->listeners});
+    }
+    return chain;
+}
+
 template<typename T>
 void cComponent::fire(cComponent *source, simsignal_t signalID, T x, cObject *details)
 {
-    // notify local listeners if there are any
-    SignalListenerList *listenerList = findListenerList(signalID);
-    if (listenerList) {
-        cIListener **listeners = listenerList->listeners;
-        if (notificationSP >= NOTIFICATION_STACK_SIZE)
-            throw cRuntimeError(this, "emit(): Recursive notification stack overflow, signalID=%d", signalID);
-
-        int oldNotificationSP = notificationSP;
-        try {
-            notificationStack[notificationSP++] = listeners;  // lock against modification
-            for (int i = 0; listeners[i]; i++)
-                listeners[i]->receiveSignal(source, signalID, x, details);  // will crash if listener is already deleted
-            notificationSP--;
-        }
-        catch (std::exception& e) {
-            notificationSP = oldNotificationSP;
-            throw;
+    // Note: the chain may be invalidated by the listeners (by subscribing or
+    // unsubscribing listeners, or moving modules), which is detected by checking
+    // listenerChainVersion. Also, the chain object itself may be moved if further
+    // chains are added to the cache, but its array of levels is not.
+    const ListenerChain& chain = getListenerChain(signalID);
+    const ListenerChain::Level *levels = chain.levels.data();
+    int numLevels = chain.levels.size();
+    uint64_t version = listenerChainVersion;
+    for (int k = 0; k < numLevels; k++) {
+        cComponent *component = levels[k].component;
+        component->notifyListeners(levels[k].listeners, source, signalID, x, details);
+        if (listenerChainVersion != version) {
+            // chain is no longer valid, notify the remaining ancestors the slow way
+            cModule *parent = component->getParentModule();
+            if (parent)
+                parent->fireUncached(source, signalID, x, details);
+            return;
         }
     }
+}
+
+template<typename T>
+void cComponent::fireUncached(cComponent *source, simsignal_t signalID, T x, cObject *details)
+{
+    // notify local listeners if there are any
+    SignalListenerList *listenerList = findListenerList(signalID);
+    if (listenerList)
+        notifyListeners(listenerList->listeners, source, signalID, x, details);
 
     // notify ancestors recursively
     cModule *parent = getParentModule();
     if (parent)
-        parent->fire(source, signalID, x, details);
+        parent->fireUncached(source, signalID, x, details);
+}
+
+template<typename T>
+void cComponent::notifyListeners(cIListener **listeners, cComponent *source, simsignal_t signalID, T x, cObject *details)
+{
+    if (notificationSP >= NOTIFICATION_STACK_SIZE)
+        throw cRuntimeError(this, "emit(): Recursive notification stack overflow, signalID=%d", signalID);
+
+    int oldNotificationSP = notificationSP;
+    try {
+        notificationStack[notificationSP++] = listeners;  // lock against modification
+        for (int i = 0; listeners[i]; i++)
+            listeners[i]->receiveSignal(source, signalID, x, details);  // will crash if listener is already deleted
+        notificationSP--;
+    }
+    catch (std::exception& e) {
+        notificationSP = oldNotificationSP;
+        throw;
+    }
 }
 
 void cComponent::fireFinish()
@@ -684,6 +765,11 @@ void cComponent::subscribe(simsignal_t signalID, cIListener *listener)
     checkNotFiring(signalID, listenerList->listeners);
     if (!listenerList->addListener(listener))
         throw cRuntimeError(this, "subscribe(): Listener already subscribed at this component to signal '%s' (id=%d)", getSignalName(signalID), signalID);
+    invalidateListenerChains();
+#ifdef WITH_THREADED_PARSIM
+    if (signalID >= (int)signalListenerCounts.size())
+        signalListenerCounts.resize(signalID+1);
+#endif
     signalListenerCounts[signalID]++;
     listener->subscribeCount++;
     listener->subscribedTo(this, signalID);
@@ -702,6 +788,7 @@ void cComponent::unsubscribe(simsignal_t signalID, cIListener *listener)
     checkNotFiring(signalID, listenerList->listeners);
     if (!listenerList->removeListener(listener))
         return;  // was already removed
+    invalidateListenerChains();
 
     if (!listenerList->hasListener())
         removeListenerList(signalID);
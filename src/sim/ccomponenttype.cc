@@ -105,6 +105,14 @@ cComponentType *cComponentType::get(const char *qname)
     return componentType;
 }
 
+#ifdef WITH_THREADED_PARSIM
+std::recursive_mutex& cComponentType::getCreationMutex()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+#endif
+
 cParImpl *cComponentType::getSharedParImpl(const char *key) const
 {
     StringToParMap::const_iterator it = sharedParMap.find(key);
@@ -149,6 +157,9 @@ bool cComponentType::isAvailable()
 
 void cComponentType::checkSignal(simsignal_t signalID, SimsignalType type, cObject *obj)
 {
+#ifdef WITH_THREADED_PARSIM
+    std::lock_guard<std::recursive_mutex> lock(getCreationMutex());
+#endif
     // check that this signal is allowed
     std::map<simsignal_t, SignalDesc>::const_iterator it = signalsSeen.find(signalID);
     if (it == signalsSeen.end()) {
@@ -279,6 +290,10 @@ cModule *cModuleType::create(const char *moduleName, cModule *parentModule)
 
 cModule *cModuleType::create(const char *moduleName, cModule *parentModule, int vectorSize, int index)
 {
+#ifdef WITH_THREADED_PARSIM
+    std::lock_guard<std::recursive_mutex> lock(getCreationMutex());
+#endif
+
     // notify pre-change listeners
     if (parentModule && parentModule->hasListeners(PRE_MODEL_CHANGE)) {
         cPreModuleAddNotification tmp;
@@ -346,6 +361,12 @@ cModule *cModuleType::create(const char *moduleName, cModule *parentModule, int
     // note: setupGateVectors() will be called from finalizeParameters()
     addParametersAndGatesTo(module);
 
+    // the gates of the first module of this type make up the gate name table
+    // (with threaded partitions, it is built under the creation lock, before any
+    // other module of this type exists, and it is read-only afterwards)
+    if (!gateDescIndicesBuilt)
+        buildGateDescIndices(module);
+
     // initialize canvas
     if (cCanvas::containsCanvasItems(module->getProperties()))
         module->getCanvas()->addFiguresFrom(module->getProperties());
@@ -364,6 +385,28 @@ cModule *cModuleType::create(const char *moduleName, cModule *parentModule, int
     return module;
 }
 
+void cModuleType::buildGateDescIndices(cModule *module)
+{
+    std::vector<int> descIndices;
+    for (int i = 0; i < module->gateDescArraySize; i++) {
+        const cGate::Desc *desc = module->gateDescArray + i;
+        if (desc->name) {
+            gateDescNames.push_back(desc->name->name.c_str());
+            descIndices.push_back(i);
+            if (desc->name->type == cGate::INOUT) {
+                gateDescNames.push_back(desc->name->namei.c_str());
+                gateDescNames.push_back(desc->name->nameo.c_str());
+                descIndices.push_back(i);
+                descIndices.push_back(i);
+            }
+        }
+    }
+    // note: gateDescNames must not change from here on, as the keys point into it
+    for (size_t k = 0; k < gateDescNames.size(); k++)
+        gateDescIndices.insert(std::make_pair(gateDescNames[k].c_str(), descIndices[k]));
+    gateDescIndicesBuilt = true;
+}
+
 cModule *cModuleType::instantiateModuleClass(const char *className)
 {
     cObject *obj = cObjectFactory::createOne(className);
@@ -430,6 +473,9 @@ cChannel *cChannelType::instantiateChannelClass(const char *className)
 
 cChannel *cChannelType::create(const char *name)
 {
+#ifdef WITH_THREADED_PARSIM
+    std::lock_guard<std::recursive_mutex> lock(getCreationMutex());
+#endif
     cContextTypeSwitcher tmp(CTX_BUILD);
 
     // Object members of the new channel class are collected to tmplist.
@@ -54,7 +54,7 @@ cContextSwitcher::~cContextSwitcher()
 
 static va_list dummy_va;
 
-int cMethodCallContextSwitcher::depth = 0;
+OPP_THREAD_LOCAL int cMethodCallContextSwitcher::depth = 0;
 
 cMethodCallContextSwitcher::cMethodCallContextSwitcher(const cComponent *newContext) :
     cContextSwitcher(newContext)
@@ -27,13 +27,16 @@
 
 #ifdef USE_PORTABLE_COROUTINES
 #include "task.h"  // Stig Kofoed's "Portable Multitasking" coroutine library
+#ifdef WITH_THREADED_PARSIM
+#error "WITH_THREADED_PARSIM requires Win32 fibers or POSIX coroutines (the portable coroutine library is not thread-safe)"
+#endif
 #endif
 
 namespace omnetpp {
 
 #ifdef USE_WIN32_FIBERS
 
-LPVOID cCoroutine::lpMainFiber;
+OPP_THREAD_LOCAL LPVOID cCoroutine::lpMainFiber;
 
 void cCoroutine::init(unsigned totalStack, unsigned mainStack)
 {
@@ -101,10 +104,10 @@ unsigned cCoroutine::getStackUsage() const
 
 #ifdef USE_POSIX_COROUTINES
 
-ucontext_t cCoroutine::mainContext;
-ucontext_t *cCoroutine::curContextPtr;
-unsigned cCoroutine::totalStackUsage;
-unsigned cCoroutine::totalStackLimit;
+OPP_THREAD_LOCAL ucontext_t cCoroutine::mainContext;
+OPP_THREAD_LOCAL ucontext_t *cCoroutine::curContextPtr;
+OPP_THREAD_LOCAL unsigned cCoroutine::totalStackUsage;
+OPP_THREAD_LOCAL unsigned cCoroutine::totalStackLimit;
 
 void cCoroutine::init(unsigned totalStack, unsigned mainStack)
 {
@@ -41,15 +41,17 @@ cDefaultOwner::cDefaultOwner(const char *name) : cNoncopyableOwnedObject(name)
 {
     // careful: if we are a global variable (ctor called before main()),
     // then insert() may get called before constructor and it invoked
-    // construct() already.
-    if (cStaticFlag::insideMain() || capacity == 0)
+    // construct() already. (With WITH_THREADED_PARSIM, defaultList is
+    // thread-local, and gets constructed inside main() for each thread.)
+    bool isGlobal = !cStaticFlag::insideMain() || this == &defaultList;
+    if (!isGlobal || capacity == 0)
         construct();
 
     // if we're invoked before main, then we are a global variable (dynamic
     // instances of cDefaultOwner are not supposed to be created
     // before main()) --> remove ourselves from ownership tree because
     // we shouldn't be destroyed via operator delete
-    if (!cStaticFlag::insideMain())
+    if (isGlobal)
         removeFromOwnershipTree();
 }
 
@@ -21,6 +21,7 @@
 #include "omnetpp/globals.h"
 #include "omnetpp/cevent.h"
 #include "omnetpp/csimulation.h"
+#include "omnetpp/cfutureeventset.h"
 #include "omnetpp/cexception.h"
 #include "omnetpp/cenvir.h"
 
@@ -52,6 +53,12 @@ cEvent::cEvent(const char *name) : cOwnedObject(name, false)
 
 cEvent::~cEvent()
 {
+    if (flags & FL_ISTRACKED) {
+        cSimulation *sim = getSimulation();
+        cIFutureEventSetListener *listener = sim ? sim->getFESListener() : nullptr;
+        if (listener)
+            listener->trackedEventDeleted(this);
+    }
 }
 
 std::string cEvent::str() const
@@ -5,7 +5,7 @@
 //           Discrete System Simulation in C++
 //
 //   Member functions of
-//    cEventHeap : future event set, implemented as heap
+//    cEventHeap : future event set, implemented as 4-ary heap
 //
 //  Author: Andras Varga, based on the code from Gabor Lencse
 //          (the original is taken from G. H. Gonnet's book pp. 273-274)
@@ -23,6 +23,8 @@
 #include <cstdio>           // sprintf
 #include <cstring>          // strlen
 #include <cstdlib>          // qsort
+#include <cstdint>          // uintptr_t
+#include <algorithm>        // std::min
 #include <sstream>
 #include "omnetpp/globals.h"
 #include "omnetpp/cmessage.h"
@@ -36,15 +38,8 @@ Register_Class(cEventHeap);
 #define CBINC(i)          ((i) = ((i)+1)&(cbsize-1))
 #define CBDEC(i)          ((i) = ((i)-1)&(cbsize-1))
 
-inline bool operator>(cEvent& a, cEvent& b)
-{
-    return b.shouldPrecede(&a);
-}
-
-inline bool operator<=(cEvent& a, cEvent& b)
-{
-    return !(a > b);
-}
+#define CACHELINE_SIZE    64
+#define MAX_INSERTORDER   ((eventnumber_t)1 << 48)  // must fit into the lower 48 bits of Key::priorityAndOrder
 
 static int qsort_cmp_msgs(const void *p1, const void *p2)
 {
@@ -60,8 +55,9 @@ cEventHeap::cEventHeap(const char *name, int intialCapacity) : cFutureEventSet(n
     insertCount = 0;
 
     heapLength = 0;
-    heapCapacity = intialCapacity;
-    heap = new cEvent *[heapCapacity+1];  // +1 is necessary because h[0] is not used
+    keyBuffer = nullptr;
+    heap = nullptr;
+    allocateHeap(intialCapacity);
 
     cbsize = 4;  // must be power of 2!
     cb = new cEvent *[cbsize];
@@ -72,6 +68,7 @@ cEventHeap::cEventHeap(const char *name, int intialCapacity) : cFutureEventSet(n
 cEventHeap::cEventHeap(const cEventHeap& other) : cFutureEventSet(other)
 {
     cb = nullptr;
+    keyBuffer = nullptr;
     heap = nullptr;
     heapLength = 0;
     copy(other);
@@ -80,6 +77,7 @@ cEventHeap::cEventHeap(const cEventHeap& other) : cFutureEventSet(other)
 cEventHeap::~cEventHeap()
 {
     clear();
+    delete[] keyBuffer;
     delete[] heap;
     delete[] cb;
 }
@@ -119,12 +117,15 @@ void cEventHeap::clear()
 void cEventHeap::copy(const cEventHeap& other)
 {
     // copy heap
+    insertCount = other.insertCount;
+    allocateHeap(other.heapCapacity);
     heapLength = other.heapLength;
-    heapCapacity = other.heapCapacity;
-    delete[] heap;
-    heap = new cEvent *[heapCapacity+1];
-    for (int i = 1; i <= heapLength; i++)
+    for (int i = 1; i <= heapLength; i++) {
+        keys[i] = other.keys[i];
         take(heap[i] = other.heap[i]->dup());
+        heap[i]->heapIndex = i;
+        heap[i]->insertOrder = other.heap[i]->insertOrder;
+    }
 
     // copy circular buffer
     cbhead = other.cbhead;
@@ -133,8 +134,11 @@ void cEventHeap::copy(const cEventHeap& other)
     useCb = other.useCb;
     delete[] cb;
     cb = new cEvent *[cbsize];
-    for (int i = cbhead; i != cbtail; CBINC(i))
+    for (int i = cbhead; i != cbtail; CBINC(i)) {
         take(cb[i] = other.cb[i]->dup());
+        cb[i]->heapIndex = CBHEAPINDEX(i);
+        cb[i]->insertOrder = other.cb[i]->insertOrder;
+    }
 }
 
 cEventHeap& cEventHeap::operator=(const cEventHeap& other)
@@ -147,6 +151,43 @@ cEventHeap& cEventHeap::operator=(const cEventHeap& other)
     return *this;
 }
 
+void cEventHeap::allocateHeap(int capacity)
+{
+    // keys[i] is placed at offset i+2 from a cache line boundary, so that
+    // the keys of children 4i-2..4i+1 start at a cache line boundary
+    delete[] keyBuffer;
+    delete[] heap;
+    heapCapacity = capacity;
+    keyBuffer = new char[(heapCapacity+3) * sizeof(Key) + CACHELINE_SIZE];
+    uintptr_t alignedAddress = ((uintptr_t)keyBuffer + CACHELINE_SIZE-1) & ~(uintptr_t)(CACHELINE_SIZE-1);
+    keys = (Key *)alignedAddress + 2;
+    heap = new cEvent *[heapCapacity+1];  // +1 is necessary because heap[0] is not used
+}
+
+void cEventHeap::growHeap()
+{
+    char *oldKeyBuffer = keyBuffer;
+    Key *oldKeys = keys;
+    cEvent **oldHeap = heap;
+    keyBuffer = nullptr;
+    heap = nullptr;
+    allocateHeap(2 * heapCapacity);
+    for (int i = 1; i <= heapLength; i++) {
+        keys[i] = oldKeys[i];
+        heap[i] = oldHeap[i];
+    }
+    delete[] oldKeyBuffer;
+    delete[] oldHeap;
+}
+
+cEventHeap::Key cEventHeap::makeKey(const cEvent *event)
+{
+    Key key;
+    key.time = event->getArrivalTime().raw();
+    key.priorityAndOrder = ((uint64_t)(uint16_t)(event->getSchedulingPriority() + 32768) << 48) | (uint64_t)event->getInsertOrder();
+    return key;
+}
+
 cEvent *cEventHeap::get(int k)
 {
     if (k < 0)
@@ -166,15 +207,20 @@ cEvent *cEventHeap::get(int k)
 
 void cEventHeap::sort()
 {
+    // note: a sorted array also satisfies the heap property
     qsort(heap+1, heapLength, sizeof(cEvent *), qsort_cmp_msgs);
-    for (int i = 1; i <= heapLength; i++)
+    for (int i = 1; i <= heapLength; i++) {
+        keys[i] = makeKey(heap[i]);
         heap[i]->heapIndex = i;
+    }
 }
 
 void cEventHeap::insert(cEvent *event)
 {
     take(event);
 
+    if (insertCount == MAX_INSERTORDER)
+        throw cRuntimeError(this, "Too many insertions into the FES");
     event->insertOrder = insertCount++;
 
     if (!useCb) {
@@ -188,7 +234,7 @@ void cEventHeap::insert(cEvent *event)
     if (event->getArrivalTime() == now) {
         ASSERT(cbhead == cbtail || cb[cbhead]->getArrivalTime() == now); // causality violation
         if (event->getSchedulingPriority() == 0) {
-            if (heapLength == 0 || heap[1]->getArrivalTime() > now)
+            if (heapLength == 0 || keys[1].time > now.raw())
                 eligible = true;
         }
         else if (event->getSchedulingPriority() < 0)
@@ -212,23 +258,43 @@ void cEventHeap::cbInsert(cEvent *event)
 
 void cEventHeap::heapInsert(cEvent *event)
 {
-    if (++heapLength > heapCapacity) {
-        heapCapacity *= 2;
-        cEvent **newHeap = new cEvent *[heapCapacity+1];
-        for (int i = 1; i <= heapLength-1; i++)
-            newHeap[i] = heap[i];
-        delete[] heap;
-        heap = newHeap;
+    if (heapLength == heapCapacity)
+        growHeap();
+    siftUp(++heapLength, makeKey(event), event);
+}
+
+void cEventHeap::siftUp(int i, const Key& key, cEvent *event)
+{
+    // moves the hole at node i up until key can be placed into it
+    int parent;
+    while (i > 1 && less(key, keys[parent = parentOf(i)])) {
+        keys[i] = keys[parent];
+        (heap[i] = heap[parent])->heapIndex = i;
+        i = parent;
     }
+    keys[i] = key;
+    (heap[i] = event)->heapIndex = i;
+}
 
-    int i, j;
-    for (j = heapLength; j > 1; j = i) {
-        i = j>>1;
-        if (*heap[i] <= *event)  // direction
+void cEventHeap::siftDown(int i, const Key& key, cEvent *event)
+{
+    // moves the hole at node i down until key can be placed into it
+    int child;
+    while ((child = firstChildOf(i)) <= heapLength) {
+        // find the smallest child
+        int last = std::min(child + 3, heapLength);
+        int smallest = child;
+        for (int j = child + 1; j <= last; j++)
+            if (less(keys[j], keys[smallest]))
+                smallest = j;
+        if (!less(keys[smallest], key))
             break;
-        (heap[j] = heap[i])->heapIndex = j;
+        keys[i] = keys[smallest];
+        (heap[i] = heap[smallest])->heapIndex = i;
+        i = smallest;
     }
-    (heap[j] = event)->heapIndex = j;
+    keys[i] = key;
+    (heap[i] = event)->heapIndex = i;
 }
 
 void cEventHeap::cbgrow()
@@ -252,27 +318,6 @@ void cEventHeap::flushCb()
     cbtail = cbhead;
 }
 
-void cEventHeap::shiftup(int from)
-{
-    // restores heap structure (in a sub-heap)
-    int i, j;
-    cEvent *temp;
-
-    i = from;
-    while ((j = i<<1) <= heapLength) {
-        if (j < heapLength && (*heap[j] > *heap[j+1]))  // direction
-            j++;
-        if (*heap[i] > *heap[j]) {  // is change necessary?
-            temp = heap[j];
-            (heap[j] = heap[i])->heapIndex = j;
-            (heap[i] = temp)->heapIndex = i;
-            i = j;
-        }
-        else
-            break;
-    }
-}
-
 cEvent *cEventHeap::peekFirst() const
 {
     return cbhead != cbtail ? cb[cbhead] : heapLength != 0 ? heap[1] : nullptr;
@@ -291,8 +336,11 @@ cEvent *cEventHeap::removeFirst()
     else if (heapLength > 0) {
         // heap: first is taken out and replaced by the last one
         cEvent *event = heap[1];
-        (heap[1] = heap[heapLength--])->heapIndex = 1;
-        shiftup();
+        int last = heapLength--;
+        if (heapLength > 0) {
+            Key fillKey = keys[last];
+            siftDown(1, fillKey, heap[last]);
+        }
         drop(event);
         event->heapIndex = -1;
         return event;
@@ -322,17 +370,19 @@ cEvent *cEventHeap::remove(cEvent *event)
         // event is on the heap
 
         // sanity check:
-        // ASSERT(h[event->heapindex]==event);
+        // ASSERT(heap[event->heapIndex]==event);
 
         // last element will be used to fill the hole
-        int father, out = event->heapIndex;
-        cEvent *fill = heap[heapLength--];
-        while ((father = out>>1) != 0 && *heap[father] > *fill) {
-            (heap[out] = heap[father])->heapIndex = out;  // father is moved down
-            out = father;
+        int out = event->heapIndex;
+        int last = heapLength--;
+        if (out != last) {
+            Key fillKey = keys[last];
+            cEvent *fill = heap[last];
+            if (out > 1 && less(fillKey, keys[parentOf(out)]))
+                siftUp(out, fillKey, fill);
+            else
+                siftDown(out, fillKey, fill);
         }
-        (heap[out] = fill)->heapIndex = out;
-        shiftup(out);
     }
 
     drop(event);
@@ -340,6 +390,33 @@ cEvent *cEventHeap::remove(cEvent *event)
     return event;
 }
 
+void cEventHeap::reschedule(cEvent *event, simtime_t t)
+{
+    if (event->heapIndex < 1) {
+        // event is in the circular buffer (or not in the FES at all)
+        cFutureEventSet::reschedule(event, t);
+        return;
+    }
+
+    // move it within the heap; it is all right for the event to stay in the
+    // heap even if it would qualify for the circular buffer, because its new
+    // insertion order is larger than that of any event in cb
+    if (insertCount == MAX_INSERTORDER)
+        throw cRuntimeError(this, "Too many insertions into the FES");
+    event->setArrivalTime(t);
+    event->insertOrder = insertCount++;
+    Key key = makeKey(event);
+    int i = event->heapIndex;
+    if (i > 1 && less(key, keys[parentOf(i)]))
+        siftUp(i, key, event);
+    else
+        siftDown(i, key, event);
+
+    // like in insert(): events in cb must not be preceded by events in the heap
+    if (cbhead != cbtail && event->getSchedulingPriority() < 0 && t == cb[cbhead]->getArrivalTime())
+        flushCb();
+}
+
 void cEventHeap::putBackFirst(cEvent *event)
 {
     take(event);
@@ -0,0 +1,252 @@
+//=========================================================================
+//  CEVENTPROFILER.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstring>
+#include <algorithm>
+#include <map>
+#include "common/jsonwriter.h"
+#include "common/fileutil.h"
+#include "omnetpp/ceventprofiler.h"
+#include "omnetpp/cnetworkpartitioner.h"
+#include "omnetpp/cmodule.h"
+#include "omnetpp/ccomponenttype.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/simutil.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+
+static const cEventProfiler::Stats ZERO_STATS;
+
+static void add(cEventProfiler::Stats& sum, const cEventProfiler::Stats& stats)
+{
+    sum.numEvents += stats.numEvents;
+    sum.numFesInserts += stats.numFesInserts;
+    sum.nanosecs += stats.nanosecs;
+}
+
+static void writeStats(JsonWriter& writer, const cEventProfiler::Stats& stats)
+{
+    writer.writeInt("numEvents", stats.numEvents);
+    writer.writeInt("numFesInserts", stats.numFesInserts);
+    writer.writeDouble("time", stats.nanosecs * 1e-9);
+}
+
+template<typename T>
+static void sortByTime(std::vector<std::pair<T, cEventProfiler::Stats>>& items)
+{
+    std::stable_sort(items.begin(), items.end(), [](const std::pair<T, cEventProfiler::Stats>& a, const std::pair<T, cEventProfiler::Stats>& b) {
+        return a.second.nanosecs > b.second.nanosecs;
+    });
+}
+
+cEventProfiler::cEventProfiler(const char *reportFile, bool recordScalars) :
+    reportFile(reportFile ? reportFile : ""), scalarRecording(recordScalars)
+{
+}
+
+void cEventProfiler::growModuleStats(int id)
+{
+    moduleStats.resize(std::max((size_t)id + 1, 2 * moduleStats.size()));
+}
+
+void cEventProfiler::moduleStarting(int moduleId, cModule *module)
+{
+    if (moduleId >= (int)moduleTypes.size())
+        moduleTypes.resize(std::max((size_t)moduleId + 1, 2 * moduleTypes.size()), nullptr);
+    moduleTypes[moduleId] = module->getModuleType();
+}
+
+const cEventProfiler::Stats& cEventProfiler::getStatsForModule(int moduleId) const
+{
+    return moduleId >= 0 && moduleId < (int)moduleStats.size() ? moduleStats[moduleId] : ZERO_STATS;
+}
+
+cEventProfiler::Stats cEventProfiler::getStatsForType(cModuleType *type) const
+{
+    Stats sum;
+    for (int id = 0; id < (int)moduleTypes.size() && id < (int)moduleStats.size(); id++)
+        if (moduleTypes[id] == type)
+            add(sum, moduleStats[id]);
+    return sum;
+}
+
+cEventProfiler::Stats cEventProfiler::getStatsForClass(const char *className) const
+{
+    // the same class may have several type_info objects (e.g. one per shared library)
+    Stats sum;
+    for (const auto& entry : classStats)
+        if (strcmp(opp_typename(*entry.first), className) == 0)
+            add(sum, entry.second);
+    return sum;
+}
+
+int64_t cEventProfiler::getNumMessages(int senderModuleId, int arrivalModuleId) const
+{
+    auto it = trafficStats.find(((uint64_t)senderModuleId << 32) | (uint32_t)arrivalModuleId);
+    return it == trafficStats.end() ? 0 : it->second;
+}
+
+std::vector<cEventProfiler::Traffic> cEventProfiler::getTraffic() const
+{
+    std::vector<Traffic> result;
+    result.reserve(trafficStats.size());
+    for (const auto& entry : trafficStats)
+        result.push_back(Traffic {(int)(entry.first >> 32), (int)(uint32_t)entry.first, entry.second});
+    std::sort(result.begin(), result.end(), [](const Traffic& a, const Traffic& b) {
+        return a.senderModuleId < b.senderModuleId || (a.senderModuleId == b.senderModuleId && a.arrivalModuleId < b.arrivalModuleId);
+    });
+    return result;
+}
+
+void cEventProfiler::setPartitioning(int numPartitions, const char *fileName, double maxImbalance)
+{
+    if (numPartitions < 0)
+        throw cRuntimeError("cEventProfiler: Invalid number of partitions %d", numPartitions);
+    if (numPartitions > 0 && (!fileName || !*fileName))
+        throw cRuntimeError("cEventProfiler: No file name given for the partitioning");
+    this->numPartitions = numPartitions;
+    partitionsFile = fileName ? fileName : "";
+    this->maxImbalance = maxImbalance;
+}
+
+void cEventProfiler::clear()
+{
+    moduleStats.clear();
+    moduleTypes.clear();
+    classStats.clear();
+    lastClass = nullptr;
+    lastClassStats = nullptr;
+    otherStats = Stats();
+    trafficStats.clear();
+}
+
+void cEventProfiler::recordScalars()
+{
+    cSimulation *simulation = getSimulation();
+    for (int id = 0; id < (int)moduleStats.size(); id++) {
+        const Stats& stats = moduleStats[id];
+        if (stats.numEvents == 0 && stats.numFesInserts == 0)
+            continue;
+        cModule *module = simulation->getModule(id);
+        if (module) {
+            module->recordScalar("eventProfile:numEvents", stats.numEvents);
+            module->recordScalar("eventProfile:numFesInserts", stats.numFesInserts);
+            module->recordScalar("eventProfile:time", stats.nanosecs * 1e-9, "s");
+        }
+    }
+}
+
+void cEventProfiler::writeJsonReport(const char *fileName)
+{
+    cSimulation *simulation = getSimulation();
+
+    // note: the type of a module is only remembered when it processes an
+    // event, otherwise it is looked up from the (still existing) module
+    std::vector<std::pair<cModule *, Stats>> modules;
+    std::map<cModuleType *, std::pair<int, Stats>> types;  // type -> (numModules, stats)
+    Stats total = otherStats;
+    for (int id = 0; id < (int)moduleStats.size(); id++) {
+        const Stats& stats = moduleStats[id];
+        if (stats.numEvents == 0 && stats.numFesInserts == 0)
+            continue;
+        add(total, stats);
+        cModule *module = simulation->getModule(id);
+        cModuleType *type = id < (int)moduleTypes.size() && moduleTypes[id] ? moduleTypes[id] : module ? module->getModuleType() : nullptr;
+        if (module)
+            modules.push_back(std::make_pair(module, stats));
+        if (type) {
+            auto& entry = types[type];
+            entry.first++;
+            add(entry.second, stats);
+        }
+    }
+    sortByTime(modules);
+
+    std::vector<std::pair<cModuleType *, Stats>> typeList;
+    for (const auto& entry : types)
+        typeList.push_back(std::make_pair(entry.first, entry.second.second));
+    sortByTime(typeList);
+
+    std::map<std::string, Stats> classes;
+    for (const auto& entry : classStats)
+        add(classes[opp_typename(*entry.first)], entry.second);
+    std::vector<std::pair<std::string, Stats>> classList(classes.begin(), classes.end());
+    sortByTime(classList);
+
+    mkPath(directoryOf(fileName).c_str());
+    JsonWriter writer(fileName);
+    writer.openObject();
+    writeStats(writer, total);
+
+    writer.openArray("modules");
+    for (const auto& entry : modules) {
+        writer.openObject(true);
+        writer.writeString("path", entry.first->getFullPath());
+        writer.writeString("type", entry.first->getNedTypeName());
+        writeStats(writer, entry.second);
+        writer.closeObject();
+    }
+    writer.closeArray();
+
+    writer.openArray("types");
+    for (const auto& entry : typeList) {
+        writer.openObject(true);
+        writer.writeString("type", entry.first->getFullName());
+        writer.writeInt("numModules", types[entry.first].first);
+        writeStats(writer, entry.second);
+        writer.closeObject();
+    }
+    writer.closeArray();
+
+    writer.openArray("classes");
+    for (const auto& entry : classList) {
+        writer.openObject(true);
+        writer.writeString("class", entry.first);
+        writeStats(writer, entry.second);
+        writer.closeObject();
+    }
+    writer.closeArray();
+
+    writer.openObject("other", true);
+    writeStats(writer, otherStats);
+    writer.closeObject();
+
+    writer.closeObject();
+    writer.close();
+}
+
+void cEventProfiler::lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details)
+{
+    if (eventType == LF_POST_NETWORK_FINISH) {
+        if (scalarRecording)
+            recordScalars();
+        if (!reportFile.empty())
+            writeJsonReport(reportFile.c_str());
+        if (numPartitions > 0) {
+            cNetworkPartitioner partitioner;
+            partitioner.extractFromNetwork(getSimulation()->getSystemModule(), this);
+            partitioner.setMaxImbalance(maxImbalance);
+            partitioner.partition(numPartitions);
+            partitioner.writeIniFile(partitionsFile.c_str());
+        }
+    }
+}
+
+}  // namespace omnetpp
+
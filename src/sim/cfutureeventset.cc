@@ -22,6 +22,7 @@
 
 #include <sstream>
 #include "omnetpp/cfutureeventset.h"
+#include "omnetpp/cevent.h"
 
 namespace omnetpp {
 
@@ -42,5 +43,12 @@ cFutureEventSet& cFutureEventSet::operator=(const cFutureEventSet& other)
     return *this;
 }
 
+void cFutureEventSet::reschedule(cEvent *event, simtime_t t)
+{
+    remove(event);
+    event->setArrivalTime(t);
+    insert(event);
+}
+
 }  // namespace omnetpp
 
@@ -67,9 +67,9 @@ using std::ostream;
  */
 
 // non-refcounting pool for gate fullnames
-static StringPool gateFullnamePool;
+static OPP_THREAD_LOCAL StringPool gateFullnamePool;
 
-int cGate::lastConnectionId = -1;
+OPP_THREAD_LOCAL int cGate::lastConnectionId = -1;
 
 cGate::Name::Name(const char *name, Type type)
 {
@@ -27,10 +27,10 @@ LogLevel cLog::logLevel = LOGLEVEL_TRACE;
 cLog::NoncomponentLogPredicate cLog::noncomponentLogPredicate = &cLog::defaultNoncomponentLogPredicate;
 cLog::ComponentLogPredicate cLog::componentLogPredicate = &cLog::defaultComponentLogPredicate;
 
-cLogProxy::LogBuffer cLogProxy::buffer;
-std::ostream cLogProxy::stream(&cLogProxy::buffer);
-cLogEntry cLogProxy::currentEntry;
-LogLevel cLogProxy::previousLogLevel = (LogLevel)-1;
+OPP_THREAD_LOCAL cLogProxy::LogBuffer cLogProxy::buffer;
+OPP_THREAD_LOCAL std::ostream cLogProxy::stream(&cLogProxy::buffer);
+OPP_THREAD_LOCAL cLogEntry cLogProxy::currentEntry;
+OPP_THREAD_LOCAL LogLevel cLogProxy::previousLogLevel = (LogLevel)-1;
 const char *cLogProxy::previousCategory = nullptr;
 cLogProxy::nullstream cLogProxy::dummyStream;
 
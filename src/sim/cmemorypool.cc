@@ -0,0 +1,101 @@
+//=========================================================================
+//  CMEMORYPOOL.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <new>
+#include "omnetpp/cmemorypool.h"
+
+namespace omnetpp {
+
+bool cMemoryPool::poolingEnabled = false;
+
+std::vector<cMemoryPool *>& cMemoryPool::getPools()
+{
+    // allocated on the heap and never freed, so that it outlives all pools
+    // regardless of the order in which static objects get destroyed
+    static std::vector<cMemoryPool *> *pools = new std::vector<cMemoryPool *>();
+    return *pools;
+}
+
+cMemoryPool::cMemoryPool(const char *name, size_t blockSize) : name(name ? name : "")
+{
+    this->blockSize = blockSize;
+    freeList = nullptr;
+    numFree = 0;
+    numAllocs = numReused = 0;
+    numLive = peakLive = 0;
+    getPools().push_back(this);
+    alive = true;
+}
+
+cMemoryPool::~cMemoryPool()
+{
+    alive = false;
+    purge();
+    std::vector<cMemoryPool *>& pools = getPools();
+    pools.erase(std::remove(pools.begin(), pools.end(), this), pools.end());
+}
+
+void *cMemoryPool::allocateSlow(size_t size)
+{
+    if (alive) {
+        if (blockSize == 0 && size >= sizeof(FreeBlock))
+            blockSize = size;
+        if (size == blockSize)
+            countAllocation();
+    }
+    return ::operator new(size);
+}
+
+void cMemoryPool::purge()
+{
+    while (freeList) {
+        FreeBlock *block = freeList;
+        freeList = block->next;
+        ::operator delete(block);
+    }
+    numFree = 0;
+}
+
+void cMemoryPool::resetStatistics()
+{
+    for (cMemoryPool *pool : getPools()) {
+        pool->numAllocs = 0;
+        pool->numReused = 0;
+        pool->peakLive = pool->numLive;
+    }
+}
+
+void cMemoryPool::purgeAll()
+{
+    for (cMemoryPool *pool : getPools())
+        pool->purge();
+}
+
+void cMemoryPool::printStatistics(std::ostream& out)
+{
+    for (cMemoryPool *pool : getPools()) {
+        if (pool->numAllocs == 0)
+            continue;
+        out << "  " << pool->name << ": " << pool->numAllocs << " allocations, "
+            << (int)(100.0 * pool->numReused / pool->numAllocs) << "% reused, "
+            << "peak " << pool->peakLive << " live, "
+            << pool->numFree << " free blocks of " << pool->blockSize << " bytes\n";
+    }
+}
+
+}  // namespace omnetpp
+
@@ -22,6 +22,7 @@
 #include "omnetpp/cmessage.h"
 #include "omnetpp/cexception.h"
 #include "omnetpp/cenvir.h"
+#include "omnetpp/cmemorypool.h"
 
 #ifdef WITH_PARSIM
 #include "omnetpp/ccommbuffer.h"
@@ -33,10 +34,12 @@ using std::ostream;
 
 Register_Class(cMessage);
 
+static cMemoryPool messagePool("cMessage", sizeof(cMessage));
+
 // static members of cMessage
-long cMessage::nextMessageId = 0;
-long cMessage::totalMsgCount = 0;
-long cMessage::liveMsgCount = 0;
+OPP_THREAD_LOCAL long cMessage::nextMessageId = 0;
+OPP_THREAD_LOCAL long cMessage::totalMsgCount = 0;
+OPP_THREAD_LOCAL long cMessage::liveMsgCount = 0;
 
 cMessage::cMessage(const cMessage& msg) : cEvent(msg)
 {
@@ -197,6 +200,16 @@ void cMessage::parsimUnpack(cCommBuffer *buffer)
 #endif
 }
 
+void *cMessage::operator new(size_t size)
+{
+    return messagePool.allocate(size);
+}
+
+void cMessage::operator delete(void *p, size_t size)
+{
+    messagePool.release(p, size);
+}
+
 cMessage& cMessage::operator=(const cMessage& msg)
 {
     if (this == &msg)
@@ -19,6 +19,9 @@
 #include <cstdio>  // sprintf
 #include <cstring>  // strcpy
 #include <algorithm>
+#include <string>
+#include <vector>
+#include <unordered_map>
 #include "common/stringutil.h"
 #include "omnetpp/cmodule.h"
 #include "omnetpp/csimplemodule.h"
@@ -46,9 +49,88 @@ namespace omnetpp {
 Register_Class(cModule);
 
 
+// Name/index lookup table for the submodules of a compound module, used by
+// findSubmodule() and getSubmodule(). It is built on the first lookup, and
+// then maintained incrementally as submodules are inserted, removed or renamed.
+// If submodule names are ambiguous (several submodules with the same name and
+// index, or a submodule vector and a scalar submodule with the same name),
+// the table is flagged as such, and lookups fall back to linear search which
+// returns the first match; the table is then rebuilt after the next change.
+struct cModule::SubmoduleIndex
+{
+    struct Entry {
+        cModule *scalar = nullptr;  // the non-vector submodule with this name
+        std::vector<cModule *> elements;  // submodule vector elements, indexed by vector index
+        int count = 0;  // number of submodules with this name
+    };
+    std::unordered_map<std::string, Entry> entries;
+    bool ambiguous = false;
+
+    void add(cModule *module);
+    void remove(cModule *module);
+    cModule *find(const char *name, int index) const;
+};
+
+void cModule::SubmoduleIndex::add(cModule *module)
+{
+    Entry& entry = entries[module->getName()];
+    entry.count++;
+    if (!module->isVector()) {
+        if (entry.count > 1)
+            ambiguous = true;
+        else
+            entry.scalar = module;
+    }
+    else {
+        int index = module->getIndex();
+        if (entry.scalar || index < 0) {
+            ambiguous = true;
+            return;
+        }
+        if (index >= (int)entry.elements.size())
+            entry.elements.resize(std::max(index + 1, module->getVectorSize()), nullptr);
+        if (entry.elements[index])
+            ambiguous = true;
+        else
+            entry.elements[index] = module;
+    }
+}
+
+void cModule::SubmoduleIndex::remove(cModule *module)
+{
+    auto it = entries.find(module->getName());
+    if (it == entries.end()) {
+        ambiguous = true;  // should not happen
+        return;
+    }
+    Entry& entry = it->second;
+    int index = module->getIndex();
+    if (entry.scalar == module)
+        entry.scalar = nullptr;
+    else if (module->isVector() && index >= 0 && index < (int)entry.elements.size() && entry.elements[index] == module)
+        entry.elements[index] = nullptr;
+    else
+        ambiguous = true;  // should not happen
+    if (--entry.count == 0)
+        entries.erase(it);
+}
+
+cModule *cModule::SubmoduleIndex::find(const char *name, int index) const
+{
+    auto it = entries.find(name ? name : "");
+    if (it == entries.end())
+        return nullptr;
+    const Entry& entry = it->second;
+    if (index >= 0 && index < (int)entry.elements.size() && entry.elements[index])
+        return entry.elements[index];
+    if (index == -1 || index == 0)  // note: a non-vector submodule reports index 0
+        return entry.scalar;
+    return nullptr;
+}
+
 // static members:
-std::string cModule::lastModuleFullPath;
-const cModule *cModule::lastModuleFullPathModule = nullptr;
+OPP_THREAD_LOCAL std::string cModule::lastModuleFullPath;
+OPP_THREAD_LOCAL const cModule *cModule::lastModuleFullPathModule = nullptr;
 
 #ifdef NDEBUG
 bool cModule::cacheFullPath = false; // in release mode keep memory usage low
@@ -65,6 +147,7 @@ cModule::cModule()
 
     prevSibling = nextSibling = firstSubmodule = lastSubmodule = nullptr;
     firstChannel = lastChannel = nullptr;
+    submoduleIndex = nullptr;
 
     gateDescArraySize = 0;
     gateDescArray = nullptr;
@@ -95,7 +178,9 @@ cModule::~cModule()
     // notify envir while module object (or rather, its remains) still exist
     EVCB.moduleDeleted(this);
 
-    // delete submodules
+    // delete submodules (no need to maintain the lookup table meanwhile)
+    delete submoduleIndex;
+    submoduleIndex = nullptr;
     for (SubmoduleIterator it(this); !it.end(); ) {
         cModule *submodule = *it;
         ++it;
@@ -145,10 +230,16 @@ void cModule::forEachChild(cVisitor *v)
 void cModule::setNameAndIndex(const char *s, int i, int n)
 {
     // a two-in-one function, so that we don't end up calling updateFullPath() twice
+    cModule *parent = getParentModule();
+    bool inParent = parent && isInSubmoduleList(parent);
+    if (inParent)
+        parent->removeFromSubmoduleIndex(this);
     cOwnedObject::setName(s);
     vectorIndex = i;
     vectorSize = n;
     updateFullName();
+    if (inParent)
+        parent->addToSubmoduleIndex(this);
 }
 
 std::string cModule::str() const
@@ -172,6 +263,8 @@ void cModule::insertSubmodule(cModule *mod)
         firstSubmodule = mod;
     lastSubmodule = mod;
 
+    addToSubmoduleIndex(mod);
+
     // cached module getFullPath() possibly became invalid
     lastModuleFullPathModule = nullptr;
 }
@@ -182,6 +275,8 @@ void cModule::removeSubmodule(cModule *mod)
     // and otherwise it'd cause trouble if mod itself is in context (it'd get inserted
     // on its own DefaultList)
 
+    removeFromSubmoduleIndex(mod);
+
     // remove from submodule list
     if (mod->nextSibling)
         mod->nextSibling->prevSibling = mod->prevSibling;
@@ -199,6 +294,30 @@ void cModule::removeSubmodule(cModule *mod)
     lastModuleFullPathModule = nullptr;
 }
 
+void cModule::addToSubmoduleIndex(cModule *mod)
+{
+    if (submoduleIndex) {
+        if (submoduleIndex->ambiguous) {
+            delete submoduleIndex;  // give it another chance on the next lookup
+            submoduleIndex = nullptr;
+        }
+        else
+            submoduleIndex->add(mod);
+    }
+}
+
+void cModule::removeFromSubmoduleIndex(cModule *mod)
+{
+    if (submoduleIndex) {
+        if (submoduleIndex->ambiguous) {
+            delete submoduleIndex;  // give it another chance on the next lookup
+            submoduleIndex = nullptr;
+        }
+        else
+            submoduleIndex->remove(mod);
+    }
+}
+
 void cModule::insertChannel(cChannel *channel)
 {
     // note: no take(channel), as channels are owned by their src gates.
@@ -236,8 +355,14 @@ cModule *cModule::getParentModule() const
 
 void cModule::setName(const char *s)
 {
+    cModule *parent = getParentModule();
+    bool inParent = parent && isInSubmoduleList(parent);
+    if (inParent)
+        parent->removeFromSubmoduleIndex(this);
     cOwnedObject::setName(s);
     updateFullName();
+    if (inParent)
+        parent->addToSubmoduleIndex(this);
 }
 
 void cModule::updateFullName()
@@ -339,7 +464,7 @@ cGate *cModule::createGateObject(cGate::Type)
     return new cGate();
 }
 
-cModule::NamePool cModule::namePool;
+OPP_THREAD_LOCAL cModule::NamePool cModule::namePool;
 
 void cModule::disposeGateObject(cGate *gate, bool checkConnected)
 {
@@ -470,9 +595,15 @@ cGate::Desc *cModule::addGateDesc(const char *gatename, cGate::Type type, bool i
         it = namePool.insert(key).first;
     newDesc->name = const_cast<cGate::Name *>(&(*it));
     newDesc->vectorSize = isVector ? 0 : -1;
+
     return newDesc;
 }
 
+static inline const char *gateDescName(const cGate::Desc *desc, char suffix)
+{
+    return (suffix == 'i' ? desc->name->namei : suffix == 'o' ? desc->name->nameo : desc->name->name).c_str();
+}
+
 int cModule::findGateDesc(const char *gatename, char& suffix) const
 {
     // determine whether gatename contains "$i"/"$o" suffix
@@ -481,31 +612,23 @@ int cModule::findGateDesc(const char *gatename, char& suffix) const
     if (suffix && suffix != 'i' && suffix != 'o')
         return -1;  // invalid suffix ==> no such gate
 
-    // and search accordingly
-    switch (suffix) {
-        case '\0':
-            for (int i = 0; i < gateDescArraySize; i++) {
-                const cGate::Desc *desc = gateDescArray + i;
-                if (desc->name && strcmp(desc->name->name.c_str(), gatename) == 0)
-                    return i;
-            }
-            break;
-
-        case 'i':
-            for (int i = 0; i < gateDescArraySize; i++) {
-                const cGate::Desc *desc = gateDescArray + i;
-                if (desc->name && strcmp(desc->name->namei.c_str(), gatename) == 0)
-                    return i;
-            }
-            break;
+    // look up the index in the table of the module type, and verify it (it may
+    // be wrong or missing for this module if gates were added dynamically)
+    cModuleType *type = static_cast<cModuleType *>(componentType);
+    if (type) {
+        auto it = type->gateDescIndices.find(gatename);
+        if (it != type->gateDescIndices.end()) {
+            int i = it->second;
+            if (i < gateDescArraySize && gateDescArray[i].name && strcmp(gateDescName(gateDescArray + i, suffix), gatename) == 0)
+                return i;
+        }
+    }
 
-        case 'o':
-            for (int i = 0; i < gateDescArraySize; i++) {
-                const cGate::Desc *desc = gateDescArray + i;
-                if (desc->name && strcmp(desc->name->nameo.c_str(), gatename) == 0)
-                    return i;
-            }
-            break;
+    // fall back to linear search
+    for (int i = 0; i < gateDescArraySize; i++) {
+        const cGate::Desc *desc = gateDescArray + i;
+        if (desc->name && strcmp(gateDescName(desc, suffix), gatename) == 0)
+            return i;
     }
     return -1;
 }
@@ -1075,26 +1198,36 @@ bool cModule::checkInternalConnections() const
     return true;
 }
 
-int cModule::findSubmodule(const char *name, int index) const
+cModule *cModule::lookupSubmodule(const char *name, int index) const
 {
+    if (!firstSubmodule)
+        return nullptr;
+
+    if (!submoduleIndex) {
+        submoduleIndex = new SubmoduleIndex();
+        for (cModule *submodule = firstSubmodule; submodule && !submoduleIndex->ambiguous; submodule = submodule->nextSibling)
+            submoduleIndex->add(submodule);
+    }
+    if (!submoduleIndex->ambiguous)
+        return submoduleIndex->find(name, index);
+
     for (SubmoduleIterator it(this); !it.end(); ++it) {
         cModule *submodule = *it;
         if (submodule->isName(name) && ((index == -1 && !submodule->isVector()) || submodule->getIndex() == index))
-            return submodule->getId();
+            return submodule;
     }
+    return nullptr;
+}
 
-    return -1;
+int cModule::findSubmodule(const char *name, int index) const
+{
+    cModule *submodule = lookupSubmodule(name, index);
+    return submodule ? submodule->getId() : -1;
 }
 
 cModule *cModule::getSubmodule(const char *name, int index) const
 {
-    for (SubmoduleIterator it(this); !it.end(); ++it) {
-        cModule *submodule = *it;
-        if (submodule->isName(name) && ((index == -1 && !submodule->isVector()) || submodule->getIndex() == index))
-            return submodule;
-    }
-
-    return nullptr;
+    return lookupSubmodule(name, index);
 }
 
 inline char *nextToken(char *& rest)
@@ -1200,6 +1333,10 @@ void cModule::buildInside()
     if (buildInsideCalled())
         throw cRuntimeError(this, "buildInside() already called for this module");
 
+#ifdef WITH_THREADED_PARSIM
+    std::lock_guard<std::recursive_mutex> lock(cComponentType::getCreationMutex());
+#endif
+
     // call finalizeParameters() if user has forgotten to do it;
     // this is needed to make dynamic module creation more robust
     if (!parametersFinalized())
@@ -1315,6 +1452,7 @@ void cModule::changeParentTo(cModule *module)
     cModule *oldparent = getParentModule();
     oldparent->removeSubmodule(this);
     module->insertSubmodule(this);
+    invalidateListenerChains();
     int oldId = getId();
     reassignModuleIdRec();
     if (cacheFullPath)
@@ -0,0 +1,472 @@
+//=========================================================================
+//  CNETWORKPARTITIONER.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include "common/fileutil.h"
+#include "omnetpp/cnetworkpartitioner.h"
+#include "omnetpp/ceventprofiler.h"
+#include "omnetpp/cmodule.h"
+#include "omnetpp/cgate.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cexception.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+
+// coarsening stops at about this many vertices per partition
+#define COARSEST_VERTICES_PER_PARTITION  20
+
+// number of attempts for the initial partitioning of the coarsest graph
+#define INITIAL_PARTITIONING_TRIALS  8
+
+// maximum number of refinement passes on each level
+#define MAX_REFINEMENT_PASSES  10
+
+int cNetworkPartitioner::addVertex(int64_t weight, cModule *module)
+{
+    if (weight < 0)
+        throw cRuntimeError("cNetworkPartitioner: Negative vertex weight");
+    graph.vertexWeights.push_back(weight);
+    graph.edges.push_back(std::vector<Edge>());
+    modules.push_back(module);
+    return graph.getNumVertices() - 1;
+}
+
+void cNetworkPartitioner::addEdge(Graph& g, int u, int v, int64_t weight)
+{
+    if (u < 0 || u >= g.getNumVertices() || v < 0 || v >= g.getNumVertices())
+        throw cRuntimeError("cNetworkPartitioner: Vertex index out of range");
+    if (u == v || weight == 0)
+        return;
+    for (Edge& e : g.edges[u]) {
+        if (e.vertex == v) {
+            e.weight += weight;
+            for (Edge& e2 : g.edges[v])
+                if (e2.vertex == u)
+                    e2.weight += weight;
+            return;
+        }
+    }
+    g.edges[u].push_back(Edge {v, weight});
+    g.edges[v].push_back(Edge {u, weight});
+}
+
+void cNetworkPartitioner::clear()
+{
+    graph = Graph();
+    modules.clear();
+    partitionOf.clear();
+    partitionWeights.clear();
+    cutWeight = 0;
+}
+
+static void collectModules(cModule *module, int vertex, std::vector<int>& vertexOfModule, std::vector<cModule *>& result)
+{
+    vertexOfModule[module->getId()] = vertex;
+    result.push_back(module);
+    for (cModule::SubmoduleIterator it(module); !it.end(); ++it)
+        collectModules(*it, vertex, vertexOfModule, result);
+}
+
+void cNetworkPartitioner::extractFromNetwork(cModule *network, const cEventProfiler *profiler)
+{
+    clear();
+
+    cSimulation *simulation = network->getSimulation();
+    std::vector<int> vertexOfModule(simulation->getLastComponentId() + 1, -1);
+    std::vector<cModule *> moduleList;
+
+    // vertices: submodules of the network, with the load of their whole subtree
+    for (cModule::SubmoduleIterator it(network); !it.end(); ++it) {
+        cModule *submodule = *it;
+        int vertex = addVertex(0, submodule);
+        size_t first = moduleList.size();
+        collectModules(submodule, vertex, vertexOfModule, moduleList);
+        int64_t weight = 1;
+        if (profiler)
+            for (size_t i = first; i < moduleList.size(); i++)
+                weight += profiler->getStatsForModule(moduleList[i]->getId()).numEvents;
+        graph.vertexWeights[vertex] = weight;
+    }
+
+    // edges: connections between the submodules...
+    for (cModule *module : moduleList) {
+        int u = vertexOfModule[module->getId()];
+        for (cModule::GateIterator it(module); !it.end(); ++it) {
+            cGate *gate = *it;
+            cGate *nextGate = gate->getType() == cGate::OUTPUT ? gate->getNextGate() : nullptr;
+            if (nextGate) {
+                int id = nextGate->getOwnerModule()->getId();
+                int v = id < (int)vertexOfModule.size() ? vertexOfModule[id] : -1;
+                if (v != -1)
+                    addEdge(u, v, 1);
+            }
+        }
+    }
+
+    // ...and the messages sent between them
+    if (profiler) {
+        for (const cEventProfiler::Traffic& traffic : profiler->getTraffic()) {
+            int u = traffic.senderModuleId < (int)vertexOfModule.size() ? vertexOfModule[traffic.senderModuleId] : -1;
+            int v = traffic.arrivalModuleId < (int)vertexOfModule.size() ? vertexOfModule[traffic.arrivalModuleId] : -1;
+            if (u != -1 && v != -1)
+                addEdge(u, v, traffic.numMessages);
+        }
+    }
+}
+
+bool cNetworkPartitioner::coarsen(Graph& fine, Graph& coarse, int64_t maxVertexWeight)
+{
+    int n = fine.getNumVertices();
+
+    // heavy edge matching: visit vertices in random order, and match each
+    // with the unmatched neighbor it is connected to with the heaviest edge
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+    std::mt19937 rng(seed + n);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    std::vector<int> match(n, -1);
+    for (int v : order) {
+        if (match[v] != -1)
+            continue;
+        int best = v;
+        int64_t bestWeight = -1;
+        for (const Edge& e : fine.edges[v]) {
+            if (match[e.vertex] == -1 && e.weight > bestWeight && fine.vertexWeights[v] + fine.vertexWeights[e.vertex] <= maxVertexWeight) {
+                best = e.vertex;
+                bestWeight = e.weight;
+            }
+        }
+        match[v] = best;
+        match[best] = v;
+    }
+
+    // number the coarse vertices
+    fine.coarseVertex.assign(n, -1);
+    int numCoarse = 0;
+    for (int v = 0; v < n; v++)
+        if (fine.coarseVertex[v] == -1)
+            fine.coarseVertex[v] = fine.coarseVertex[match[v]] = numCoarse++;
+    if (numCoarse > 0.95 * n) {
+        fine.coarseVertex.clear();
+        return false;  // not worth it
+    }
+
+    // build the coarse graph; parallel edges are merged with the help of edgeIndex[]
+    coarse.vertexWeights.assign(numCoarse, 0);
+    coarse.edges.assign(numCoarse, std::vector<Edge>());
+    coarse.coarseVertex.clear();
+    std::vector<int> edgeIndex(numCoarse, -1);
+    for (int v = 0; v < n; v++) {
+        if (match[v] < v)
+            continue;  // the pair is processed at the smaller index
+        int c = fine.coarseVertex[v];
+        std::vector<Edge>& coarseEdges = coarse.edges[c];
+        for (int member : {v, match[v]}) {
+            coarse.vertexWeights[c] += fine.vertexWeights[member];
+            for (const Edge& e : fine.edges[member]) {
+                int cu = fine.coarseVertex[e.vertex];
+                if (cu == c)
+                    continue;
+                if (edgeIndex[cu] == -1) {
+                    edgeIndex[cu] = coarseEdges.size();
+                    coarseEdges.push_back(Edge {cu, 0});
+                }
+                coarseEdges[edgeIndex[cu]].weight += e.weight;
+            }
+            if (member == match[v])
+                break;  // unmatched vertex, matched with itself
+        }
+        for (const Edge& e : coarseEdges)
+            edgeIndex[e.vertex] = -1;
+    }
+    return true;
+}
+
+std::vector<int64_t> cNetworkPartitioner::computePartitionWeights(const Graph& g, int numPartitions, const std::vector<int>& parts)
+{
+    std::vector<int64_t> weights(numPartitions, 0);
+    for (int v = 0; v < g.getNumVertices(); v++)
+        weights[parts[v]] += g.vertexWeights[v];
+    return weights;
+}
+
+static int64_t computeCutWeight(const std::vector<std::vector<cNetworkPartitioner::Edge>>& edges, const std::vector<int>& parts)
+{
+    int64_t cut = 0;
+    for (int v = 0; v < (int)edges.size(); v++)
+        for (const cNetworkPartitioner::Edge& e : edges[v])
+            if (e.vertex > v && parts[e.vertex] != parts[v])
+                cut += e.weight;
+    return cut;
+}
+
+void cNetworkPartitioner::initialPartition(const Graph& g, int numPartitions, int64_t maxPartitionWeight, std::vector<int>& parts)
+{
+    // grow the partitions one after the other from a seed vertex, always adding
+    // the vertex most strongly connected to the partition; the last partition
+    // gets the remaining vertices. The best of several attempts is kept.
+    int n = g.getNumVertices();
+    int64_t totalWeight = 0;
+    for (int64_t w : g.vertexWeights)
+        totalWeight += w;
+
+    std::mt19937 rng(seed);
+    std::vector<int> bestParts;
+    int64_t bestOverweight = 0, bestCut = 0;
+    std::vector<int> trial(n);
+    std::vector<int64_t> connection(n);
+
+    for (int t = 0; t < INITIAL_PARTITIONING_TRIALS; t++) {
+        trial.assign(n, numPartitions - 1);
+        std::vector<bool> assigned(n, false);
+        std::vector<int> skippedFor(n, -1);  // the partition for which the vertex was found too heavy
+        int64_t remainingWeight = totalWeight;
+        for (int p = 0; p < numPartitions - 1; p++) {
+            int64_t target = remainingWeight / (numPartitions - p);
+            int64_t weight = 0;
+            std::fill(connection.begin(), connection.end(), 0);
+            std::priority_queue<std::pair<int64_t,int>> frontier;  // (connection, vertex)
+            while (weight < target) {
+                if (frontier.empty()) {
+                    // start a new region from a random unassigned vertex
+                    std::vector<int> candidates;
+                    for (int v = 0; v < n; v++)
+                        if (!assigned[v] && skippedFor[v] != p)
+                            candidates.push_back(v);
+                    if (candidates.empty())
+                        break;
+                    frontier.push(std::make_pair(0, candidates[rng() % candidates.size()]));
+                }
+                int v = frontier.top().second;
+                int64_t conn = frontier.top().first;
+                frontier.pop();
+                if (assigned[v] || conn != connection[v])
+                    continue;  // stale entry
+                if (weight > 0 && weight + g.vertexWeights[v] > target && weight + g.vertexWeights[v] - target > target - weight) {
+                    skippedFor[v] = p;  // would overshoot more than it helps
+                    continue;
+                }
+                assigned[v] = true;
+                trial[v] = p;
+                weight += g.vertexWeights[v];
+                for (const Edge& e : g.edges[v]) {
+                    if (!assigned[e.vertex]) {
+                        connection[e.vertex] += e.weight;
+                        frontier.push(std::make_pair(connection[e.vertex], e.vertex));
+                    }
+                }
+            }
+            remainingWeight -= weight;
+        }
+
+        refine(g, numPartitions, maxPartitionWeight, trial);
+
+        int64_t overweight = 0;
+        for (int64_t w : computePartitionWeights(g, numPartitions, trial))
+            overweight += std::max((int64_t)0, w - maxPartitionWeight);
+        int64_t cut = computeCutWeight(g.edges, trial);
+        if (bestParts.empty() || overweight < bestOverweight || (overweight == bestOverweight && cut < bestCut)) {
+            bestParts = trial;
+            bestOverweight = overweight;
+            bestCut = cut;
+        }
+    }
+    parts = bestParts;
+}
+
+void cNetworkPartitioner::refine(const Graph& g, int numPartitions, int64_t maxPartitionWeight, std::vector<int>& parts)
+{
+    // greedy k-way refinement: move vertices to the partition they are most
+    // strongly connected to, if that does not violate the balance constraint;
+    // vertices of overweight partitions are moved out even at the cost of a
+    // larger cut
+    int n = g.getNumVertices();
+    std::vector<int64_t> weights = computePartitionWeights(g, numPartitions, parts);
+    std::vector<int64_t> connection(numPartitions, 0);
+    std::vector<int> touched;
+
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+    std::mt19937 rng(seed + 1);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    for (int pass = 0; pass < MAX_REFINEMENT_PASSES; pass++) {
+        int numMoves = 0;
+        for (int v : order) {
+            int from = parts[v];
+            int64_t w = g.vertexWeights[v];
+            bool overweight = weights[from] > maxPartitionWeight;
+            if (g.edges[v].empty() && !overweight)
+                continue;
+
+            for (const Edge& e : g.edges[v]) {
+                int p = parts[e.vertex];
+                if (connection[p] == 0)
+                    touched.push_back(p);
+                connection[p] += e.weight;
+            }
+
+            int best = -1;
+            int64_t bestGain = 0;
+            for (int p : touched) {
+                if (p == from || weights[p] + w > maxPartitionWeight)
+                    continue;
+                int64_t gain = connection[p] - connection[from];
+                if (best == -1 || gain > bestGain || (gain == bestGain && weights[p] < weights[best])) {
+                    best = p;
+                    bestGain = gain;
+                }
+            }
+            if (overweight && best == -1) {
+                // no neighboring partition can take it, try the lightest one
+                int lightest = std::min_element(weights.begin(), weights.end()) - weights.begin();
+                if (lightest != from && weights[lightest] + w <= maxPartitionWeight) {
+                    best = lightest;
+                    bestGain = -connection[from];
+                }
+            }
+            bool move = best != -1 && (overweight || bestGain > 0 || (bestGain == 0 && weights[best] + w < weights[from]));
+
+            for (int p : touched)
+                connection[p] = 0;
+            touched.clear();
+
+            if (move) {
+                parts[v] = best;
+                weights[from] -= w;
+                weights[best] += w;
+                numMoves++;
+            }
+        }
+        if (numMoves == 0)
+            break;
+    }
+}
+
+void cNetworkPartitioner::partition(int numPartitions)
+{
+    if (numPartitions < 1)
+        throw cRuntimeError("cNetworkPartitioner: Invalid number of partitions %d", numPartitions);
+    if (maxImbalance < 0)
+        throw cRuntimeError("cNetworkPartitioner: Negative imbalance");
+
+    int n = graph.getNumVertices();
+    int64_t totalWeight = 0, maxVertexWeight = 0;
+    for (int64_t w : graph.vertexWeights) {
+        totalWeight += w;
+        maxVertexWeight = std::max(maxVertexWeight, w);
+    }
+    int64_t maxPartitionWeight = (int64_t)std::ceil(totalWeight * (1 + maxImbalance) / numPartitions);
+    maxPartitionWeight = std::max(maxPartitionWeight, maxVertexWeight);
+
+    // coarsening phase
+    std::vector<Graph> levels;
+    levels.push_back(graph);
+    int64_t maxCoarseVertexWeight = std::max((int64_t)1, totalWeight / (4 * numPartitions));
+    while (levels.back().getNumVertices() > COARSEST_VERTICES_PER_PARTITION * numPartitions) {
+        Graph coarse;
+        if (!coarsen(levels.back(), coarse, maxCoarseVertexWeight))
+            break;
+        levels.push_back(std::move(coarse));
+    }
+
+    // partition the coarsest graph, then project the result back level by level
+    std::vector<int> parts;
+    initialPartition(levels.back(), numPartitions, maxPartitionWeight, parts);
+    for (int level = levels.size() - 2; level >= 0; level--) {
+        const Graph& fine = levels[level];
+        std::vector<int> fineParts(fine.getNumVertices());
+        for (int v = 0; v < fine.getNumVertices(); v++)
+            fineParts[v] = parts[fine.coarseVertex[v]];
+        parts.swap(fineParts);
+        refine(fine, numPartitions, maxPartitionWeight, parts);
+    }
+
+    ASSERT((int)parts.size() == n);
+    partitionOf = parts;
+    partitionWeights = computePartitionWeights(graph, numPartitions, parts);
+    cutWeight = computeCutWeight(graph.edges, parts);
+}
+
+std::string cNetworkPartitioner::getIniLines() const
+{
+    if (partitionOf.empty() && getNumVertices() > 0)
+        throw cRuntimeError("cNetworkPartitioner: partition() has not been called");
+
+    std::stringstream os;
+    int n = getNumVertices();
+    for (int v = 0; v < n; v++) {
+        cModule *module = modules[v];
+        if (!module)
+            continue;
+        if (!module->isVector()) {
+            os << module->getFullPath() << ".partition-id = " << partitionOf[v] << "\n";
+            continue;
+        }
+
+        // merge the following elements of the same vector in the same partition into an index range
+        int last = v;
+        while (last + 1 < n && modules[last + 1] && modules[last + 1]->isVector()
+                && modules[last + 1]->getParentModule() == module->getParentModule()
+                && strcmp(modules[last + 1]->getName(), module->getName()) == 0
+                && modules[last + 1]->getIndex() == modules[last]->getIndex() + 1
+                && partitionOf[last + 1] == partitionOf[v])
+            last++;
+        os << module->getParentModule()->getFullPath() << "." << module->getName() << "[" << module->getIndex();
+        if (last != v)
+            os << ".." << modules[last]->getIndex();
+        os << "].partition-id = " << partitionOf[v] << "\n";
+        v = last;
+    }
+    return os.str();
+}
+
+void cNetworkPartitioner::writeIniFile(const char *fileName) const
+{
+    std::string lines = getIniLines();
+
+    mkPath(directoryOf(fileName).c_str());
+    std::ofstream out(fileName);
+    if (!out.good())
+        throw cRuntimeError("Cannot open '%s' for write", fileName);
+
+    int64_t totalWeight = 0;
+    for (int64_t w : partitionWeights)
+        totalWeight += w;
+    out << "# partition-id settings computed by cNetworkPartitioner\n";
+    for (int p = 0; p < (int)partitionWeights.size(); p++)
+        out << "# partition " << p << ": weight " << partitionWeights[p]
+            << " (" << (totalWeight == 0 ? 0 : 100.0 * partitionWeights[p] / totalWeight) << "%)\n";
+    out << "# cut weight: " << cutWeight << "\n";
+    out << lines;
+    out.close();
+    if (out.fail())
+        throw cRuntimeError("Cannot write '%s'", fileName);
+}
+
+}  // namespace omnetpp
+
@@ -28,7 +28,7 @@
 namespace omnetpp {
 
 #ifdef SIMFRONTEND_SUPPORT
-int64_t cObject::changeCounter = 0;
+OPP_THREAD_LOCAL int64_t cObject::changeCounter = 0;
 #endif
 
 cObject::~cObject()
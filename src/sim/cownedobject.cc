@@ -54,11 +54,11 @@ void printAllObjects()
 #endif
 
 // static class members
-cDefaultOwner *cOwnedObject::defaultOwner = &defaultList;
-long cOwnedObject::totalObjectCount = 0;
-long cOwnedObject::liveObjectCount = 0;
+OPP_THREAD_LOCAL cDefaultOwner *cOwnedObject::defaultOwner = &defaultList;
+OPP_THREAD_LOCAL long cOwnedObject::totalObjectCount = 0;
+OPP_THREAD_LOCAL long cOwnedObject::liveObjectCount = 0;
 
-cDefaultOwner defaultList;
+OPP_THREAD_LOCAL cDefaultOwner defaultList;
 
 cOwnedObject::cOwnedObject()
 {
@@ -19,6 +19,7 @@
 #include "omnetpp/globals.h"
 #include "omnetpp/cpacket.h"
 #include "omnetpp/csimplemodule.h"
+#include "omnetpp/cmemorypool.h"
 #include "omnetpp/platdep/platmisc.h"  // PRId64
 
 #ifdef WITH_PARSIM
@@ -34,6 +35,8 @@ using std::ostream;
 
 Register_Class(cPacket);
 
+static cMemoryPool packetPool("cPacket", sizeof(cPacket));
+
 cPacket::cPacket(const cPacket& pkt) : cMessage(pkt)
 {
     encapsulatedPacket = nullptr;
@@ -123,6 +126,16 @@ void cPacket::parsimUnpack(cCommBuffer *buffer)
 #endif
 }
 
+void *cPacket::operator new(size_t size)
+{
+    return packetPool.allocate(size);
+}
+
+void cPacket::operator delete(void *p, size_t size)
+{
+    packetPool.release(p, size);
+}
+
 cPacket& cPacket::operator=(const cPacket& msg)
 {
     if (this == &msg)
@@ -35,8 +35,8 @@
 
 namespace omnetpp {
 
-long cParImpl::totalParimplObjs;
-long cParImpl::liveParimplObjs;
+OPP_THREAD_LOCAL long cParImpl::totalParimplObjs;
+OPP_THREAD_LOCAL long cParImpl::liveParimplObjs;
 cStringPool cParImpl::stringPool("cParImpl::stringPool");
 
 cParImpl::cParImpl()
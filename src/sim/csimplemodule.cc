@@ -27,6 +27,7 @@
 #include "omnetpp/csimplemodule.h"
 #include "omnetpp/cgate.h"
 #include "omnetpp/cpacket.h"
+#include "omnetpp/ctimeouttimer.h"
 #include "omnetpp/ccoroutine.h"
 #include "omnetpp/csimulation.h"
 #include "omnetpp/ccontextswitcher.h"
@@ -38,6 +39,11 @@
 #include "omnetpp/cexception.h"
 #include "omnetpp/platdep/platmisc.h"  // for DEBUG_TRAP
 
+#ifdef WITH_PARSIM
+#include "sim/parsim/cproxygate.h"
+#include "sim/parsim/cparsimpartition.h"
+#endif
+
 using namespace omnetpp::common;
 
 namespace omnetpp {
@@ -48,8 +54,8 @@ namespace omnetpp {
 #define DEBUG_TRAP_IF_REQUESTED    { if (getSimulation()->trapOnNextEvent) { getSimulation()->trapOnNextEvent = false; if (getEnvir()->ensureDebugger()) DEBUG_TRAP; } }
 #endif
 
-bool cSimpleModule::stackCleanupRequested;
-cSimpleModule *cSimpleModule::afterCleanupTransferTo;
+OPP_THREAD_LOCAL bool cSimpleModule::stackCleanupRequested;
+OPP_THREAD_LOCAL cSimpleModule *cSimpleModule::afterCleanupTransferTo;
 
 void cSimpleModule::activate(void *p)
 {
@@ -462,6 +468,32 @@ void cSimpleModule::sendDirect(cMessage *msg, simtime_t propagationDelay, simtim
         EVCB.endSend(msg);
 }
 
+void cSimpleModule::promiseEarliestSendTime(simtime_t t, const char *gateName, int gateIndex)
+{
+    cGate *outGate;
+    TRY(outGate = gate(gateName, gateIndex), "promiseEarliestSendTime()");
+    promiseEarliestSendTime(t, outGate);
+}
+
+void cSimpleModule::promiseEarliestSendTime(simtime_t t, cGate *outGate)
+{
+    if (outGate == nullptr)
+        throw cRuntimeError("promiseEarliestSendTime(): Gate pointer is nullptr");
+    if (outGate->getType() == cGate::INPUT)
+        throw cRuntimeError("promiseEarliestSendTime(): Gate '%s' is an input gate", outGate->getFullName());
+    if (outGate->getOwnerModule() != this)
+        throw cRuntimeError("promiseEarliestSendTime(): Gate '%s' does not belong to this module", outGate->getFullPath().c_str());
+    if (t < simTime())
+        throw cRuntimeError("promiseEarliestSendTime(): Promised time %s is in the past", SIMTIME_STR(t));
+
+#ifdef WITH_PARSIM
+    // only links to other partitions are interesting
+    cProxyGate *proxyGate = dynamic_cast<cProxyGate *>(outGate->getPathEndGate());
+    if (proxyGate && proxyGate->getPartition() && proxyGate->getRemoteProcId() >= 0)
+        proxyGate->getPartition()->promiseEarliestSendTime(t, proxyGate->getRemoteProcId(), proxyGate->getSynchData());
+#endif
+}
+
 void cSimpleModule::scheduleAt(simtime_t t, cMessage *msg)
 {
     if (msg == nullptr)
@@ -518,6 +550,8 @@ cMessage *cSimpleModule::cancelEvent(cMessage *msg)
             throw cRuntimeError("cancelEvent(): Cannot cancel another module's self-message");
 
         getSimulation()->getFES()->remove(msg);
+        if (cIFutureEventSetListener *listener = getSimulation()->getFESListener())
+            listener->eventCancelled(msg);
         EVCB.messageCancelled(msg);
         msg->setPreviousEventNumber(getSimulation()->getEventNumber());
     }
@@ -531,6 +565,67 @@ void cSimpleModule::cancelAndDelete(cMessage *msg)
         delete cancelEvent(msg);
 }
 
+void cSimpleModule::rescheduleAt(simtime_t t, cMessage *msg)
+{
+    if (msg == nullptr)
+        throw cRuntimeError("rescheduleAt(): Message pointer is nullptr");
+    if (!msg->isScheduled() || msg->getOwner() != getSimulation()->getFES()) {
+        scheduleAt(t, msg);  // also takes care of error reporting
+        return;
+    }
+    if (this != getSimulation()->getContextModule() && getSimulation()->getContextModule() != nullptr)
+        throw cRuntimeError("rescheduleAt() of module (%s)%s called in the context of "
+                            "module (%s)%s: method called from the latter module "
+                            "lacks Enter_Method() or Enter_Method_Silent()?",
+                            getClassName(), getFullPath().c_str(),
+                            getSimulation()->getContextModule()->getClassName(),
+                            getSimulation()->getContextModule()->getFullPath().c_str());
+    if (!msg->isSelfMessage())
+        throw cRuntimeError("rescheduleAt(): Message (%s)%s is not a self-message", msg->getClassName(), msg->getFullName());
+    if (msg->getArrivalModuleId() != getId())
+        throw cRuntimeError("rescheduleAt(): Cannot reschedule another module's self-message");
+    if (t < simTime())
+        throw cRuntimeError(E_BACKSCHED, msg->getClassName(), msg->getName(), SIMTIME_DBL(t));
+
+    // same as cancelEvent() plus scheduleAt(), but moves the message within the FES
+    EVCB.messageCancelled(msg);
+    getSimulation()->rescheduleEvent(msg, t);
+    msg->setSentFrom(this, -1, simTime());
+    EVCB.messageScheduled(msg);
+}
+
+void cSimpleModule::rescheduleAfter(simtime_t delay, cMessage *msg)
+{
+    if (delay < SIMTIME_ZERO)
+        throw cRuntimeError("rescheduleAfter(): Negative delay %s", delay.ustr().c_str());
+    rescheduleAt(simTime() + delay, msg);
+}
+
+void cSimpleModule::rescheduleTimeoutAt(simtime_t t, cTimeoutTimer *timer)
+{
+    if (timer == nullptr)
+        throw cRuntimeError("rescheduleTimeoutAt(): Message pointer is nullptr");
+    if (!timer->isScheduled() || timer->getOwner() != getSimulation()->getFES() || t < timer->getArrivalTime()) {
+        rescheduleAt(t, timer);  // also takes care of error reporting
+        return;
+    }
+    if (!timer->isSelfMessage())
+        throw cRuntimeError("rescheduleTimeoutAt(): Message (%s)%s is not a self-message", timer->getClassName(), timer->getFullName());
+    if (timer->getArrivalModuleId() != getId())
+        throw cRuntimeError("rescheduleTimeoutAt(): Cannot reschedule another module's self-message");
+
+    // leave the timer where it is in the FES; it will be moved to the
+    // deadline when its current arrival time is reached
+    timer->setDeadline(t);
+}
+
+void cSimpleModule::rescheduleTimeoutAfter(simtime_t delay, cTimeoutTimer *timer)
+{
+    if (delay < SIMTIME_ZERO)
+        throw cRuntimeError("rescheduleTimeoutAfter(): Negative delay %s", delay.ustr().c_str());
+    rescheduleTimeoutAt(simTime() + delay, timer);
+}
+
 void cSimpleModule::arrived(cMessage *msg, cGate *ongate, simtime_t t)
 {
     if (isTerminated())
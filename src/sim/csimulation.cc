@@ -29,6 +29,7 @@
 #include "omnetpp/cmodule.h"
 #include "omnetpp/csimplemodule.h"
 #include "omnetpp/cpacket.h"
+#include "omnetpp/ctimeouttimer.h"
 #include "omnetpp/csimulation.h"
 #include "omnetpp/cscheduler.h"
 #include "omnetpp/ceventheap.h"
@@ -39,6 +40,7 @@
 #include "omnetpp/cexception.h"
 #include "omnetpp/cparimpl.h"
 #include "omnetpp/cfingerprint.h"
+#include "omnetpp/ceventprofiler.h"
 #include "omnetpp/cconfiguration.h"
 #include "omnetpp/ccoroutine.h"
 #include "omnetpp/clifecyclelistener.h"
@@ -112,6 +114,8 @@ cSimulation::cSimulation(const char *name, cEnvir *env) : cNamedObject(name, fal
 
     networkType = nullptr;
     fingerprint = nullptr;
+    eventProfiler = nullptr;
+    fesListener = nullptr;
 
     currentSimtime = SIMTIME_ZERO;
     currentEventNumber = 0;
@@ -134,6 +138,7 @@ cSimulation::~cSimulation()
 
     deleteNetwork();
 
+    delete eventProfiler;
     delete envir;
     delete fingerprint;
     delete scheduler;
@@ -293,6 +298,13 @@ void cSimulation::loadNedText(const char *name, const char *nedText, const char
 #endif
 }
 
+void cSimulation::setNedAstCacheFile(const char *fileName)
+{
+#ifdef WITH_NETBUILDER
+    cNedLoader::getInstance()->setAstCacheFile(fileName);
+#endif
+}
+
 void cSimulation::doneLoadingNedFiles()
 {
 #ifdef WITH_NETBUILDER
@@ -511,6 +523,26 @@ cEvent *cSimulation::takeNextEvent()
 
     ASSERT(!event->isStale());  // it's the scheduler's task to discard stale events
 
+    // a cTimeoutTimer whose expiry was extended while it was in the FES is
+    // not delivered, but put back into the FES at its deadline. Like with
+    // rescheduleAt(), the envir (and thus the eventlog) sees this as a
+    // cancellation plus a new scheduling; the event number of the original
+    // scheduling is kept.
+    while (event->isDeferred() && static_cast<cTimeoutTimer *>(event)->deferToDeadline()) {
+        cTimeoutTimer *timer = static_cast<cTimeoutTimer *>(event);
+        EVCB.messageCancelled(timer);
+        if (eventProfiler)
+            eventProfiler->eventInserted(timer->getArrivalModuleId(), typeid(*timer));  // no context module between events
+        fes->insert(timer);
+        if (fesListener)
+            fesListener->eventInserted(timer);
+        EVCB.messageScheduled(timer);
+        event = scheduler->takeNextEvent();
+        if (!event)
+            return nullptr;
+        ASSERT(!event->isStale());
+    }
+
     return event;
 }
 
@@ -615,6 +647,24 @@ void cSimulation::executeEvent(cEvent *event)
     // sent out again
     event->setPreviousEventNumber(currentEventNumber);
 
+    // when profiling, the module ID and the event class must be saved here,
+    // because the module and the event may be deleted while processing it
+    int64_t profilingStartTime = 0;
+    int profiledModuleId = -1;
+    const std::type_info *profiledEventClass = nullptr;
+    if (eventProfiler) {
+        profiledEventClass = &typeid(*event);
+        if (event->isMessage()) {
+            cMessage *msg = static_cast<cMessage *>(event);
+            cModule *arrivalModule = msg->getArrivalModule();
+            profiledModuleId = arrivalModule->getId();
+            eventProfiler->eventStarting(profiledModuleId, arrivalModule);
+            if (msg->getSenderModuleId() != profiledModuleId)
+                eventProfiler->messageArrived(msg->getSenderModuleId(), profiledModuleId);
+        }
+        profilingStartTime = opp_get_monotonic_clock_nsecs();
+    }
+
     cSimpleModule *module = nullptr;
     try {
         if (event->isMessage()) {
@@ -645,6 +695,9 @@ void cSimulation::executeEvent(cEvent *event)
     }
     setGlobalContext();
 
+    if (eventProfiler)
+        eventProfiler->eventEnded(profiledModuleId, *profiledEventClass, opp_get_monotonic_clock_nsecs() - profilingStartTime);
+
     // Note: simulation time (as read via simTime() from modules) will be updated
     // in takeNextEvent(), called right before the next executeEvent().
     // Simtime must NOT be updated here, because it would interfere with parallel
@@ -724,10 +777,32 @@ void cSimulation::setFingerprintCalculator(cFingerprintCalculator *f)
     fingerprint = f;
 }
 
+void cSimulation::setEventProfiler(cEventProfiler *profiler)
+{
+    if (eventProfiler)
+        delete eventProfiler;
+    eventProfiler = profiler;
+}
+
 void cSimulation::insertEvent(cEvent *event)
 {
     event->setPreviousEventNumber(currentEventNumber);
+    if (eventProfiler)
+        eventProfiler->eventInserted(contextComponent && contextComponent->isModule() ? contextComponent->getId() : -1, typeid(*event));
     fes->insert(event);
+    if (fesListener)
+        fesListener->eventInserted(event);
+}
+
+void cSimulation::rescheduleEvent(cEvent *event, simtime_t t)
+{
+    event->setPreviousEventNumber(currentEventNumber);
+    if (eventProfiler)
+        eventProfiler->eventInserted(contextComponent && contextComponent->isModule() ? contextComponent->getId() : -1, typeid(*event));
+    simtime_t oldTime = event->getArrivalTime();
+    fes->reschedule(event, t);
+    if (fesListener)
+        fesListener->eventRescheduled(event, oldTime);
 }
 
 //----
@@ -875,10 +950,10 @@ void StaticEnv::undisposedObject(cObject *obj)
 static StaticEnv staticEnv;
 
 // cSimulation's global variables
-cEnvir *cSimulation::activeEnvir = &staticEnv;
+OPP_THREAD_LOCAL cEnvir *cSimulation::activeEnvir = &staticEnv;
 cEnvir *cSimulation::staticEnvir = &staticEnv;
 
-cSimulation *cSimulation::activeSimulation = nullptr;
+OPP_THREAD_LOCAL cSimulation *cSimulation::activeSimulation = nullptr;
 
 }  // namespace omnetpp
 
@@ -19,6 +19,7 @@
 #include "omnetpp/cconfiguration.h"
 #include "omnetpp/cconfigoption.h"
 #include "omnetpp/resultfilters.h"
+#include "omnetpp/resultrecorders.h"
 #include "common/stringtokenizer.h"
 #include "common/stringutil.h"
 #include "common/opp_ctype.h"
@@ -128,9 +129,22 @@ void cStatisticBuilder::doAddResultRecorders(cComponent *component, std::string&
             StatisticSourceParser::checkSignalDeclaration(component, cComponent::getSignalName(signal), checkSignalDecl);
         }
 
-        // add result recorders
-        for (auto & mode : modes)
-            doResultRecorder(source, mode.c_str(), component, statisticName, statisticProperty);
+        // add result recorders; runs of basic recorders (count, sum, max, vector,
+        // etc.) are replaced by a FusedRecorder, so that they are notified in one call
+        for (size_t i = 0; i < modes.size(); ) {
+            size_t j = i;
+            while (j < modes.size() && FusedRecorder::supportsMode(modes[j].c_str()))
+                j++;
+            if (j - i >= 2) {
+                std::string fusedModes = opp_join(std::vector<std::string>(modes.begin() + i, modes.begin() + j), ",");
+                doFusedResultRecorder(source, fusedModes.c_str(), component, statisticName, statisticProperty);
+                i = j;
+            }
+            else {
+                doResultRecorder(source, modes[i].c_str(), component, statisticName, statisticProperty);
+                i++;
+            }
+        }
     }
 }
 
@@ -239,5 +253,18 @@ void cStatisticBuilder::doResultRecorder(const SignalSource& source, const char
     }
 }
 
+void cStatisticBuilder::doFusedResultRecorder(const SignalSource& source, const char *recordingModes, cComponent *component, const char *statisticName, cProperty *attrsProperty)
+{
+    try {
+        cResultRecorder *recorder = new FusedRecorder();
+        recorder->init(component, statisticName, recordingModes, attrsProperty);
+        source.subscribe(recorder);
+    }
+    catch (std::exception& e) {
+        throw cRuntimeError("Cannot add statistic '%s' to module %s (NED type: %s): Bad recording modes '%s': %s",
+                statisticName, component->getFullPath().c_str(), component->getNedTypeName(), recordingModes, e.what());
+    }
+}
+
 }  // namespace omnetpp
 
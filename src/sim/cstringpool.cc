@@ -58,6 +58,9 @@ const char *cStringPool::get(const char *s)
     if (!s)
         return nullptr;
 
+#ifdef WITH_THREADED_PARSIM
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
     StringIntMap::iterator it = pool.find(const_cast<char *>(s));
     if (it == pool.end()) {
         // allocate new string
@@ -82,6 +85,9 @@ const char *cStringPool::peek(const char *s) const
     if (!s)
         return nullptr;
 
+#ifdef WITH_THREADED_PARSIM
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
     StringIntMap::const_iterator it = pool.find(const_cast<char *>(s));
     return it == pool.end() ? nullptr : it->first;
 }
@@ -97,6 +103,9 @@ void cStringPool::release(const char *s)
         return;
     }
 
+#ifdef WITH_THREADED_PARSIM
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
     StringIntMap::iterator it = pool.find(const_cast<char *>(s));
 
     // sanity checks
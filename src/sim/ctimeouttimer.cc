@@ -0,0 +1,100 @@
+//========================================================================
+//  CTIMEOUTTIMER.CC - part of
+//                 OMNeT++/OMNEST
+//              Discrete System Simulation in C++
+//
+//========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <sstream>
+#include "omnetpp/globals.h"
+#include "omnetpp/ctimeouttimer.h"
+
+namespace omnetpp {
+
+Register_Class(cTimeoutTimer);
+
+cTimeoutTimer::cTimeoutTimer(const cTimeoutTimer& timer) : cMessage(timer)
+{
+    copy(timer);
+}
+
+cTimeoutTimer::cTimeoutTimer(const char *name, short kind) : cMessage(name, kind)
+{
+    deadlineInsertOrder = -1;
+}
+
+cTimeoutTimer::~cTimeoutTimer()
+{
+}
+
+cTimeoutTimer& cTimeoutTimer::operator=(const cTimeoutTimer& timer)
+{
+    if (this == &timer)
+        return *this;
+    cMessage::operator=(timer);
+    copy(timer);
+    return *this;
+}
+
+void cTimeoutTimer::copy(const cTimeoutTimer& timer)
+{
+    // the deadline belongs to the FES event of the other timer, so it is not copied
+    setFlag(FL_ISDEFERRED, false);
+    deadline = SIMTIME_ZERO;
+    deadlineInsertOrder = -1;
+}
+
+std::string cTimeoutTimer::str() const
+{
+    if (!hasDeadline())
+        return cMessage::str();
+    std::stringstream out;
+    out << "deadline=" << deadline << "; " << cMessage::str();
+    return out.str();
+}
+
+bool cTimeoutTimer::hasDeadline() const
+{
+    // a deadline only applies to the FES event it was set for; cancelling or
+    // rescheduling the timer in any other way invalidates it, because the
+    // FES assigns a new insertion order on every insertion
+    return isDeferred() && isScheduled() && getInsertOrder() == deadlineInsertOrder;
+}
+
+simtime_t cTimeoutTimer::getDeadline() const
+{
+    if (!isScheduled())
+        return -1;
+    return hasDeadline() ? deadline : getArrivalTime();
+}
+
+void cTimeoutTimer::setDeadline(simtime_t t)
+{
+    ASSERT(isScheduled() && t >= getArrivalTime());
+    deadline = t;
+    deadlineInsertOrder = getInsertOrder();
+    setFlag(FL_ISDEFERRED, t > getArrivalTime());
+}
+
+bool cTimeoutTimer::deferToDeadline()
+{
+    // note: the timer has already been removed from the FES (so isScheduled()
+    // is false), but its insertion order is still that of the removed event
+    bool valid = getInsertOrder() == deadlineInsertOrder && deadline > getArrivalTime();
+    setFlag(FL_ISDEFERRED, false);
+    if (!valid)
+        return false;
+    setArrivalTime(deadline);
+    return true;
+}
+
+}  // namespace omnetpp
+
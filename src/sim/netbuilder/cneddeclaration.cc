@@ -52,6 +52,8 @@ cNedDeclaration::~cNedDeclaration()
     for (auto & pattern : patterns)
         delete pattern.matcher;
 
+    delete instantiationPlan;
+
     for (auto & submodulePattern : submodulePatterns) {
         std::vector<PatternData>& patternDataItems = submodulePattern.second;
         for (auto & item : patternDataItems)
@@ -351,6 +353,78 @@ void cNedDeclaration::putSharedParImplFor(NedElement *node, cParImpl *value)
         parimplMap[node->getId()] = value;
 }
 
+cComponentType *cNedDeclaration::getResolvedComponentType(const std::string& key)
+{
+    // component types registered since (e.g. from NED files loaded later) may change the outcome
+    int numComponentTypes = componentTypes.getInstance()->size();
+    if (numComponentTypes != numComponentTypesWhenResolved) {
+        resolvedComponentTypes.clear();
+        numComponentTypesWhenResolved = numComponentTypes;
+    }
+    auto it = resolvedComponentTypes.find(key);
+    return it == resolvedComponentTypes.end() ? nullptr : it->second;
+}
+
+void cNedDeclaration::putResolvedComponentType(const std::string& key, cComponentType *type)
+{
+    resolvedComponentTypes[key] = type;
+}
+
+const cNedDeclaration::InstantiationPlan& cNedDeclaration::getInstantiationPlan()
+{
+    if (!instantiationPlan) {
+        InstantiationPlan *plan = new InstantiationPlan();
+        fillInstantiationPlan(plan);
+        instantiationPlan = plan;
+    }
+    return *instantiationPlan;
+}
+
+void cNedDeclaration::fillInstantiationPlan(InstantiationPlan *plan)
+{
+    // this must yield the same order as the network builder used to follow
+    // when it walked the inheritance chain itself: base types first
+    for (cNedDeclaration *d : getInheritanceChain()) {
+        if (ParametersElement *paramsNode = d->getParametersElement()) {
+            for (ParamElement *paramNode = paramsNode->getFirstParamChild(); paramNode; paramNode = paramNode->getNextParamSibling()) {
+                if (!paramNode->getIsPattern()) {
+                    plan->params.push_back({d, paramNode});
+                    if (paramNode->getType() != PARTYPE_NONE)
+                        plan->numNewParams++;
+                }
+            }
+        }
+
+        if (GatesElement *gatesNode = d->getGatesElement()) {
+            for (GateElement *gateNode = gatesNode->getFirstGateChild(); gateNode; gateNode = gateNode->getNextGateSibling()) {
+                plan->gates.push_back({d, gateNode});
+                if (gateNode->getIsVector() && !opp_isempty(gateNode->getVectorSize()))
+                    plan->gateSizes.push_back({d, gateNode});
+            }
+        }
+
+        if (SubmodulesElement *submodsNode = d->getSubmodulesElement())
+            for (SubmoduleElement *submodNode = submodsNode->getFirstSubmoduleChild(); submodNode; submodNode = submodNode->getNextSubmoduleSibling())
+                plan->submodulesAndConnections.push_back({d, submodNode});
+
+        if (ConnectionsElement *connsNode = d->getConnectionsElement()) {
+            if (connsNode->getAllowUnconnected())
+                plan->allowUnconnected = true;
+            for (NedElement *child = connsNode->getFirstChild(); child; child = child->getNextSibling()) {
+                if (child->getTagCode() == NED_CONNECTION) {
+                    plan->submodulesAndConnections.push_back({d, child});
+                    plan->connectionsById[child->getId()] = (ConnectionElement *)child;
+                }
+                else if (child->getTagCode() == NED_CONNECTION_GROUP) {
+                    plan->submodulesAndConnections.push_back({d, child});
+                    for (ConnectionElement *conn = ((ConnectionGroupElement *)child)->getFirstConnectionChild(); conn; conn = conn->getNextConnectionSibling())
+                        plan->connectionsById[conn->getId()] = conn;
+                }
+            }
+        }
+    }
+}
+
 const std::vector<cNedDeclaration::PatternData>& cNedDeclaration::getParamPatterns()
 {
     if (!patternsValid) {
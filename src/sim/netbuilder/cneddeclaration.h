@@ -34,6 +34,8 @@ namespace omnetpp {
 
 namespace common { class PatternMatcher; };
 
+class cComponentType;
+
 using namespace omnetpp::nedxml;
 
 /**
@@ -51,6 +53,10 @@ using namespace omnetpp::nedxml;
  *    gates are included, and values (parameters and gate sizes) are
  *    converted into and stored in cPar form.
  *  - properties, merged along the inheritance chain.
+ *  - the "instantiation plan": a flattened view of the parameters, gates,
+ *    submodules and connections of the type and its super types, so that
+ *    the network builder need not walk the inheritance chain and the
+ *    NedElement trees again for every instance.
  *
  * @ingroup Internals
  */
@@ -59,6 +65,26 @@ class SIM_API cNedDeclaration : public NedTypeInfo
   public:
     typedef omnetpp::common::PatternMatcher PatternMatcher;
     struct PatternData {PatternMatcher *matcher; ParamElement *patternNode;};
+
+    /**
+     * Flattened, immutable description of a NED type for instantiating it,
+     * computed on first use. Elements are in base-to-derived order, each one
+     * paired with the declaration it occurs in, because that is the context
+     * for type name lookups and cached expressions.
+     */
+    struct InstantiationPlan {
+        struct ParamItem {cNedDeclaration *decl; ParamElement *node;};
+        struct GateItem {cNedDeclaration *decl; GateElement *node;};
+        struct BuildItem {cNedDeclaration *decl; NedElement *node;};  // SubmoduleElement, ConnectionElement or ConnectionGroupElement
+        std::vector<ParamItem> params;     // non-pattern parameter declarations and assignments
+        int numNewParams = 0;              // number of items in params[] that declare a new parameter
+        std::vector<GateItem> gates;       // gate declarations
+        std::vector<GateItem> gateSizes;   // gate vectors with a size expression
+        std::vector<BuildItem> submodulesAndConnections;  // in creation order
+        std::map<long, ConnectionElement*> connectionsById;  // all connections, including those in connection groups
+        bool allowUnconnected = false;     // whether this type or a super type has "allowunconnected"
+    };
+
   protected:
     // properties
     typedef std::map<std::string, cProperties *> StringPropsMap;
@@ -82,6 +108,14 @@ class SIM_API cNedDeclaration : public NedTypeInfo
     // super types in base-to-derived order, including (and ending with) the "this" pointer; empty if unfilled
     std::vector<cNedDeclaration*> inheritanceChain;
 
+    // computed on first use
+    InstantiationPlan *instantiationPlan = nullptr;
+
+    // component types resolved in the context of this declaration, keyed by type name (and interface name);
+    // only valid while the number of registered component types stays the same
+    std::map<std::string, cComponentType*> resolvedComponentTypes;
+    int numComponentTypesWhenResolved = -1;
+
   protected:
     void putIntoPropsMap(StringPropsMap& propsMap, const std::string& name, cProperties *props) const;
     cProperties *getFromPropsMap(const StringPropsMap& propsMap, const std::string& name) const;
@@ -100,6 +134,7 @@ class SIM_API cNedDeclaration : public NedTypeInfo
     cProperties *doSubmoduleProperties(const char *submoduleName, const char *submoduleType) const;
     cProperties *doConnectionProperties(int connectionId, const char *channelType) const;
     void collectPatternsFrom(ParametersElement *paramsNode, std::vector<PatternData>& v);
+    void fillInstantiationPlan(InstantiationPlan *plan);
 
   public:
     /** @name Constructors, destructor, assignment */
@@ -141,6 +176,11 @@ class SIM_API cNedDeclaration : public NedTypeInfo
     virtual const std::vector<PatternData>& getSubmoduleParamPatterns(const char *submoduleName);
 
     // NOTE: connections have no submodules or sub-channels, so they cannot contain pattern-based param assignments either
+
+    /**
+     * Returns the instantiation plan of this type, computing it on the first call.
+     */
+    virtual const InstantiationPlan& getInstantiationPlan();
     //@}
 
     /** @name Properties of this type, its parameters, gates etc. */
@@ -157,6 +197,12 @@ class SIM_API cNedDeclaration : public NedTypeInfo
     virtual cParImpl *getSharedParImplFor(NedElement *node);
     virtual void putSharedParImplFor(NedElement *node, cParImpl *value);
     //@}
+
+    /** @name Caching of component types resolved in the context of this declaration, see cNedNetworkBuilder */
+    //@{
+    virtual cComponentType *getResolvedComponentType(const std::string& key);
+    virtual void putResolvedComponentType(const std::string& key, cComponentType *type);
+    //@}
 };
 
 }  // namespace omnetpp
@@ -79,6 +79,11 @@ void cNedLoader::registerNedType(const char *qname, bool isInnerType, NedElement
         componentTypes.getInstance()->add(type);
 }
 
+void cNedLoader::printWarning(const char *message)
+{
+    getEnvir()->printfmsg("Warning: %s", message);
+}
+
 cNedDeclaration *cNedLoader::getDecl(const char *qname) const
 {
     cNedDeclaration *decl = dynamic_cast<cNedDeclaration *>(NedResourceCache::getDecl(qname));
@@ -65,6 +65,9 @@ class SIM_API cNedLoader : public NedResourceCache
     // reimplemented so that we can add cModuleType/cChannelType
     virtual void registerNedType(const char *qname, bool isInnerType, NedElement *node) override;
 
+    // reimplemented so that warnings go through the user interface
+    virtual void printWarning(const char *message) override;
+
   public:
     virtual ~cNedLoader();
 
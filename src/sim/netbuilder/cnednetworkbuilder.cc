@@ -103,9 +103,15 @@ void cNedNetworkBuilder::addParametersAndGatesTo(cComponent *component, cNedDecl
         const char *parentNedTypeName = parentModule->getNedTypeName();
         cNedDeclaration *parentDecl = cNedLoader::getInstance()->getDecl(parentNedTypeName);
         if (parentDecl) {  // i.e. parent was created via NED-based componentType
-            NedElement *subcomponentNode = component->isModule() ?
-                (NedElement *)parentDecl->getSubmoduleElement(component->getName()) :
-                (NedElement *)parentDecl->getConnectionElement(((cChannel *)component)->getNedConnectionElementId());
+            NedElement *subcomponentNode = nullptr;
+            if (component->isModule())
+                subcomponentNode = parentDecl->getSubmoduleElement(component->getName());
+            else {
+                const auto& connections = parentDecl->getInstantiationPlan().connectionsById;
+                auto it = connections.find(((cChannel *)component)->getNedConnectionElementId());
+                if (it != connections.end())
+                    subcomponentNode = it->second;
+            }
             if (subcomponentNode)
                 assignSubcomponentParams(component, subcomponentNode);
         }
@@ -116,27 +122,19 @@ void cNedNetworkBuilder::addParametersAndGatesTo(cComponent *component, cNedDecl
 
 void cNedNetworkBuilder::doAddParametersAndGatesTo(cComponent *component, cNedDeclaration *decl)
 {
-    // TODO for performance: component->reallocParamv(decl->getParameterDeclarations().size());
-
-    // recursively add and assign super types' parameters
-    if (decl->numExtendsNames() > 0) {
-        const char *superName = decl->getExtendsName(0);
-        cNedDeclaration *superDecl = cNedLoader::getInstance()->getDecl(superName);
-        doAddParametersAndGatesTo(component, superDecl);
-    }
-
-    // add this decl parameters / assignments
-    ParametersElement *paramsNode = decl->getParametersElement();
-    if (paramsNode) {
-        currentDecl = decl;  // switch "context"
-        doParams(component, paramsNode, false);
+    // parameters and gates of the type and its super types, in base-to-derived order
+    const InstantiationPlan& plan = decl->getInstantiationPlan();
+    if (plan.numNewParams > 0)
+        component->reallocParamv(component->getNumParams() + plan.numNewParams);
+
+    for (const auto& item : plan.params) {
+        currentDecl = item.decl;  // switch "context"
+        doParam(component, item.node, false);
     }
 
-    // add this decl's gates (if there are any)
-    GatesElement *gatesNode = decl->getGatesElement();
-    if (gatesNode) {
-        currentDecl = decl;  // switch "context"
-        doGates((cModule *)component, gatesNode, false);
+    for (const auto& item : plan.gates) {
+        currentDecl = item.decl;  // switch "context"
+        doGate((cModule *)component, item.node, false);
     }
 }
 
@@ -266,13 +264,6 @@ void cNedNetworkBuilder::doParam(cComponent *component, ParamElement *paramNode,
     }
 }
 
-void cNedNetworkBuilder::doGates(cModule *module, GatesElement *gatesNode, bool isSubcomponent)
-{
-    ASSERT(gatesNode != nullptr);
-    for (NedElement *child = gatesNode->getFirstChildWithTag(NED_GATE); child; child = child->getNextSiblingWithTag(NED_GATE))
-        doGate(module, (GateElement *)child, isSubcomponent);
-}
-
 void cNedNetworkBuilder::doGate(cModule *module, GateElement *gateNode, bool isSubcomponent)
 {
     try {
@@ -360,10 +351,9 @@ void cNedNetworkBuilder::doAssignParameterFromPattern(cPar& par, ParamElement *p
         cParImpl *impl = par.copyIfShared();
         ExprRef valueExpr(patternNode, ParamElement::ATT_VALUE);
         if (!valueExpr.empty()) {
-            // assign the parameter
+            // assign the parameter; the expression is parsed only once, and copied for each parameter
             ASSERT(impl == par.impl() && !impl->isShared());
-            cDynamicExpression *expr = new cDynamicExpression();
-            expr->parseNedExpr(valueExpr.getExprText(), isInSubcomponent, false);
+            cDynamicExpression *expr = getOrCreateExpression(valueExpr, isInSubcomponent)->dup();
             impl->setBaseDirectory(patternNode->getSourceFileDirectory());
             impl->setExpression(expr);
             if (expr->isAConstant())
@@ -444,18 +434,10 @@ void cNedNetworkBuilder::doGateSize(cModule *module, GateElement *gateNode, bool
 
 void cNedNetworkBuilder::setupGateVectors(cModule *module, cNedDeclaration *decl)
 {
-    // recursively add super types' gates
-    if (decl->numExtendsNames() > 0) {
-        const char *superName = decl->getExtendsName(0);
-        cNedDeclaration *superDecl = cNedLoader::getInstance()->getDecl(superName);
-        setupGateVectors(module, superDecl);
-    }
-
-    // add this decl's gatesizes
-    GatesElement *gatesNode = decl->getGatesElement();
-    if (gatesNode) {
-        currentDecl = decl;  // switch "context"
-        doGateSizes(module, gatesNode, false);
+    // gate sizes in the type and its super types, in base-to-derived order
+    for (const auto& item : decl->getInstantiationPlan().gateSizes) {
+        currentDecl = item.decl;  // switch "context"
+        doGateSize(module, item.node, false);
     }
 }
 
@@ -475,14 +457,20 @@ void cNedNetworkBuilder::buildInside(cModule *modp, cNedDeclaration *decl)
     }
 
     // add submodules and connections. Submodules and connections are inherited:
-    // we need to start start with the the base classes, and do this compound
-    // module last.
+    // the instantiation plan lists them starting with the base classes, and
+    // this compound module last.
+    const InstantiationPlan& plan = decl->getInstantiationPlan();
     submodMap.clear();
-    buildRecursively(modp, decl);
+    for (const auto& item : plan.submodulesAndConnections) {
+        currentDecl = item.decl;  // switch "context"
+        if (item.node->getTagCode() == NED_SUBMODULE)
+            addSubmodule(modp, (SubmoduleElement *)item.node);
+        else
+            addConnectionOrConnectionGroup(modp, item.node);
+    }
 
-    // check if there are unconnected gates left -- unless unconnected gates were already permitted in the super type
-    ConnectionsElement *conns = decl->getConnectionsElement();
-    if ((!conns || !conns->getAllowUnconnected()) && !superTypeAllowsUnconnected(decl))
+    // check if there are unconnected gates left -- unless unconnected gates were permitted here or in a super type
+    if (!plan.allowUnconnected)
         modp->checkInternalConnections();
 
     // recursively build the submodules too (top-down)
@@ -491,50 +479,6 @@ void cNedNetworkBuilder::buildInside(cModule *modp, cNedDeclaration *decl)
         (*it)->buildInside();
 }
 
-void cNedNetworkBuilder::buildRecursively(cModule *modp, cNedDeclaration *decl)
-{
-    // recursively add super types' submodules and connections
-    if (decl->numExtendsNames() > 0) {
-        const char *superName = decl->getExtendsName(0);
-        cNedDeclaration *superDecl = cNedLoader::getInstance()->getDecl(superName);
-        buildRecursively(modp, superDecl);
-    }
-
-    currentDecl = decl;  // switch "context"
-    addSubmodulesAndConnections(modp);
-}
-
-void cNedNetworkBuilder::addSubmodulesAndConnections(cModule *modp)
-{
-    SubmodulesElement *submods = currentDecl->getSubmodulesElement();
-    if (submods)
-        for (SubmoduleElement *submod = submods->getFirstSubmoduleChild(); submod; submod = submod->getNextSubmoduleSibling())
-            addSubmodule(modp, submod);
-
-
-    // loop through connections and add them
-    ConnectionsElement *conns = currentDecl->getConnectionsElement();
-    if (conns)
-        for (NedElement *child = conns->getFirstChild(); child; child = child->getNextSibling())
-            if (child->getTagCode() == NED_CONNECTION || child->getTagCode() == NED_CONNECTION_GROUP)
-                addConnectionOrConnectionGroup(modp, child);
-
-}
-
-bool cNedNetworkBuilder::superTypeAllowsUnconnected(cNedDeclaration *decl) const
-{
-    // follow through the inheritance chain, and return true if we find an "allowunconnected" anywhere
-    while (decl->numExtendsNames() > 0) {
-        const char *superName = decl->getExtendsName(0);
-        decl = cNedLoader::getInstance()->getDecl(superName);
-        ASSERT(decl);  // all super classes must be loaded before we start building
-        ConnectionsElement *conns = decl->getConnectionsElement();
-        if (conns && conns->getAllowUnconnected())
-            return true;
-    }
-    return false;
-}
-
 std::string cNedNetworkBuilder::resolveComponentType(const NedLookupContext& context, const char *nedTypeName)
 {
     // Resolve a NED module/channel type name, for a submodule or channel
@@ -547,7 +491,11 @@ std::string cNedNetworkBuilder::resolveComponentType(const NedLookupContext& con
 
 cModuleType *cNedNetworkBuilder::findAndCheckModuleType(const char *modTypeName, cModule *modp, const char *submodName)
 {
-    // TODO cache the result to speed up further lookups
+    // resolution only depends on the NED declaration we're in, so it can be cached there
+    std::string key = std::string("module:") + modTypeName;
+    if (cComponentType *cachedType = currentDecl->getResolvedComponentType(key))
+        return (cModuleType *)cachedType;
+
     NedLookupContext context(currentDecl->getTree(), currentDecl->getFullName());
     std::string qname = resolveComponentType(context, modTypeName);
     if (qname.empty())
@@ -557,12 +505,16 @@ cModuleType *cNedNetworkBuilder::findAndCheckModuleType(const char *modTypeName,
     if (!dynamic_cast<cModuleType *>(componentType))
         throw cRuntimeError(modp, "Submodule %s: '%s' is not a module type",
                 submodName, qname.c_str());
+    currentDecl->putResolvedComponentType(key, componentType);
     return (cModuleType *)componentType;
 }
 
 cModuleType *cNedNetworkBuilder::findAndCheckModuleTypeLike(const char *modTypeName, const char *likeType, cModule *modp, const char *submodName)
 {
-    // TODO cache the result to speed up further lookups
+    // resolution only depends on the NED declaration we're in, so it can be cached there
+    std::string key = std::string("module:") + modTypeName + " like " + likeType;
+    if (cComponentType *cachedType = currentDecl->getResolvedComponentType(key))
+        return (cModuleType *)cachedType;
 
     // resolve the interface
     NedLookupContext context(currentDecl->getTree(), currentDecl->getFullName());
@@ -588,6 +540,7 @@ cModuleType *cNedNetworkBuilder::findAndCheckModuleTypeLike(const char *modTypeN
     if (!dynamic_cast<cModuleType *>(componenttype))
         throw cRuntimeError(modp, "Submodule %s: '%s' is not a module type",
                 submodName, candidates[0].c_str());
+    currentDecl->putResolvedComponentType(key, componenttype);
     return (cModuleType *)componenttype;
 }
 
@@ -1209,7 +1162,11 @@ cChannel *cNedNetworkBuilder::createChannel(ConnectionElement *conn, cModule *pa
 
 cChannelType *cNedNetworkBuilder::findAndCheckChannelType(const char *channelTypeName, cModule *modp)
 {
-    // TODO cache the result to speed up further lookups
+    // resolution only depends on the NED declaration we're in, so it can be cached there
+    std::string key = std::string("channel:") + channelTypeName;
+    if (cComponentType *cachedType = currentDecl->getResolvedComponentType(key))
+        return (cChannelType *)cachedType;
+
     NedLookupContext context(currentDecl->getTree(), currentDecl->getFullName());
     std::string qname = resolveComponentType(context, channelTypeName);
     if (qname.empty())
@@ -1218,12 +1175,16 @@ cChannelType *cNedNetworkBuilder::findAndCheckChannelType(const char *channelTyp
     cComponentType *componentType = cComponentType::find(qname.c_str());
     if (!dynamic_cast<cChannelType *>(componentType))
         throw cRuntimeError(modp, "'%s' is not a channel type", qname.c_str());
+    currentDecl->putResolvedComponentType(key, componentType);
     return (cChannelType *)componentType;
 }
 
 cChannelType *cNedNetworkBuilder::findAndCheckChannelTypeLike(const char *channelTypeName, const char *likeType, cModule *modp)
 {
-    // TODO cache the result to speed up further lookups
+    // resolution only depends on the NED declaration we're in, so it can be cached there
+    std::string key = std::string("channel:") + channelTypeName + " like " + likeType;
+    if (cComponentType *cachedType = currentDecl->getResolvedComponentType(key))
+        return (cChannelType *)cachedType;
 
     // resolve the interface
     NedLookupContext context(currentDecl->getTree(), currentDecl->getFullName());
@@ -1246,6 +1207,7 @@ cChannelType *cNedNetworkBuilder::findAndCheckChannelTypeLike(const char *channe
     cComponentType *componenttype = cComponentType::find(candidates[0].c_str());
     if (!dynamic_cast<cChannelType *>(componenttype))
         throw cRuntimeError(modp, "'%s' is not a channel type", candidates[0].c_str());
+    currentDecl->putResolvedComponentType(key, componenttype);
     return (cChannelType *)componenttype;
 }
 
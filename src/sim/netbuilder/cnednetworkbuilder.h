@@ -54,6 +54,7 @@ class SIM_API cNedNetworkBuilder
     };
 
     typedef cNedDeclaration::PatternData PatternData;  // abbreviation
+    typedef cNedDeclaration::InstantiationPlan InstantiationPlan;  // abbreviation
 
   protected:
     // the current NED declaration we're working with. Stored here to
@@ -68,9 +69,6 @@ class SIM_API cNedNetworkBuilder
 
   protected:
     cModule *_submodule(cModule *parentmodp, const char *submodName, int idx=-1);
-    void addSubmodulesAndConnections(cModule *modp);
-    bool superTypeAllowsUnconnected(cNedDeclaration *decl) const;
-    void buildRecursively(cModule *modp, cNedDeclaration *decl);
     std::string resolveComponentType(const NedLookupContext& context, const char *nedTypeName);
     cModuleType *findAndCheckModuleType(const char *modtypename, cModule *modp, const char *submodName);
     cModuleType *findAndCheckModuleTypeLike(const char *modTypeName, const char *likeType, cModule *modp, const char *submodName);
@@ -86,7 +84,6 @@ class SIM_API cNedNetworkBuilder
     static cGate::Type translateGateType(int t);
     void doParams(cComponent *component, ParametersElement *paramsNode, bool isSubcomponent);
     void doParam(cComponent *component, ParamElement *paramNode, bool isSubcomponent);
-    void doGates(cModule *component, GatesElement *gatesNode, bool isSubcomponent);
     void doGate(cModule *component, GateElement *gateNode, bool isSubcomponent);
     void doGateSizes(cModule *component, GatesElement *gatesNode, bool isSubcomponent);
     void doGateSize(cModule *component, GateElement *gateNode, bool isSubcomponent);
@@ -18,6 +18,8 @@
   `license' for details on this and other legal matters.
 *--------------------------------------------------------------*/
 
+#include <cstring>
+#include <utility>
 #include "omnetpp/cexception.h"
 #include "ccommbufferbase.h"
 
@@ -73,28 +75,31 @@ void cCommBufferBase::reset()
     mPosition = 0;
 }
 
+void cCommBufferBase::swap(cCommBufferBase *other)
+{
+    std::swap(mBuffer, other->mBuffer);
+    std::swap(mBufferSize, other->mBufferSize);
+    std::swap(mMsgSize, other->mMsgSize);
+    std::swap(mPosition, other->mPosition);
+}
+
 void cCommBufferBase::extendBufferFor(int dataSize)
 {
-    // TBD move reallocate+copy out of loop (more efficient)
-    while (mMsgSize+dataSize >= mBufferSize) {
-        // increase the size of the buffer while
-        // retaining its own existing contents
-        char *tempBuffer;
-        int i, oldBufferSize = 0;
-
-        oldBufferSize = mBufferSize;
-        if (mBufferSize == 0)
-            mBufferSize = 1000;
-        else
-            mBufferSize += mBufferSize;
-
-        tempBuffer = new char[mBufferSize];
-        for (i = 0; i < oldBufferSize; i++)
-            tempBuffer[i] = mBuffer[i];
+    if (mMsgSize+dataSize < mBufferSize)
+        return;
 
-        delete[] mBuffer;
-        mBuffer = tempBuffer;
-    }
+    // find the new size first, so that the contents are copied only once
+    int newBufferSize = mBufferSize == 0 ? 1000 : mBufferSize;
+    while (mMsgSize+dataSize >= newBufferSize)
+        newBufferSize += newBufferSize;
+
+    // increase the size of the buffer while retaining its existing contents
+    char *tempBuffer = new char[newBufferSize];
+    if (mBufferSize > 0)
+        memcpy(tempBuffer, mBuffer, mBufferSize);
+    delete[] mBuffer;
+    mBuffer = tempBuffer;
+    mBufferSize = newBufferSize;
 }
 
 bool cCommBufferBase::isBufferEmpty() const
@@ -81,9 +81,15 @@ class SIM_API cCommBufferBase : public cCommBuffer
     int getMessageSize() const;
 
     /**
-     * Reset buffer to an empty state.
+     * Reset buffer to an empty state. The allocated memory is kept.
      */
-    void reset();
+    virtual void reset();
+
+    /**
+     * Exchanges the contents of this buffer (data, message size and
+     * unpacking position) with that of the other one, without copying.
+     */
+    void swap(cCommBufferBase *other);
 
     /**
      * Returns true if all data in buffer was used up during unpacking.
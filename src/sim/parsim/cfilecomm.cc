@@ -36,6 +36,7 @@
 #include "omnetpp/platdep/platmisc.h"
 #include "cfilecomm.h"
 #include "cfilecommbuffer.h"
+#include "cparsimprofiler.h"
 #include "parsimutil.h"
 
 using namespace omnetpp::common;
@@ -120,6 +121,9 @@ void cFileCommunications::send(cCommBuffer *buffer, int tag, int destination)
     strcpy(fname2+strlen(fname2)-4, ".msg");
     if (rename(fname, fname2) != 0)
         throw cRuntimeError("cFileCommunications: Cannot rename %s to %s: %s", fname, fname2, strerror(errno));
+
+    if (profiler)
+        profiler->bufferSent(destination, tag, b->getMessageSize());
 }
 
 bool cFileCommunications::receiveBlocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
@@ -185,6 +189,8 @@ bool cFileCommunications::receiveNonblocking(int filtTag, cCommBuffer *buffer, i
             ;
         fclose(f);
         b->setMessageSize(len);
+        if (profiler)
+            profiler->bufferReceived(sourceProcId, receivedTag, len);
 
         if (preserveReadFiles) {
             // move file to 'read' directory
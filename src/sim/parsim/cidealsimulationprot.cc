@@ -84,6 +84,9 @@ void cIdealSimulationProtocol::processReceivedMessage(cMessage *msg, int destMod
 
 cEvent *cIdealSimulationProtocol::takeNextEvent()
 {
+    // send out messages batched during the previous event (if batching is enabled)
+    flushOutgoingMessages();
+
     // if no more local events, wait for something to come from other partitions
     while (sim->getFES()->isEmpty())
         if (!receiveBlocking())
@@ -18,6 +18,7 @@
   `license' for details on this and other legal matters.
 *--------------------------------------------------------------*/
 
+#include <algorithm>
 #include "omnetpp/csimulation.h"
 #include "omnetpp/cmessage.h"
 #include "omnetpp/cenvir.h"
@@ -58,11 +59,15 @@ void cLinkDelayLookahead::startRun()
     int myProcId = comm->getProcId();
 
     // temporarily initialize everything to zero.
-    for (int i = 0; i < numSeg; i++)
+    for (int i = 0; i < numSeg; i++) {
         segInfo[i].minDelay = -1;
+        segInfo[i].maxPromisedSendTime = 0;
+    }
+    links.clear();
 
     // fill in minDelays
     EV << "  calculating minimum link delays...\n";
+    std::vector<cProxyGate *> proxyGates;
     for (int modId = 0; modId <= sim->getLastComponentId(); modId++) {
         cPlaceholderModule *mod = dynamic_cast<cPlaceholderModule *>(sim->getModule(modId));
         if (mod) {
@@ -82,11 +87,23 @@ void cLinkDelayLookahead::startRun()
                     int procId = pg->getRemoteProcId();
                     if (segInfo[procId].minDelay == -1 || segInfo[procId].minDelay > linkDelay)
                         segInfo[procId].minDelay = linkDelay;
+
+                    LinkInfo link;
+                    link.delay = linkDelay;
+                    link.promisedSendTime = 0;
+                    links.push_back(link);
+                    proxyGates.push_back(pg);
                 }
             }
         }
     }
 
+    // links[] is complete, so pointers into it are now stable
+    for (int i = 0; i < (int)links.size(); i++) {
+        proxyGates[i]->setSynchData(&links[i]);
+        segInfo[proxyGates[i]->getRemoteProcId()].links.push_back(&links[i]);
+    }
+
     // if two partitions are not connected, the lookeahead is "infinity"
     for (int i = 0; i < numSeg; i++)
         if (i != myProcId && segInfo[i].minDelay == -1)
@@ -118,11 +135,19 @@ void cLinkDelayLookahead::endRun()
 {
     delete[] segInfo;
     segInfo = nullptr;
+    links.clear();
 }
 
-simtime_t cLinkDelayLookahead::getCurrentLookahead(cMessage *, int procId, void *)
+simtime_t cLinkDelayLookahead::getCurrentLookahead(cMessage *msg, int procId, void *data)
 {
-    return segInfo[procId].minDelay;
+    LinkInfo *link = (LinkInfo *)data;
+    if (link && msg->getSendingTime() < link->promisedSendTime)
+        throw cRuntimeError("cLinkDelayLookahead: Message '%s' sent via gate '%s' of module '%s' at t=%s, although the module promised not to send on that link before t=%s",
+                msg->getName(), msg->getSenderGate() ? msg->getSenderGate()->getFullName() : "n/a",
+                msg->getSenderModule() ? msg->getSenderModule()->getFullPath().c_str() : "n/a",
+                SIMTIME_STR(msg->getSendingTime()), SIMTIME_STR(link->promisedSendTime));
+    simtime_t now = sim->getSimTime();
+    return getCurrentEOT(procId, now) - now;
 }
 
 simtime_t cLinkDelayLookahead::getCurrentLookahead(int procId)
@@ -130,5 +155,33 @@ simtime_t cLinkDelayLookahead::getCurrentLookahead(int procId)
     return segInfo[procId].minDelay;
 }
 
+simtime_t cLinkDelayLookahead::getCurrentEOT(int procId, simtime_t now)
+{
+    PartitionInfo& seg = segInfo[procId];
+    if (seg.maxPromisedSendTime <= now || seg.minDelay == SIMTIME_MAX)
+        return now + seg.minDelay;  // no promise in effect
+
+    simtime_t eot = SIMTIME_MAX;
+    for (LinkInfo *link : seg.links) {
+        simtime_t sendTime = std::max(now, link->promisedSendTime);
+        if (sendTime < SIMTIME_MAX - link->delay && sendTime + link->delay < eot)
+            eot = sendTime + link->delay;
+    }
+    return eot;
+}
+
+void cLinkDelayLookahead::promiseEarliestSendTime(simtime_t t, int procId, void *data)
+{
+    LinkInfo *link = (LinkInfo *)data;
+    if (!link)
+        throw cRuntimeError("Internal parallel simulation error: cProxyGate has no associated data pointer");
+    if (t < link->promisedSendTime && link->promisedSendTime > sim->getSimTime())
+        throw cRuntimeError("cLinkDelayLookahead: Cannot decrease the promised earliest send time of a link from t=%s to t=%s",
+                SIMTIME_STR(link->promisedSendTime), SIMTIME_STR(t));
+    link->promisedSendTime = t;
+    if (t > segInfo[procId].maxPromisedSendTime)
+        segInfo[procId].maxPromisedSendTime = t;
+}
+
 }  // namespace omnetpp
 
@@ -21,6 +21,7 @@
 #ifndef __OMNETPP_CLINKDELAYLOOKAHEAD_H
 #define __OMNETPP_CLINKDELAYLOOKAHEAD_H
 
+#include <vector>
 #include "cnmplookahead.h"
 
 namespace omnetpp {
@@ -28,21 +29,39 @@ namespace omnetpp {
 class cGate;
 
 /**
- * @brief Lookahead calculation based on inter-partition link delays only.
+ * @brief Lookahead calculation based on inter-partition link delays,
+ * and on the earliest send times promised by modules.
+ *
+ * Without promises, the lookahead towards a partition is the minimum of the
+ * delays of the links leading there. When a module promises not to send
+ * on a link before some time t (see cSimpleModule::promiseEarliestSendTime()),
+ * the earliest arrival time over that link is t plus the link delay instead
+ * of the current simulation time plus the link delay, and the EOT towards
+ * the partition is the minimum of the earliest arrival times over its links.
+ * Sending a message on a link before the promised time is an error.
  *
  * @ingroup Parsim
  */
 class SIM_API cLinkDelayLookahead : public cNMPLookahead
 {
   protected:
+    struct LinkInfo
+    {
+        simtime_t delay;             // total delay along the path to the proxy gate
+        simtime_t promisedSendTime;  // no message will be sent on the link before this time
+    };
+
     struct PartitionInfo
     {
         simtime_t minDelay;  // minimum of all link delays to given partition
+        std::vector<LinkInfo *> links;  // links to the partition
+        simtime_t maxPromisedSendTime;  // maximum of promisedSendTime over links
     };
 
     // partition information
     int numSeg;              // number of partitions
     PartitionInfo *segInfo;  // partition info array, size numSeg
+    std::vector<LinkInfo> links;  // the proxy gates' synch data point into this
 
     // calculate the total delay along the path ending the given gate
     simtime_t collectPathDelay(cGate *pathEndGate);
@@ -69,8 +88,9 @@ class SIM_API cLinkDelayLookahead : public cNMPLookahead
     virtual void endRun() override;
 
     /**
-     * Updates lookahead information, based on the delay of the link
-     * where message is sent out. Returns EOT.
+     * Checks that the message does not break a promise made for its link,
+     * and returns the difference between the current EOT and the current
+     * simulation time.
      */
     virtual simtime_t getCurrentLookahead(cMessage *msg, int procId, void *data) override;
 
@@ -78,6 +98,18 @@ class SIM_API cLinkDelayLookahead : public cNMPLookahead
      * Returns minimum of link delays toward the given partition.
      */
     virtual simtime_t getCurrentLookahead(int procId) override;
+
+    /**
+     * Returns the minimum over the links to the given partition of
+     * max(now, promised send time) plus the link delay.
+     */
+    virtual simtime_t getCurrentEOT(int procId, simtime_t now) override;
+
+    /**
+     * Records the promise for the link. Promises cannot be withdrawn:
+     * the time of an unexpired promise cannot be decreased.
+     */
+    virtual void promiseEarliestSendTime(simtime_t t, int procId, void *data) override;
 };
 
 }  // namespace omnetpp
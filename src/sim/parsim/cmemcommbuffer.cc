@@ -44,6 +44,53 @@ cMemCommBuffer::~cMemCommBuffer()
 {
 }
 
+void cMemCommBuffer::reset()
+{
+    cCommBufferBase::reset();
+    externalSegments.clear();
+    externalSize = 0;
+}
+
+void cMemCommBuffer::swap(cMemCommBuffer *other)
+{
+    cCommBufferBase::swap(other);
+    externalSegments.swap(other->externalSegments);
+    std::swap(externalSize, other->externalSize);
+}
+
+void cMemCommBuffer::flatten()
+{
+    if (externalSegments.empty())
+        return;
+
+    int size = getPackedSize();
+    char *newBuffer = new char[size + 4];  // room for sentry, like in allocateAtLeast()
+    int pos = 0;
+    forEachSegment([&](const char *data, int len) {memcpy(newBuffer + pos, data, len); pos += len;});
+    ASSERT(pos == size);
+
+    delete[] mBuffer;
+    mBuffer = newBuffer;
+    mBufferSize = size + 4;
+    mMsgSize = size;
+    externalSegments.clear();
+    externalSize = 0;
+}
+
+void cMemCommBuffer::packExternal(const void *data, int size)
+{
+    if (!zeroCopyEnabled || size < MIN_EXTERNAL_SEGMENT_SIZE) {
+        packBytes(data, size);
+        return;
+    }
+    ExternalSegment segment;
+    segment.offset = mMsgSize;
+    segment.data = (const char *)data;
+    segment.size = size;
+    externalSegments.push_back(segment);
+    externalSize += size;
+}
+
 void cMemCommBuffer::pack(char d)
 {
     extendBufferFor(sizeof(char));
@@ -147,6 +194,8 @@ void cMemCommBuffer::pack(SimTime d)
     pack((long long)d.raw());
 }
 
+// Note: arrays of other basic types go through packExternal(), so they may
+// be stored as external segments; this one must copy, as packBytes() uses it
 void cMemCommBuffer::pack(const char *d, int size)
 {
     extendBufferFor(size*sizeof(char));
@@ -155,80 +204,67 @@ void cMemCommBuffer::pack(const char *d, int size)
 
 void cMemCommBuffer::pack(const unsigned char *d, int size)
 {
-    extendBufferFor(size*sizeof(unsigned char));
-    STOREARRAY(unsigned char, d, size);
+    packExternal(d, size*sizeof(unsigned char));
 }
 
 void cMemCommBuffer::pack(const bool *d, int size)
 {
-    extendBufferFor(size*sizeof(bool));
-    STOREARRAY(bool, d, size);
+    packExternal(d, size*sizeof(bool));
 }
 
 void cMemCommBuffer::pack(const short *d, int size)
 {
-    extendBufferFor(size*sizeof(short));
-    STOREARRAY(short, d, size);
+    packExternal(d, size*sizeof(short));
 }
 
 void cMemCommBuffer::pack(const unsigned short *d, int size)
 {
-    extendBufferFor(size*sizeof(unsigned short));
-    STOREARRAY(unsigned short, d, size);
+    packExternal(d, size*sizeof(unsigned short));
 }
 
 void cMemCommBuffer::pack(const int *d, int size)
 {
-    extendBufferFor(size*sizeof(int));
-    STOREARRAY(int, d, size);
+    packExternal(d, size*sizeof(int));
 }
 
 void cMemCommBuffer::pack(const unsigned int *d, int size)
 {
-    extendBufferFor(size*sizeof(unsigned int));
-    STOREARRAY(unsigned int, d, size);
+    packExternal(d, size*sizeof(unsigned int));
 }
 
 void cMemCommBuffer::pack(const long *d, int size)
 {
-    extendBufferFor(size*sizeof(long));
-    STOREARRAY(long, d, size);
+    packExternal(d, size*sizeof(long));
 }
 
 void cMemCommBuffer::pack(const unsigned long *d, int size)
 {
-    extendBufferFor(size*sizeof(unsigned long));
-    STOREARRAY(unsigned long, d, size);
+    packExternal(d, size*sizeof(unsigned long));
 }
 
 void cMemCommBuffer::pack(const long long *d, int size)
 {
-    extendBufferFor(size*sizeof(long long));
-    STOREARRAY(long long, d, size);
+    packExternal(d, size*sizeof(long long));
 }
 
 void cMemCommBuffer::pack(const unsigned long long *d, int size)
 {
-    extendBufferFor(size*sizeof(unsigned long long));
-    STOREARRAY(unsigned long long, d, size);
+    packExternal(d, size*sizeof(unsigned long long));
 }
 
 void cMemCommBuffer::pack(const float *d, int size)
 {
-    extendBufferFor(size*sizeof(float));
-    STOREARRAY(float, d, size);
+    packExternal(d, size*sizeof(float));
 }
 
 void cMemCommBuffer::pack(const double *d, int size)
 {
-    extendBufferFor(size*sizeof(double));
-    STOREARRAY(double, d, size);
+    packExternal(d, size*sizeof(double));
 }
 
 void cMemCommBuffer::pack(const long double *d, int size)
 {
-    extendBufferFor(size*sizeof(long double));
-    STOREARRAY(long double, d, size);
+    packExternal(d, size*sizeof(long double));
 }
 
 // pack string array
@@ -437,5 +473,38 @@ void cMemCommBuffer::unpack(SimTime *d, int size)
         unpack(d[i]);
 }
 
+//----
+
+cMemCommBuffer *cMemCommBufferPool::get()
+{
+    cMemCommBuffer *buffer;
+    if (buffers.empty()) {
+        buffer = new cMemCommBuffer();
+        buffer->allocateAtLeast(initialCapacity);
+    }
+    else {
+        buffer = buffers.back();
+        buffers.pop_back();
+        buffer->reset();
+    }
+    buffer->setZeroCopyEnabled(false);
+    return buffer;
+}
+
+void cMemCommBufferPool::put(cMemCommBuffer *buffer)
+{
+    if ((int)buffers.size() < maxBuffers)
+        buffers.push_back(buffer);
+    else
+        delete buffer;
+}
+
+void cMemCommBufferPool::clear()
+{
+    for (cMemCommBuffer *buffer : buffers)
+        delete buffer;
+    buffers.clear();
+}
+
 }  // namespace omnetpp
 
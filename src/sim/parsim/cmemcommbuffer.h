@@ -21,6 +21,7 @@
 #ifndef __OMNETPP_CMEMCOMMBUFFER_H
 #define __OMNETPP_CMEMCOMMBUFFER_H
 
+#include <vector>
 #include "ccommbufferbase.h"
 
 namespace omnetpp {
@@ -30,10 +31,36 @@ namespace omnetpp {
  * @brief Communication buffer that packs data into a memory buffer without any
  * transformation.
  *
+ * If zero-copy packing is enabled, packExternal() stores large blocks of data
+ * as references (external segments) instead of copying them. The packed data
+ * is then the concatenation of the inline data in getBuffer() and the external
+ * segments, which communications classes can enumerate with forEachSegment()
+ * and transmit with a gather operation, or make contiguous with flatten().
+ * Arrays of numbers and bools packed with pack(const T *, int) also go
+ * through packExternal(), so when zero-copy packing is enabled, they must
+ * remain unchanged until the buffer is sent, too.
+ *
  * @ingroup Parsim
  */
 class SIM_API cMemCommBuffer : public cCommBufferBase
 {
+  public:
+    /**
+     * Blocks smaller than this are always copied by packExternal(), because
+     * a separate segment would cost more than the copying.
+     */
+    static const int MIN_EXTERNAL_SEGMENT_SIZE = 256;
+
+  protected:
+    struct ExternalSegment {
+        int offset;        // position in the inline data where the segment belongs
+        const char *data;
+        int size;
+    };
+    bool zeroCopyEnabled = false;
+    std::vector<ExternalSegment> externalSegments;
+    int externalSize = 0;  // sum of the sizes of the external segments
+
   public:
     /**
      * Constructor.
@@ -45,6 +72,62 @@ class SIM_API cMemCommBuffer : public cCommBufferBase
      */
     virtual ~cMemCommBuffer();
 
+    /** @name Buffer management */
+    //@{
+    /**
+     * Resets the buffer to an empty state, and forgets external segments.
+     */
+    virtual void reset() override;
+
+    /**
+     * Exchanges the contents of this buffer with that of the other one,
+     * including external segments.
+     */
+    void swap(cMemCommBuffer *other);
+
+    /**
+     * Returns true if the buffer refers to external segments.
+     */
+    bool hasExternalSegments() const {return !externalSegments.empty();}
+
+    /**
+     * Returns the total size of the packed data: the inline data
+     * (getMessageSize()) plus the external segments.
+     */
+    int getPackedSize() const {return mMsgSize + externalSize;}
+
+    /**
+     * Calls fn(const char *data, int size) for each contiguous piece of the
+     * packed data, in order. Without external segments, this is a single call
+     * with getBuffer() and getMessageSize().
+     */
+    template<typename F>
+    void forEachSegment(F fn) const {
+        int pos = 0;
+        for (const ExternalSegment& segment : externalSegments) {
+            if (segment.offset > pos)
+                fn(mBuffer + pos, segment.offset - pos);
+            fn(segment.data, segment.size);
+            pos = segment.offset;
+        }
+        if (mMsgSize > pos || externalSegments.empty())
+            fn(mBuffer + pos, mMsgSize - pos);
+    }
+
+    /**
+     * Copies the external segments into the buffer, so that getBuffer()
+     * and getMessageSize() cover all packed data.
+     */
+    void flatten();
+    //@}
+
+    /** @name Zero-copy packing */
+    //@{
+    virtual void packExternal(const void *data, int size) override;
+    virtual void setZeroCopyEnabled(bool enabled) override {zeroCopyEnabled = enabled;}
+    virtual bool isZeroCopyEnabled() const override {return zeroCopyEnabled;}
+    //@}
+
     /** @name Pack basic types */
     //@{
     virtual void pack(char d) override;
@@ -130,6 +213,50 @@ class SIM_API cMemCommBuffer : public cCommBufferBase
     //@}
 };
 
+/**
+ * @brief A pool of cMemCommBuffer objects, for communications classes that
+ * want to reuse buffers instead of allocating them for every send and receive.
+ * Recycled buffers keep their allocated memory, and new ones are created
+ * with an initial capacity, so that packing rarely needs to reallocate.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cMemCommBufferPool : noncopyable
+{
+  protected:
+    std::vector<cMemCommBuffer *> buffers;
+    int maxBuffers;
+    int initialCapacity;
+
+  public:
+    /**
+     * Constructor. At most maxBuffers buffers are kept for reuse, and new
+     * buffers are allocated with initialCapacity bytes.
+     */
+    cMemCommBufferPool(int maxBuffers=16, int initialCapacity=4096) : maxBuffers(maxBuffers), initialCapacity(initialCapacity) {}
+
+    /**
+     * Destructor. Deletes the pooled buffers.
+     */
+    ~cMemCommBufferPool() {clear();}
+
+    /**
+     * Returns an empty buffer, either a recycled one or a newly allocated one.
+     * Zero-copy packing is disabled in the returned buffer.
+     */
+    cMemCommBuffer *get();
+
+    /**
+     * Takes back a buffer, or deletes it if the pool is full.
+     */
+    void put(cMemCommBuffer *buffer);
+
+    /**
+     * Deletes the pooled buffers.
+     */
+    void clear();
+};
+
 }  // namespace omnetpp
 
 
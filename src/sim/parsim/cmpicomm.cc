@@ -32,6 +32,7 @@
 #include "omnetpp/platdep/platmisc.h"
 #include "cmpicomm.h"
 #include "cmpicommbuffer.h"
+#include "cparsimprofiler.h"
 
 namespace omnetpp {
 
@@ -137,6 +138,8 @@ void cMPICommunications::send(cCommBuffer *buffer, int tag, int destination)
     int status = MPI_Bsend(b->getBuffer(), b->getMessageSize(), MPI_PACKED, destination, tag, MPI_COMM_WORLD);
     if (status != MPI_SUCCESS)
         throw cRuntimeError("cMPICommunications::send(): MPI error %d", status);
+    if (profiler)
+        profiler->bufferSent(destination, tag, b->getMessageSize());
 }
 
 void cMPICommunications::broadcast(cCommBuffer *buffer, int tag)
@@ -163,6 +166,8 @@ bool cMPICommunications::receiveBlocking(int filtTag, cCommBuffer *buffer, int&
     b->setMessageSize(msgsize);
     receivedTag = status.MPI_TAG;
     sourceProcId = status.MPI_SOURCE;
+    if (profiler)
+        profiler->bufferReceived(sourceProcId, receivedTag, msgsize);
     return true;
 }
 
@@ -188,6 +193,8 @@ bool cMPICommunications::receiveNonblocking(int filtTag, cCommBuffer *buffer, in
         b->setMessageSize(msgsize);
         receivedTag = status.MPI_TAG;
         sourceProcId = status.MPI_SOURCE;
+        if (profiler)
+            profiler->bufferReceived(sourceProcId, receivedTag, msgsize);
         return true;
     }
     return false;
@@ -37,6 +37,7 @@
 #include "omnetpp/cconfiguration.h"
 #include "omnetpp/cconfigoption.h"
 #include "cmemcommbuffer.h"
+#include "cparsimprofiler.h"
 #include "parsimutil.h"
 
 namespace omnetpp {
@@ -164,12 +165,12 @@ int cNamedPipeCommunications::getProcId() const
 
 cCommBuffer *cNamedPipeCommunications::createCommBuffer()
 {
-    return new cMemCommBuffer();
+    return bufferPool.get();
 }
 
 void cNamedPipeCommunications::recycleCommBuffer(cCommBuffer *buffer)
 {
-    delete buffer;
+    bufferPool.put((cMemCommBuffer *)buffer);
 }
 
 void cNamedPipeCommunications::send(cCommBuffer *buffer, int tag, int destination)
@@ -186,6 +187,8 @@ void cNamedPipeCommunications::send(cCommBuffer *buffer, int tag, int destinatio
         throw cRuntimeError("cNamedPipeCommunications: Cannot write pipe to procId=%d: %s", destination, getWindowsError().c_str());
     if (!WriteFile(h, b->getBuffer(), ph.contentLength, &bytesWritten, 0))
         throw cRuntimeError("cNamedPipeCommunications: Cannot write pipe to procId=%d: %s", destination, getWindowsError().c_str());
+    if (profiler)
+        profiler->bufferSent(destination, tag, ph.contentLength);
 }
 
 bool cNamedPipeCommunications::receive(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId, bool blocking)
@@ -194,6 +197,8 @@ bool cNamedPipeCommunications::receive(int filtTag, cCommBuffer *buffer, int& re
     // TBD implement tag filtering
     if (recv && filtTag != PARSIM_ANY_TAG && filtTag != receivedTag)
         throw cRuntimeError("cNamedPipeCommunications: Tag filtering not implemented");
+    if (recv && profiler)
+        profiler->bufferReceived(sourceProcId, receivedTag, ((cMemCommBuffer *)buffer)->getMessageSize());
     return recv;
 }
 
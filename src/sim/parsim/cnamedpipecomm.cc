@@ -25,11 +25,16 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <cstdio>
+#include <csignal>
 #include <cstring>
 #include <cstdlib>
 #include <cerrno>
+#include <climits>
+#include <vector>
+#include <algorithm>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/uio.h>
 #include "omnetpp/cexception.h"
 #include "omnetpp/clog.h"
 #include "omnetpp/globals.h"
@@ -39,14 +44,43 @@
 #include "omnetpp/csimulation.h"
 #include "omnetpp/cconfiguration.h"
 #include "cmemcommbuffer.h"
+#include "cparsimprofiler.h"
 #include "parsimutil.h"
 
+#ifndef IOV_MAX
+#define IOV_MAX  16
+#endif
+
 namespace omnetpp {
 
 Register_Class(cNamedPipeCommunications);
 
 Register_GlobalConfigOption(CFGID_PARSIM_NAMEDPIPECOMM_PREFIX, "parsim-namedpipecommunications-prefix", CFG_STRING, "comm/", "When `cNamedPipeCommunications` is selected as parsim communications class: selects the prefix (directory+potential filename prefix) where name pipes are created in the file system.");
 
+// gather write: writes all pieces, continuing after partial writes
+static int writeBytes(int fd, struct iovec *iov, int iovcnt)
+{
+    while (iovcnt > 0) {
+        ssize_t n = writev(fd, iov, std::min(iovcnt, IOV_MAX));
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        // skip the pieces that have been written
+        while (iovcnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    return 0;
+}
+
 static int readBytes(int fd, void *buf, int len)
 {
     int tot = 0;
@@ -113,6 +147,10 @@ void cNamedPipeCommunications::init()
     }
     maxFdPlus1 += 1;
 
+    // a partition that has finished closes its pipes, and writing to them must
+    // not kill us (see send())
+    signal(SIGPIPE, SIG_IGN);
+
     // open pipes for write
     wpipes = new int[numPartitions];
     for (i = 0; i < numPartitions; i++) {
@@ -154,12 +192,15 @@ int cNamedPipeCommunications::getProcId() const
 
 cCommBuffer *cNamedPipeCommunications::createCommBuffer()
 {
-    return new cMemCommBuffer();
+    // send() writes the data out, so the packed objects only need to exist until then
+    cMemCommBuffer *buffer = bufferPool.get();
+    buffer->setZeroCopyEnabled(true);
+    return buffer;
 }
 
 void cNamedPipeCommunications::recycleCommBuffer(cCommBuffer *buffer)
 {
-    delete buffer;
+    bufferPool.put((cMemCommBuffer *)buffer);
 }
 
 void cNamedPipeCommunications::send(cCommBuffer *buffer, int tag, int destination)
@@ -169,11 +210,22 @@ void cNamedPipeCommunications::send(cCommBuffer *buffer, int tag, int destinatio
 
     struct PipeHeader ph;
     ph.tag = tag;
-    ph.contentLength = b->getMessageSize();
-    if (write(fd, &ph, sizeof(ph)) == -1)
-        throw cRuntimeError("cNamedPipeCommunications: Cannot write pipe to procId=%d: %s", destination, strerror(errno));
-    if (write(fd, b->getBuffer(), ph.contentLength) == -1)
+    ph.contentLength = b->getPackedSize();
+
+    // write the header and the data (including external segments) with a single gather write
+    std::vector<struct iovec> iov;
+    iov.push_back({&ph, sizeof(ph)});
+    b->forEachSegment([&](const char *data, int size) {iov.push_back({(void *)data, (size_t)size});});
+    if (writeBytes(fd, iov.data(), iov.size()) == -1) {
+        // the destination has already finished (e.g. it reached the simulation
+        // time limit before us, and we are still sending null messages to it),
+        // and it would not read the data anyway
+        if (errno == EPIPE)
+            return;
         throw cRuntimeError("cNamedPipeCommunications: Cannot write pipe to procId=%d: %s", destination, strerror(errno));
+    }
+    if (profiler)
+        profiler->bufferSent(destination, tag, ph.contentLength);
 }
 
 bool cNamedPipeCommunications::receive(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId, bool blocking)
@@ -182,6 +234,8 @@ bool cNamedPipeCommunications::receive(int filtTag, cCommBuffer *buffer, int& re
     // TBD implement tag filtering
     if (recv && filtTag != PARSIM_ANY_TAG && filtTag != receivedTag)
         throw cRuntimeError("cNamedPipeCommunications: Tag filtering not implemented");
+    if (recv && profiler)
+        profiler->bufferReceived(sourceProcId, receivedTag, ((cMemCommBuffer *)buffer)->getMessageSize());
     return recv;
 }
 
@@ -31,6 +31,7 @@
 #include "omnetpp/opp_string.h"
 #include "omnetpp/cparsimcomm.h"
 #include "omnetpp/platdep/platmisc.h"  // for <windows.h>
+#include "cmemcommbuffer.h"
 
 // decide platform
 #if defined(_WIN32)
@@ -69,6 +70,8 @@ class SIM_API cNamedPipeCommunications : public cParsimCommunications
     // reordering buffer needed because of tag filtering support (filtTag)
     std::deque<cCommBuffer*> storedBuffers;
 
+    cMemCommBufferPool bufferPool;
+
   protected:
     // common impl. for receiveBlocking() and receiveNonblocking()
     bool receive(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId, bool blocking);
@@ -108,12 +111,14 @@ class SIM_API cNamedPipeCommunications : public cParsimCommunications
     virtual int getProcId() const override;
 
     /**
-     * Creates an empty buffer of type cMemCommBuffer.
+     * Returns an empty buffer of type cMemCommBuffer from the pool. On POSIX
+     * systems, zero-copy packing is enabled, and send() transmits external
+     * segments with a gather write.
      */
     virtual cCommBuffer *createCommBuffer() override;
 
     /**
-     * Recycle communication buffer after use.
+     * Returns the buffer to the pool.
      */
     virtual void recycleCommBuffer(cCommBuffer *buffer) override;
 
@@ -83,6 +83,22 @@ class SIM_API cNMPLookahead : public cObject
      */
     virtual simtime_t getCurrentLookahead(int procId) = 0;
 
+    /**
+     * Returns the EOT (earliest output time) towards the given partition,
+     * assuming that no event is processed in this partition before `now`.
+     * The default implementation adds getCurrentLookahead(procId) to `now`;
+     * lookahead classes that take promises into account may return more.
+     */
+    virtual simtime_t getCurrentEOT(int procId, simtime_t now)  {return now + getCurrentLookahead(procId);}
+
+    /**
+     * Called when a module promises not to send messages before time t on
+     * the link whose proxy gate has the given synchronization data pointer
+     * (see cSimpleModule::promiseEarliestSendTime()). The default
+     * implementation ignores the promise.
+     */
+    virtual void promiseEarliestSendTime(simtime_t t, int procId, void *data)  {}
+
 };
 
 }  // namespace omnetpp
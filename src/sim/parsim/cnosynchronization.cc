@@ -53,6 +53,9 @@ void cNoSynchronization::endRun()
 
 cEvent *cNoSynchronization::takeNextEvent()
 {
+    // send out messages batched during the previous event (if batching is enabled)
+    flushOutgoingMessages();
+
     // if no more local events, wait for something to come from other partitions
     if (sim->getFES()->isEmpty()) {
         EV << "no local events, waiting for something to arrive from other partitions\n";
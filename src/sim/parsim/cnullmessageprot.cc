@@ -33,6 +33,7 @@
 #include "cnullmessageprot.h"
 #include "clinkdelaylookahead.h"
 #include "cparsimpartition.h"
+#include "cparsimprofiler.h"
 #include "messagetags.h"
 #include "cplaceholdermod.h"
 #include "cproxygate.h"
@@ -49,6 +50,7 @@ cNullMessageProtocol::cNullMessageProtocol() : cParsimProtocolBase()
 {
     numSeg = 0;
     segInfo = nullptr;
+    batchDeadline = SIMTIME_MAX;
 
     debug = getEnvir()->getConfig()->getAsBool(CFGID_PARSIM_DEBUG);
     std::string lookhClass = getEnvir()->getConfig()->getAsString(CFGID_PARSIM_NULLMESSAGEPROTOCOL_LOOKAHEAD_CLASS);
@@ -90,7 +92,11 @@ void cNullMessageProtocol::startRun()
         segInfo[i].eotEvent = nullptr;
         segInfo[i].eitEvent = nullptr;
         segInfo[i].lastEotSent = 0.0;
+        segInfo[i].eotPending = false;
+        segInfo[i].eotParked = false;
     }
+    batchDeadline = SIMTIME_MAX;
+    parkedResendTime = SIMTIME_MAX;
 
     // Note boot sequence: first we have to schedule all "resend-EOT" events,
     // so that the simulation will start by sending out null messages --
@@ -114,6 +120,7 @@ void cNullMessageProtocol::startRun()
         if (i != myProcId) {
             sprintf(buf, "EIT-%d", i);
             cMessage *eitMsg = new cMessage(buf, MK_PARSIM_EIT);
+            eitMsg->setContextPointer((void *)(uintptr_t)i);  // for profiling
             segInfo[i].eitEvent = eitMsg;
             rescheduleEvent(eitMsg, 0.0);
         }
@@ -138,9 +145,27 @@ void cNullMessageProtocol::processOutgoingMessage(cMessage *msg, int destProcId,
     if (eot < segInfo[destProcId].lastEotSent)
         throw cRuntimeError("cNullMessageProtocol error: Attempt to decrease EOT");
 
+    if (cParsimProfiler *profiler = partition->getProfiler())
+        profiler->lookaheadUsed(destProcId, lookahead, msg->getArrivalTime() - sim->getSimTime());
+
     // send a null message only if EOT is better than last time
     bool sendNull = (eot > segInfo[destProcId].lastEotSent);
 
+    if (batching != BATCHING_NONE) {
+        // add message to the batch; the EOT will be piggybacked on the batch
+        if (batching == BATCHING_LOOKAHEAD && numPendingBatches == 0)
+            batchDeadline = sim->getSimTime() + lookahead*laziness;
+        addToBatch(msg, destProcId, destModuleId, destGateId);
+        if (sendNull) {
+            segInfo[destProcId].lastEotSent = eot;
+            segInfo[destProcId].eotPending = true;
+            simtime_t eotResendTime = sim->getSimTime() + lookahead*laziness;
+            rescheduleEvent(segInfo[destProcId].eotEvent, eotResendTime);
+        }
+        {if (debug) EV << "adding '" << msg->getName() << "' to batch for " << destProcId << (sendNull ? ", new EOT=" : ", EOT=") << eot << "\n";}
+        return;
+    }
+
     // send message
     cCommBuffer *buffer = comm->createCommBuffer();
     if (sendNull) {
@@ -171,6 +196,31 @@ void cNullMessageProtocol::processOutgoingMessage(cMessage *msg, int destProcId,
     comm->recycleCommBuffer(buffer);
 }
 
+void cNullMessageProtocol::flushBatch(int destProcId)
+{
+    if (!hasBatch(destProcId))
+        return;
+    if (!segInfo[destProcId].eotPending) {
+        cParsimProtocolBase::flushBatch(destProcId);
+        return;
+    }
+
+    simtime_t eot = segInfo[destProcId].lastEotSent;
+    segInfo[destProcId].eotPending = false;
+    {if (debug) EV << "sending batch with piggybacked null msg to " << destProcId << ", EOT=" << eot << "\n";}
+
+    cCommBuffer *buffer = detachBatch(destProcId);
+    buffer->pack(eot);
+    comm->send(buffer, TAG_CMESSAGE_BATCH_WITH_NULLMESSAGE, destProcId);
+    comm->recycleCommBuffer(buffer);
+}
+
+void cNullMessageProtocol::flushOutgoingMessages()
+{
+    cParsimProtocolBase::flushOutgoingMessages();
+    batchDeadline = SIMTIME_MAX;
+}
+
 void cNullMessageProtocol::processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId)
 {
     int destModuleId;
@@ -200,6 +250,16 @@ void cNullMessageProtocol::processReceivedBuffer(cCommBuffer *buffer, int tag, i
             processReceivedEIT(sourceProcId, eit);
             break;
 
+        case TAG_CMESSAGE_BATCH:
+            processReceivedBatch(buffer, sourceProcId);
+            break;
+
+        case TAG_CMESSAGE_BATCH_WITH_NULLMESSAGE:
+            processReceivedBatch(buffer, sourceProcId);
+            buffer->unpack(eit);
+            processReceivedEIT(sourceProcId, eit);
+            break;
+
         default:
             partition->processReceivedBuffer(buffer, tag, sourceProcId);
             break;
@@ -235,9 +295,17 @@ cEvent *cNullMessageProtocol::takeNextEvent()
     // deadlock.
     // receiveNonblocking();
 
+    // send out messages batched during the previous event
+    if (batching == BATCHING_EVENT)
+        flushOutgoingMessages();
+
     cEvent *event;
     while (true) {
         event = sim->getFES()->peekFirst();
+        if (event->getArrivalTime() > parkedResendTime) {
+            sendParkedNullMessages(event->getArrivalTime());
+            continue;
+        }
         cMessage *msg = event->isMessage() ? static_cast<cMessage *>(event) : nullptr;
         if (msg && msg->getKind() == MK_PARSIM_RESENDEOT) {
             // send null messages if window closed for a partition
@@ -247,11 +315,16 @@ cEvent *cNullMessageProtocol::takeNextEvent()
         else if (msg && msg->getKind() == MK_PARSIM_EIT) {
             // wait until it gets out of the way (i.e. we get a higher EIT)
             {if (debug) EV << "blocking on EIT event '" << event->getName() << "'\n";}
+            if (cParsimProfiler *profiler = partition->getProfiler())
+                profiler->setWaitingFor((uintptr_t)msg->getContextPointer());
             if (!receiveBlocking())
                 return nullptr;
         }
         else {
-            // just a normal event -- go ahead with it
+            // just a normal event -- go ahead with it (but first send out
+            // batches that have been held back long enough)
+            if (event->getArrivalTime() >= batchDeadline)
+                flushOutgoingMessages();
             break;
         }
     }
@@ -270,22 +343,39 @@ void cNullMessageProtocol::putBackEvent(cEvent *event)
 
 void cNullMessageProtocol::sendNullMessage(int procId, simtime_t now)
 {
+    // messages held back for this partition must go out first
+    flushBatch(procId);
+
     // calculate EOT and sending of next null message
-    simtime_t lookahead = lookaheadcalc->getCurrentLookahead(procId);
-    simtime_t eot = now + lookahead;
+    simtime_t eot = lookaheadcalc->getCurrentEOT(procId, now);
+    simtime_t lookahead = eot - now;
+    if (eot < segInfo[procId].lastEotSent)
+        throw cRuntimeError("cNullMessageProtocol error: Attempt to decrease EOT");
+
+    // calculate time of next null message sending, and schedule "resend-EOT"
+    // event: the time when the EOT can grow by lookahead*laziness again. Without
+    // promises this is now + lookahead*laziness; with promises (when the EOT is
+    // more than now + lookahead) it is later. If it is not later than now (laziness=0),
+    // the event is parked until simulation time advances, otherwise it would be
+    // taken again and again at the same simulation time.
+    simtime_t minLookahead = lookaheadcalc->getCurrentLookahead(procId);
+    simtime_t eotResendTime = eot - minLookahead*(1-laziness);
+    if (eotResendTime > now) {
+        segInfo[procId].eotParked = false;
+        rescheduleEvent(segInfo[procId].eotEvent, eotResendTime);
+    }
+    else {
+        segInfo[procId].eotParked = true;
+        rescheduleEvent(segInfo[procId].eotEvent, SIMTIME_MAX);
+        parkedResendTime = now;
+    }
 
     // ensure that even with eager resend, we only send out EOTs that
     // differ from previous one!
     if (eot == segInfo[procId].lastEotSent)
         return;
-    if (eot < segInfo[procId].lastEotSent)
-        throw cRuntimeError("cNullMessageProtocol error: Attempt to decrease EOT");
     segInfo[procId].lastEotSent = eot;
 
-    // calculate time of next null message sending, and schedule "resend-EOT" event
-    simtime_t eotResendTime = now + lookahead*laziness;
-    rescheduleEvent(segInfo[procId].eotEvent, eotResendTime);
-
     {if (debug) EV << "sending null msg to " << procId << ", lookahead=" << lookahead << ", EOT=" << eot << "; next resend at " << eotResendTime << "\n";}
 
     // send out null message
@@ -295,6 +385,27 @@ void cNullMessageProtocol::sendNullMessage(int procId, simtime_t now)
     comm->recycleCommBuffer(buffer);
 }
 
+void cNullMessageProtocol::sendParkedNullMessages(simtime_t now)
+{
+    parkedResendTime = SIMTIME_MAX;
+    for (int i = 0; i < numSeg; i++)
+        if (segInfo[i].eotParked)
+            sendNullMessage(i, now);
+}
+
+void cNullMessageProtocol::promiseEarliestSendTime(simtime_t t, int procId, void *data)
+{
+    lookaheadcalc->promiseEarliestSendTime(t, procId, data);
+
+    // if the promise allows a better EOT, send it out without waiting for
+    // the "resend-EOT" timer: make the timer expire now
+    simtime_t now = sim->getSimTime();
+    if (lookaheadcalc->getCurrentEOT(procId, now) > segInfo[procId].lastEotSent && segInfo[procId].eotEvent->getArrivalTime() > now) {
+        {if (debug) EV << "promise raises EOT to " << procId << ", resending null msg\n";}
+        rescheduleEvent(segInfo[procId].eotEvent, now);
+    }
+}
+
 void cNullMessageProtocol::rescheduleEvent(cMessage *msg, simtime_t t)
 {
     sim->getFES()->remove(msg);  // also works if the event is not currently scheduled
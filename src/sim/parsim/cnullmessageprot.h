@@ -35,6 +35,17 @@ class cNMPLookahead;
  * Lookahead calculation is encapsulated into a separate object,
  * subclassed from cNMPLookahead.
  *
+ * When message batching is enabled (see cParsimProtocolBase), the EOT
+ * that would be piggybacked on an outgoing message is piggybacked on the
+ * batch instead. An EOT is never sent to a partition while there are
+ * messages held back for it, so batching does not affect correctness.
+ *
+ * Modules may promise not to send messages on a cross-partition link before
+ * a given time (cSimpleModule::promiseEarliestSendTime()). Lookahead classes
+ * that support it (such as cLinkDelayLookahead) fold these promises into
+ * the EOT, and a null message carrying the improved EOT is sent out before
+ * the next event.
+ *
  * @ingroup Parsim
  */
 class SIM_API cNullMessageProtocol : public cParsimProtocolBase
@@ -45,6 +56,8 @@ class SIM_API cNullMessageProtocol : public cParsimProtocolBase
         cMessage *eitEvent;  // EIT received from partition
         cMessage *eotEvent;  // events which marks that a null message should be sent out
         simtime_t lastEotSent; // last EOT value that was sent
+        bool eotPending;       // lastEotSent is waiting to be sent out with the batch
+        bool eotParked;        // eotEvent is parked at SIMTIME_MAX until simulation time advances (laziness=0)
     };
 
     // partition information
@@ -65,16 +78,28 @@ class SIM_API cNullMessageProtocol : public cParsimProtocolBase
 
     cNMPLookahead *lookaheadcalc;
 
+    // with lookahead batching: batches must be sent out before executing events at or after this time
+    simtime_t batchDeadline;
+
+    // if there are parked "resend-EOT" events: they fire before the first event after this time
+    simtime_t parkedResendTime;
+
   protected:
     // process buffers coming from other partitions
     virtual void processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId) override;
 
+    // send out the batch for the given partition, with the pending EOT piggybacked on it
+    virtual void flushBatch(int destProcId) override;
+
     // processes a received EIT: reschedule partition's EIT message
     virtual void processReceivedEIT(int sourceProcId, simtime_t eit);
 
     // resend null message to this partition
     virtual void sendNullMessage(int procId, simtime_t now);
 
+    // resend null messages whose "resend-EOT" event was parked, as simulation time advances to now
+    virtual void sendParkedNullMessages(simtime_t now);
+
     // reschedule event in FES, to the given time
     virtual void rescheduleEvent(cMessage *msg, simtime_t t);
 
@@ -135,6 +160,18 @@ class SIM_API cNullMessageProtocol : public cParsimProtocolBase
      * piggybacking of null message on the cMessage.
      */
     virtual void processOutgoingMessage(cMessage *msg, int procId, int moduleId, int gateId, void *data) override;
+
+    /**
+     * Sends out all pending batches.
+     */
+    virtual void flushOutgoingMessages() override;
+
+    /**
+     * Passes the promise to the lookahead calculator, and if that results
+     * in a better EOT, arranges for a null message to be sent before the
+     * next event is processed.
+     */
+    virtual void promiseEarliestSendTime(simtime_t t, int procId, void *data) override;
 };
 
 }  // namespace omnetpp
@@ -33,6 +33,7 @@
 #include "cproxygate.h"
 #include "cparsimpartition.h"
 #include "cparsimsynchr.h"
+#include "cparsimprofiler.h"
 #include "creceivedexception.h"
 #include "messagetags.h"
 
@@ -41,17 +42,23 @@ namespace omnetpp {
 Register_Class(cParsimPartition);
 
 Register_GlobalConfigOption(CFGID_PARSIM_DEBUG, "parsim-debug", CFG_BOOL, "true", "With `parallel-simulation=true`: turns on printing of log messages from the parallel simulation code.");
+Register_PerRunConfigOption(CFGID_PARSIM_PROFILING, "parsim-profiling", CFG_BOOL, "false", "With `parallel-simulation=true`: turns on collecting statistics about the synchronization with other partitions: the time spent blocked waiting for other partitions, the number of model messages and null messages, the bytes transmitted per partition, and lookahead utilization. They are recorded as scalars of the network module, with names starting with `parsimProfile:`.");
+Register_PerRunConfigOption(CFGID_PARSIM_PROFILING_TIMELINE_FILE, "parsim-profiling-timeline-file", CFG_FILENAME, "", "When `parsim-profiling` is enabled: the name of the file into which the periods a partition spent blocked are written, with wall-clock time, simulation time and the partition waited for. The partition number is inserted before the file extension. Empty means no timeline file.");
 
 cParsimPartition::cParsimPartition()
 {
     sim = nullptr;
     comm = nullptr;
     synch = nullptr;
+    profiler = nullptr;
     debug = getEnvir()->getConfig()->getAsBool(CFGID_PARSIM_DEBUG);
 }
 
 cParsimPartition::~cParsimPartition()
 {
+    if (comm && comm->getProfiler() == profiler)
+        comm->setProfiler(nullptr);
+    delete profiler;
 }
 
 void cParsimPartition::setContext(cSimulation *simul, cParsimCommunications *commlayer, cParsimSynchronizer *sync)
@@ -65,6 +72,7 @@ void cParsimPartition::lifecycleEvent(SimulationLifecycleEventType eventType, cO
 {
     switch (eventType) {
         case LF_PRE_NETWORK_INITIALIZE: startRun(); break;
+        case LF_POST_NETWORK_FINISH: if (profiler) profiler->recordScalars(sim->getSystemModule()); break;
         case LF_ON_RUN_END: endRun(); break;
         case LF_ON_SHUTDOWN: shutdown(); break;
         default: break;
@@ -74,10 +82,27 @@ void cParsimPartition::lifecycleEvent(SimulationLifecycleEventType eventType, cO
 void cParsimPartition::startRun()
 {
     connectRemoteGates();
+
+    // start profiling after the setup, so that the setup traffic is not counted
+    cConfiguration *cfg = getEnvir()->getConfig();
+    if (cfg->getAsBool(CFGID_PARSIM_PROFILING)) {
+        if (!profiler)
+            profiler = new cParsimProfiler();
+        profiler->setTimelineFile(cfg->getAsFilename(CFGID_PARSIM_PROFILING_TIMELINE_FILE).c_str());
+        profiler->startRun(comm->getNumPartitions(), comm->getProcId());
+        comm->setProfiler(profiler);
+    }
+    else {
+        comm->setProfiler(nullptr);
+        delete profiler;
+        profiler = nullptr;
+    }
 }
 
 void cParsimPartition::endRun()
 {
+    if (profiler)
+        profiler->endRun();
 }
 
 void cParsimPartition::shutdown()
@@ -205,9 +230,20 @@ void cParsimPartition::processOutgoingMessage(cMessage *msg, int procId, int mod
         EV << "sending message '" << msg->getFullName() << "' (for T="
            << msg->getArrivalTime() << " to procId=" << procId << ")\n";
 
+    if (profiler)
+        profiler->messageSent(procId);
+
     synch->processOutgoingMessage(msg, procId, moduleId, gateId, data);
 }
 
+void cParsimPartition::promiseEarliestSendTime(simtime_t t, int procId, void *data)
+{
+    if (debug)
+        EV << "promise: no messages to procId=" << procId << " before T=" << t << " on a link\n";
+
+    synch->promiseEarliestSendTime(t, procId, data);
+}
+
 void cParsimPartition::processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId)
 {
     opp_string errmsg;
@@ -230,6 +266,9 @@ void cParsimPartition::processReceivedBuffer(cCommBuffer *buffer, int tag, int s
 void cParsimPartition::processReceivedMessage(cMessage *msg, int destModuleId, int destGateId, int sourceProcId)
 {
     msg->setSrcProcId(sourceProcId);
+    if (profiler)
+        profiler->messageReceived(sourceProcId);
+
     cModule *mod = sim->getModule(destModuleId);
     if (!mod)
         throw cRuntimeError("Parallel simulation error: Destination module id=%d for message \"%s\""
@@ -263,6 +302,7 @@ void cParsimPartition::broadcastTerminationException(cTerminationException& e)
     cCommBuffer *buffer = comm->createCommBuffer();
     buffer->pack(e.what());
     try {
+        synch->flushOutgoingMessages();
         comm->broadcast(buffer, TAG_TERMINATIONEXCEPTION);
     }
     catch (std::exception&) {
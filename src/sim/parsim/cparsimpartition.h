@@ -34,6 +34,7 @@ class cParsimCommunications;
 class cCommBuffer;
 class cException;
 class cTerminationException;
+class cParsimProfiler;
 
 
 /**
@@ -65,6 +66,7 @@ class SIM_API cParsimPartition : public cObject, public cISimulationLifecycleLis
     cSimulation *sim;
     cParsimCommunications *comm;
     cParsimSynchronizer *synch;
+    cParsimProfiler *profiler;  // nullptr if profiling is off
     bool debug;
 
   protected:
@@ -93,6 +95,12 @@ class SIM_API cParsimPartition : public cObject, public cISimulationLifecycleLis
      */
     void setContext(cSimulation *sim, cParsimCommunications *comm, cParsimSynchronizer *synch);
 
+    /**
+     * Returns the object that collects synchronization statistics, or
+     * nullptr if profiling is not enabled (see parsim-profiling).
+     */
+    cParsimProfiler *getProfiler() const {return profiler;}
+
     /**
      * Called at the beginning of a simulation run. Fills in remote gate addresses
      * of all cProxyGate's in the current partition.
@@ -116,6 +124,13 @@ class SIM_API cParsimPartition : public cObject, public cISimulationLifecycleLis
      */
     virtual void processOutgoingMessage(cMessage *msg, int procId, int moduleId, int gateId, void *data);
 
+    /**
+     * A hook called from cSimpleModule::promiseEarliestSendTime() when the
+     * output gate leads to another partition. We just pass it up to the
+     * synchronization layer (see similar method in cParsimSynchronizer).
+     */
+    virtual void promiseEarliestSendTime(simtime_t t, int procId, void *data);
+
     /**
      * Process messages coming from other partitions. This method is called from
      * the synchronization layer (see cParsimSynchronizer), after it has
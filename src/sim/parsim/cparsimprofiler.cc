@@ -0,0 +1,124 @@
+//=========================================================================
+//  CPARSIMPROFILER.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2003-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstring>
+#include <cerrno>
+#include "common/fileutil.h"
+#include "common/stringutil.h"
+#include "omnetpp/cmodule.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/simutil.h"
+#include "cparsimprofiler.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+
+cParsimProfiler::~cParsimProfiler()
+{
+    if (timeline)
+        fclose(timeline);
+}
+
+void cParsimProfiler::startRun(int numPartitions, int procId)
+{
+    myProcId = procId;
+    partitionStats.clear();
+    partitionStats.resize(numPartitions);
+    blockedNanosecs = 0;
+    numBlockings = 0;
+    waitingFor = -1;
+    runStartTime = opp_get_monotonic_clock_nsecs();
+
+    if (timeline) {
+        fclose(timeline);
+        timeline = nullptr;
+    }
+    if (!timelineFile.empty()) {
+        // insert the partition number before the extension, so that partitions don't overwrite each other's file
+        std::string fileName = timelineFile;
+        std::string::size_type dotPos = fileName.rfind('.');
+        if (dotPos == std::string::npos || fileName.find_first_of("/\\", dotPos) != std::string::npos)
+            dotPos = fileName.size();
+        fileName.insert(dotPos, opp_stringf("-%d", procId));
+
+        mkPath(directoryOf(fileName.c_str()).c_str());
+        timeline = fopen(fileName.c_str(), "w");
+        if (!timeline)
+            throw cRuntimeError("cParsimProfiler: Cannot open '%s' for write: %s", fileName.c_str(), strerror(errno));
+        fprintf(timeline, "# blocking periods of partition %d of %d\n", procId, numPartitions);
+        fprintf(timeline, "# blockStart blockEnd simtime waitingFor\n");
+    }
+}
+
+void cParsimProfiler::endRun()
+{
+    if (timeline) {
+        fclose(timeline);
+        timeline = nullptr;
+    }
+}
+
+void cParsimProfiler::blockingStarted()
+{
+    blockingStartTime = opp_get_monotonic_clock_nsecs();
+}
+
+void cParsimProfiler::blockingEnded(simtime_t now)
+{
+    int64_t endTime = opp_get_monotonic_clock_nsecs();
+    int64_t duration = endTime - blockingStartTime;
+    blockedNanosecs += duration;
+    numBlockings++;
+    if (waitingFor >= 0) {
+        PartitionStats& stats = partitionStats[waitingFor];
+        stats.blockedNanosecs += duration;
+        stats.numBlockings++;
+    }
+    if (timeline)
+        fprintf(timeline, "%.9f %.9f %s %d\n", (blockingStartTime - runStartTime) * 1e-9,
+                (endTime - runStartTime) * 1e-9, SIMTIME_STR(now), waitingFor);
+    waitingFor = -1;
+}
+
+void cParsimProfiler::recordScalars(cModule *module)
+{
+    module->recordScalar("parsimProfile:wallTime", (opp_get_monotonic_clock_nsecs() - runStartTime) * 1e-9, "s");
+    module->recordScalar("parsimProfile:blockedTime", blockedNanosecs * 1e-9, "s");
+    module->recordScalar("parsimProfile:numBlockings", numBlockings);
+
+    for (int i = 0; i < (int)partitionStats.size(); i++) {
+        if (i == myProcId)
+            continue;
+        const PartitionStats& stats = partitionStats[i];
+        std::string prefix = opp_stringf("parsimProfile:partition%d:", i);
+        module->recordScalar((prefix + "numMessagesSent").c_str(), stats.numMessagesSent);
+        module->recordScalar((prefix + "numMessagesReceived").c_str(), stats.numMessagesReceived);
+        module->recordScalar((prefix + "numNullMessagesSent").c_str(), stats.numNullMessagesSent);
+        module->recordScalar((prefix + "numNullMessagesReceived").c_str(), stats.numNullMessagesReceived);
+        if (stats.numMessagesSent > 0)
+            module->recordScalar((prefix + "nullMessageRatio").c_str(), (double)stats.numNullMessagesSent / stats.numMessagesSent);
+        module->recordScalar((prefix + "numBuffersSent").c_str(), stats.numBuffersSent);
+        module->recordScalar((prefix + "numBytesSent").c_str(), stats.numBytesSent, "B");
+        module->recordScalar((prefix + "numBytesReceived").c_str(), stats.numBytesReceived, "B");
+        module->recordScalar((prefix + "blockedTime").c_str(), stats.blockedNanosecs * 1e-9, "s");
+        if (stats.numLookaheadSamples > 0)
+            module->recordScalar((prefix + "lookaheadUtilization").c_str(), stats.lookaheadUtilizationSum / stats.numLookaheadSamples);
+    }
+}
+
+}  // namespace omnetpp
+
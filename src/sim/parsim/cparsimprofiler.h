@@ -0,0 +1,207 @@
+//=========================================================================
+//  CPARSIMPROFILER.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2003-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CPARSIMPROFILER_H
+#define __OMNETPP_CPARSIMPROFILER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "omnetpp/cobject.h"
+#include "omnetpp/simtime_t.h"
+#include "messagetags.h"
+
+namespace omnetpp {
+
+class cModule;
+
+/**
+ * @brief Collects statistics about the synchronization of a partition
+ * with the other partitions of a parallel simulation.
+ *
+ * For every other partition, the profiler counts the model messages
+ * (cMessages) and the null messages exchanged with it, and the number of
+ * buffers and bytes transmitted by the communications layer. It measures
+ * the wall-clock time the partition spends blocked in receiveBlocking(),
+ * attributing it to the partition being waited for if the synchronizer
+ * knows it (the null message protocol blocks on the EIT of a specific
+ * partition). The null message protocol also reports lookahead utilization:
+ * for each model message sent, the lookahead announced to the destination
+ * divided by the actual delay of the message. Values close to 1 mean that
+ * the lookahead is used well; small values mean the partitions could
+ * proceed much further if more lookahead were known.
+ *
+ * At the end of the simulation, the figures are recorded as scalars of
+ * the network module (names start with <tt>parsimProfile:</tt>). Optionally,
+ * the periods of blocking are also written into a timeline file, one line
+ * per period, with the wall-clock times (seconds since the start of the run),
+ * the simulation time, and the partition waited for.
+ *
+ * The profiler is enabled with the <tt>parsim-profiling</tt> configuration
+ * option. It is owned by cParsimPartition; synchronizers and communications
+ * classes report to it if it exists.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cParsimProfiler : public cObject, noncopyable
+{
+  public:
+    /**
+     * Statistics of the traffic with another partition.
+     */
+    struct PartitionStats {
+        int64_t numMessagesSent = 0;       // cMessages sent to the partition
+        int64_t numMessagesReceived = 0;   // cMessages received from the partition
+        int64_t numNullMessagesSent = 0;   // standalone null messages (not piggybacked) sent
+        int64_t numNullMessagesReceived = 0;
+        int64_t numBuffersSent = 0;        // send operations of the communications layer
+        int64_t numBuffersReceived = 0;
+        int64_t numBytesSent = 0;
+        int64_t numBytesReceived = 0;
+        int64_t blockedNanosecs = 0;       // time spent blocked while waiting for this partition
+        int64_t numBlockings = 0;
+        double lookaheadUtilizationSum = 0;
+        int64_t numLookaheadSamples = 0;
+    };
+
+  protected:
+    int myProcId = -1;
+    std::vector<PartitionStats> partitionStats;  // indexed by procId
+    int64_t runStartTime = 0;     // monotonic clock at startRun()
+    int64_t blockedNanosecs = 0;  // total time spent blocked
+    int64_t numBlockings = 0;
+    int waitingFor = -1;          // the partition the next blocking waits for, if known
+    int64_t blockingStartTime = 0;
+    std::string timelineFile;
+    FILE *timeline = nullptr;
+
+  public:
+    /**
+     * Constructor.
+     */
+    cParsimProfiler() {}
+
+    /**
+     * Destructor. Closes the timeline file if it is still open.
+     */
+    virtual ~cParsimProfiler();
+
+    /**
+     * Sets the timeline file name. The partition number is inserted before
+     * the file extension. Empty means no timeline file.
+     */
+    void setTimelineFile(const char *fileName) {timelineFile = fileName ? fileName : "";}
+
+    /**
+     * Clears the statistics, and opens the timeline file if needed.
+     */
+    void startRun(int numPartitions, int procId);
+
+    /**
+     * Closes the timeline file.
+     */
+    void endRun();
+
+    /** @name Accounting. These methods are called by the parallel simulation layers. */
+    //@{
+    /**
+     * Called by the communications layer when a buffer has been sent.
+     */
+    void bufferSent(int destProcId, int tag, int numBytes) {
+        PartitionStats& stats = partitionStats[destProcId];
+        stats.numBuffersSent++;
+        stats.numBytesSent += numBytes;
+        if (tag == TAG_NULLMESSAGE)
+            stats.numNullMessagesSent++;
+    }
+
+    /**
+     * Called by the communications layer when a buffer has been received.
+     */
+    void bufferReceived(int sourceProcId, int tag, int numBytes) {
+        PartitionStats& stats = partitionStats[sourceProcId];
+        stats.numBuffersReceived++;
+        stats.numBytesReceived += numBytes;
+        if (tag == TAG_NULLMESSAGE)
+            stats.numNullMessagesReceived++;
+    }
+
+    /**
+     * Called by cParsimPartition when a cMessage leaves the partition.
+     */
+    void messageSent(int destProcId) {partitionStats[destProcId].numMessagesSent++;}
+
+    /**
+     * Called by cParsimPartition when a cMessage arrives from another partition.
+     */
+    void messageReceived(int sourceProcId) {partitionStats[sourceProcId].numMessagesReceived++;}
+
+    /**
+     * Called by the synchronizer when a cMessage is sent with the given
+     * lookahead and (actual) delay.
+     */
+    void lookaheadUsed(int destProcId, simtime_t lookahead, simtime_t delay) {
+        if (delay > SIMTIME_ZERO) {
+            PartitionStats& stats = partitionStats[destProcId];
+            stats.lookaheadUtilizationSum += lookahead < delay ? lookahead / delay : 1.0;
+            stats.numLookaheadSamples++;
+        }
+    }
+
+    /**
+     * Tells the profiler which partition the next blocking waits for.
+     */
+    void setWaitingFor(int procId) {waitingFor = procId;}
+
+    /**
+     * Called before the synchronizer blocks in receiveBlocking().
+     */
+    void blockingStarted();
+
+    /**
+     * Called after the synchronizer has returned from receiveBlocking().
+     */
+    void blockingEnded(simtime_t now);
+    //@}
+
+    /** @name Results. */
+    //@{
+    /**
+     * Returns the statistics of the traffic with the given partition.
+     */
+    const PartitionStats& getPartitionStats(int procId) const {return partitionStats.at(procId);}
+
+    /**
+     * Returns the total wall-clock time spent blocked, in seconds.
+     */
+    double getBlockedTime() const {return blockedNanosecs * 1e-9;}
+
+    /**
+     * Returns the number of times the partition blocked.
+     */
+    int64_t getNumBlockings() const {return numBlockings;}
+
+    /**
+     * Records the statistics as scalars of the given module.
+     */
+    void recordScalars(cModule *module);
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
@@ -22,24 +22,48 @@
 #include "omnetpp/cmodule.h"
 #include "omnetpp/cgate.h"
 #include "omnetpp/cenvir.h"
+#include "omnetpp/cconfiguration.h"
+#include "omnetpp/cconfigoption.h"
 #include "omnetpp/cparsimcomm.h"
 #include "omnetpp/ccommbuffer.h"
+#include "omnetpp/regmacros.h"
 #include "cparsimpartition.h"
 #include "messagetags.h"
+#include "cparsimprofiler.h"
 #include "cparsimprotocolbase.h"
 
 namespace omnetpp {
 
+Register_GlobalConfigOption(CFGID_PARSIM_MESSAGE_BATCHING, "parsim-message-batching", CFG_CUSTOM, "none", "With `parallel-simulation=true`: whether to coalesce messages sent to the same partition into a single buffer, so that they are transmitted with a single send operation. Possible values: `none`: every message is sent out immediately; `event`: messages sent to the same partition during an event are sent out together after the event; `lookahead`: messages are held back for up to a lookahead window (more precisely, until the next null message is due, or until the partition would block), and sent out together with the null message. The `lookahead` setting is understood by `cNullMessageProtocol`, and by `cYAWNSProtocol` (where messages are held back until the end of the time window); `cTimeWarpProtocol` ignores this setting, and other synchronization classes treat it as `event`. Messages are always delivered in the order they were sent.");
+
 cParsimProtocolBase::cParsimProtocolBase() : cParsimSynchronizer()
 {
+    std::string batchingStr = getEnvir()->getConfig()->getAsCustom(CFGID_PARSIM_MESSAGE_BATCHING);
+    if (batchingStr == "none")
+        batching = BATCHING_NONE;
+    else if (batchingStr == "event")
+        batching = BATCHING_EVENT;
+    else if (batchingStr == "lookahead")
+        batching = BATCHING_LOOKAHEAD;
+    else
+        throw cRuntimeError("Invalid value '%s' for '%s', expecting 'none', 'event' or 'lookahead'",
+                batchingStr.c_str(), CFGID_PARSIM_MESSAGE_BATCHING->getName());
 }
 
 cParsimProtocolBase::~cParsimProtocolBase()
 {
+    // discard batches that were not sent out
+    for (cCommBuffer *buffer : outgoingBatches)
+        delete buffer;
 }
 
 void cParsimProtocolBase::processOutgoingMessage(cMessage *msg, int destProcId, int destModuleId, int destGateId, void *)
 {
+    if (batching != BATCHING_NONE) {
+        addToBatch(msg, destProcId, destModuleId, destGateId);
+        return;
+    }
+
     cCommBuffer *buffer = comm->createCommBuffer();
 
     buffer->pack(destModuleId);
@@ -50,6 +74,61 @@ void cParsimProtocolBase::processOutgoingMessage(cMessage *msg, int destProcId,
     comm->recycleCommBuffer(buffer);
 }
 
+void cParsimProtocolBase::addToBatch(cMessage *msg, int destProcId, int destModuleId, int destGateId)
+{
+    if (destProcId >= (int)outgoingBatches.size())
+        outgoingBatches.resize(comm->getNumPartitions(), nullptr);
+
+    cCommBuffer *& buffer = outgoingBatches[destProcId];
+    if (!buffer) {
+        buffer = comm->createCommBuffer();
+        buffer->setZeroCopyEnabled(false);  // the batch outlives the messages packed into it
+        numPendingBatches++;
+    }
+    buffer->pack(destModuleId);
+    buffer->pack(destGateId);
+    buffer->packObject(msg);
+}
+
+cCommBuffer *cParsimProtocolBase::detachBatch(int destProcId)
+{
+    cCommBuffer *buffer = outgoingBatches[destProcId];
+    outgoingBatches[destProcId] = nullptr;
+    numPendingBatches--;
+    buffer->pack(-1);  // "the end"
+    return buffer;
+}
+
+void cParsimProtocolBase::flushBatch(int destProcId)
+{
+    if (!hasBatch(destProcId))
+        return;
+    cCommBuffer *buffer = detachBatch(destProcId);
+    comm->send(buffer, TAG_CMESSAGE_BATCH, destProcId);
+    comm->recycleCommBuffer(buffer);
+}
+
+void cParsimProtocolBase::flushOutgoingMessages()
+{
+    for (int i = 0; numPendingBatches > 0 && i < (int)outgoingBatches.size(); i++)
+        flushBatch(i);
+}
+
+void cParsimProtocolBase::processReceivedBatch(cCommBuffer *buffer, int sourceProcId)
+{
+    while (true) {
+        // moduleId==-1 indicates end of batch
+        int destModuleId;
+        buffer->unpack(destModuleId);
+        if (destModuleId == -1)
+            break;
+        int destGateId;
+        buffer->unpack(destGateId);
+        cMessage *msg = (cMessage *)buffer->unpackObject();
+        processReceivedMessage(msg, destModuleId, destGateId, sourceProcId);
+    }
+}
+
 void cParsimProtocolBase::processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId)
 {
     int destModuleId;
@@ -64,6 +143,10 @@ void cParsimProtocolBase::processReceivedBuffer(cCommBuffer *buffer, int tag, in
             processReceivedMessage(msg, destModuleId, destGateId, sourceProcId);
             break;
 
+        case TAG_CMESSAGE_BATCH:
+            processReceivedBatch(buffer, sourceProcId);
+            break;
+
         default:
             partition->processReceivedBuffer(buffer, tag, sourceProcId);
             break;
@@ -87,10 +170,22 @@ void cParsimProtocolBase::receiveNonblocking()
 
 bool cParsimProtocolBase::receiveBlocking()
 {
+    // other partitions may be waiting for the messages we are holding back
+    flushOutgoingMessages();
+
     cCommBuffer *buffer = comm->createCommBuffer();
 
+    cParsimProfiler *profiler = partition->getProfiler();
+    if (profiler)
+        profiler->blockingStarted();
+
     int tag, sourceProcId;
-    if (!comm->receiveBlocking(PARSIM_ANY_TAG, buffer, tag, sourceProcId)) {
+    bool received = comm->receiveBlocking(PARSIM_ANY_TAG, buffer, tag, sourceProcId);
+
+    if (profiler)
+        profiler->blockingEnded(sim->getSimTime());
+
+    if (!received) {
         comm->recycleCommBuffer(buffer);
         return false;
     }
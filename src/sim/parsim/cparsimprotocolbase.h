@@ -21,6 +21,7 @@
 #ifndef __OMNETPP_CPARSIMPROTOCOLBASE_H
 #define __OMNETPP_CPARSIMPROTOCOLBASE_H
 
+#include <vector>
 #include "cparsimsynchr.h"
 
 namespace omnetpp {
@@ -31,11 +32,44 @@ class cCommBuffer;
  * @brief Contains utility functions for implementing parallel simulation
  * protocols.
  *
+ * It also implements batching of outgoing messages (see the
+ * <tt>parsim-message-batching</tt> configuration option): messages to the
+ * same partition are packed into a common buffer which is sent out later
+ * with a single send() call, preserving the order of the messages. Subclasses
+ * decide when to send out the batches, by calling flushBatch() or
+ * flushOutgoingMessages(). Batches are always sent out before blocking
+ * in receiveBlocking().
+ *
  * @ingroup Parsim
  */
 class SIM_API cParsimProtocolBase : public cParsimSynchronizer
 {
   protected:
+    enum BatchingMode {
+        BATCHING_NONE,       // send every message immediately
+        BATCHING_EVENT,      // send messages produced by an event together
+        BATCHING_LOOKAHEAD   // send messages produced within a lookahead window together
+    };
+    BatchingMode batching;
+    std::vector<cCommBuffer*> outgoingBatches;  // indexed by procId; nullptr if there is no pending batch
+    int numPendingBatches = 0;
+
+  protected:
+    // append the message to the batch of the given partition
+    virtual void addToBatch(cMessage *msg, int destProcId, int destModuleId, int destGateId);
+
+    // returns true if there are messages waiting to be sent to the given partition
+    bool hasBatch(int destProcId) const {return destProcId < (int)outgoingBatches.size() && outgoingBatches[destProcId] != nullptr;}
+
+    // send out the messages waiting to be sent to the given partition, if there are any
+    virtual void flushBatch(int destProcId);
+
+    // remove the batch of the given partition (without sending it), and pack the end marker into it
+    cCommBuffer *detachBatch(int destProcId);
+
+    // process a batch of cMessages received from another partition
+    virtual void processReceivedBatch(cCommBuffer *buffer, int sourceProcId);
+
     // process whatever comes from other partitions -- nonblocking
     virtual void receiveNonblocking();
 
@@ -61,9 +95,16 @@ class SIM_API cParsimProtocolBase : public cParsimSynchronizer
     virtual ~cParsimProtocolBase();
 
     /**
-     * Performs no optimization, just sends out the cMessage to the given partition.
+     * Performs no optimization, just sends out the cMessage to the given
+     * partition, or adds it to the batch of the partition if batching is
+     * enabled.
      */
     virtual void processOutgoingMessage(cMessage *msg, int procId, int moduleId, int gateId, void *data) override;
+
+    /**
+     * Sends out all pending batches.
+     */
+    virtual void flushOutgoingMessages() override;
 };
 
 }  // namespace omnetpp
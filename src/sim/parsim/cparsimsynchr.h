@@ -106,6 +106,24 @@ class SIM_API cParsimSynchronizer : public cScheduler
      * (see null message algorithm) on outgoing messages.
      */
     virtual void processOutgoingMessage(cMessage *msg, int procId, int moduleId, int gateId, void *data) = 0;
+
+    /**
+     * Sends out the messages the synchronizer may have held back in order
+     * to send them together (see parsim-message-batching). It is called
+     * before other partitions are notified about the normal termination of
+     * the simulation. This default implementation does nothing.
+     */
+    virtual void flushOutgoingMessages() {}
+
+    /**
+     * Hook, called when a module promises not to send messages before
+     * time t on a link that leads to the given partition (see
+     * cSimpleModule::promiseEarliestSendTime()). The data pointer is that
+     * of the link's cProxyGate. Synchronizers may use the promise to
+     * announce a larger EOT to the partition. This default implementation
+     * does nothing.
+     */
+    virtual void promiseEarliestSendTime(simtime_t t, int procId, void *data) {}
 };
 
 }  // namespace omnetpp
@@ -24,9 +24,13 @@
 #include <cstdio>
 #include "cfilecomm.h"
 #include "cnamedpipecomm.h"
+#include "csharedmemorycomm.h"
+#include "cthreadcomm.h"
 #include "cmpicomm.h"
 #include "cnosynchronization.h"
 #include "cnullmessageprot.h"
+#include "cyawnsprot.h"
+#include "ctimewarpprot.h"
 #include "cispeventlogger.h"
 #include "cidealsimulationprot.h"
 #include "clinkdelaylookahead.h"
@@ -72,16 +76,24 @@ void parsim_dummy()
 {
     cFileCommunications fc;
     cNamedPipeCommunications npc;
+#ifdef WITH_SHAREDMEMORYCOMM
+    cSharedMemoryCommunications smc;
+#endif
+#ifdef WITH_THREADED_PARSIM
+    cThreadCommunications tc;
+#endif
 #ifdef WITH_MPI
     cMPICommunications mc;
 #endif
     cNoSynchronization ns;
     cNullMessageProtocol np;
+    cYAWNSProtocol yp;
+    cTimeWarpProtocol twp;
     cISPEventLogger iel;
     cIdealSimulationProtocol ip;
     cLinkDelayLookahead ldla;
     // prevent "unused variable" warnings:
-    (void)fc; (void)npc; (void)ns; (void)np; (void)iel; (void)ip; (void)ldla;
+    (void)fc; (void)npc; (void)ns; (void)np; (void)yp; (void)twp; (void)iel; (void)ip; (void)ldla;
 }
 
 }  // namespace omnetpp
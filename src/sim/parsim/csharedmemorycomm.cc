@@ -0,0 +1,502 @@
+//=========================================================================
+//  CSHAREDMEMORYCOMM.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2003-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include "csharedmemorycomm.h"
+
+#ifdef WITH_SHAREDMEMORYCOMM
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <new>
+#include <atomic>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <signal.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#include "common/fileutil.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/clog.h"
+#include "omnetpp/globals.h"
+#include "omnetpp/regmacros.h"
+#include "omnetpp/cconfigoption.h"
+#include "omnetpp/cenvir.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cconfiguration.h"
+#include "cmemcommbuffer.h"
+#include "cparsimprofiler.h"
+#include "parsimutil.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+
+Register_Class(cSharedMemoryCommunications);
+
+Register_GlobalConfigOption(CFGID_PARSIM_SHAREDMEMORYCOMM_PREFIX, "parsim-sharedmemorycommunications-prefix", CFG_STRING, "comm/", "When `cSharedMemoryCommunications` is selected as parsim communications class: selects the prefix (directory+potential filename prefix) where the memory-mapped files holding the ring buffers are created. On Linux, a directory on a tmpfs file system (e.g. `/dev/shm/`) avoids writing back the buffers to disk.");
+Register_GlobalConfigOptionU(CFGID_PARSIM_SHAREDMEMORYCOMM_RINGSIZE, "parsim-sharedmemorycommunications-ringsize", "B", "1MiB", "When `cSharedMemoryCommunications` is selected as parsim communications class: the size of the ring buffer between each pair of partitions. It limits the size of a single (packed) message, and the amount of data a partition may send ahead of its receiver.");
+
+#define SEGMENT_MAGIC    0x4f505053  // "OPPS"
+#define SPIN_COUNT       1000        // number of busy polls in receiveBlocking() and in send() while the ring is full
+#define YIELD_COUNT      100         // number of polls with sched_yield() before going to sleep in receiveBlocking() and send()
+#define SLEEP_NSECS      100000000   // sleep at most this long (100ms) before checking getEnvir()->idle()
+#define MAX_BACKOFF_USECS  1000      // longest sleep between polls in send() while the ring is full
+#define CACHELINE        64
+
+// Layout of a segment: a SegmentHeader, followed by numPartitions-1 (RingHeader + ring data) blocks.
+// The segment of partition k contains the rings in which the other partitions send messages to k,
+// in the order of the senders' procIds (k itself is skipped).
+struct cSharedMemoryCommunications::SegmentHeader
+{
+    std::atomic<uint32_t> magic;  // set to SEGMENT_MAGIC when the segment has been initialized
+    int32_t creatorPid;  // for recognizing segments left behind by a process that no longer exists
+    uint32_t numPartitions;
+    uint64_t ringCapacity;
+    alignas(CACHELINE) std::atomic<uint32_t> doorbell;  // futex word; senders increment it to wake up the receiver
+    std::atomic<uint32_t> sleeping;  // whether the receiver is (about to start) sleeping on the doorbell
+};
+
+struct cSharedMemoryCommunications::RingHeader
+{
+    alignas(CACHELINE) std::atomic<uint64_t> writePos;  // only written by the sender
+    alignas(CACHELINE) std::atomic<uint64_t> readPos;   // only written by the receiver
+};
+
+// Messages in a ring: a RecordHeader, followed by the contents padded to a multiple of 8 bytes.
+// Positions grow monotonically; the offset in the ring is position modulo capacity.
+struct RecordHeader
+{
+    int32_t tag;
+    int32_t length;
+};
+
+static inline size_t recordSize(size_t length)
+{
+    return sizeof(RecordHeader) + ((length + 7) & ~(size_t)7);
+}
+
+static inline size_t alignUp(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+static bool isProcessAlive(pid_t pid)
+{
+    return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+static inline void cpuRelax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile ("yield");
+#endif
+}
+
+static void waitOnDoorbell(std::atomic<uint32_t> *doorbell, uint32_t value)
+{
+#ifdef __linux__
+    struct timespec timeout = {0, SLEEP_NSECS};
+    syscall(SYS_futex, (uint32_t *)doorbell, FUTEX_WAIT, value, &timeout, nullptr, 0);
+#else
+    (void)doorbell;
+    (void)value;
+    usleep(100);
+#endif
+}
+
+static void ringDoorbell(std::atomic<uint32_t> *doorbell)
+{
+    doorbell->fetch_add(1);
+#ifdef __linux__
+    syscall(SYS_futex, (uint32_t *)doorbell, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#endif
+}
+
+static void copyToRing(char *ring, size_t capacity, uint64_t pos, const void *data, size_t length)
+{
+    size_t offset = pos % capacity;
+    size_t firstPart = std::min(length, capacity - offset);
+    memcpy(ring + offset, data, firstPart);
+    if (firstPart < length)
+        memcpy(ring, (const char *)data + firstPart, length - firstPart);
+}
+
+static void copyFromRing(const char *ring, size_t capacity, uint64_t pos, void *data, size_t length)
+{
+    size_t offset = pos % capacity;
+    size_t firstPart = std::min(length, capacity - offset);
+    memcpy(data, ring + offset, firstPart);
+    if (firstPart < length)
+        memcpy((char *)data + firstPart, ring, length - firstPart);
+}
+
+cSharedMemoryCommunications::cSharedMemoryCommunications()
+{
+    cConfiguration *config = getEnvir()->getConfig();
+    prefix = config->getAsString(CFGID_PARSIM_SHAREDMEMORYCOMM_PREFIX);
+    double ringSize = config->getAsDouble(CFGID_PARSIM_SHAREDMEMORYCOMM_RINGSIZE);
+    if (ringSize < 1024 || ringSize > INT32_MAX)
+        throw cRuntimeError("cSharedMemoryCommunications: Invalid ring size %g, must be between 1KiB and 2GiB", ringSize);
+    ringCapacity = alignUp((size_t)ringSize, CACHELINE);
+    segmentSize = 0;
+}
+
+cSharedMemoryCommunications::~cSharedMemoryCommunications()
+{
+    for (char *segment : segments)
+        if (segment)
+            munmap(segment, segmentSize);
+    for (StoredMessage& msg : storedMessages)
+        delete msg.buffer;
+}
+
+std::string cSharedMemoryCommunications::getSegmentFileName(int procId) const
+{
+    return prefix + "shm-" + std::to_string(procId);
+}
+
+cSharedMemoryCommunications::Ring cSharedMemoryCommunications::getRing(int receiverProcId, int senderProcId) const
+{
+    int index = senderProcId < receiverProcId ? senderProcId : senderProcId - 1;  // there is no ring for receiverProcId itself
+    char *p = segments[receiverProcId] + alignUp(sizeof(SegmentHeader), CACHELINE) + index * (sizeof(RingHeader) + ringCapacity);
+    Ring ring;
+    ring.header = (RingHeader *)p;
+    ring.data = p + sizeof(RingHeader);
+    return ring;
+}
+
+char *cSharedMemoryCommunications::createSegment()
+{
+    std::string fname = getSegmentFileName(myProcId);
+    EV << "cSharedMemoryCommunications: creating shared memory segment '" << fname << "'...\n";
+    mkPath(directoryOf(fname.c_str()).c_str());
+    unlink(fname.c_str());
+    int fd = open(fname.c_str(), O_RDWR|O_CREAT|O_EXCL, 0600);
+    if (fd == -1)
+        throw cRuntimeError("cSharedMemoryCommunications: Cannot create file '%s': %s", fname.c_str(), strerror(errno));
+    if (ftruncate(fd, segmentSize) == -1) {
+        close(fd);
+        throw cRuntimeError("cSharedMemoryCommunications: Cannot resize file '%s': %s", fname.c_str(), strerror(errno));
+    }
+    void *p = mmap(nullptr, segmentSize, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        throw cRuntimeError("cSharedMemoryCommunications: Cannot map file '%s': %s", fname.c_str(), strerror(errno));
+
+    // initialize headers (the file is zero-filled), then publish the segment
+    char *segment = (char *)p;
+    SegmentHeader *header = new(segment) SegmentHeader();
+    header->creatorPid = getpid();
+    header->numPartitions = numPartitions;
+    header->ringCapacity = ringCapacity;
+    header->doorbell.store(0);
+    header->sleeping.store(0);
+    for (int i = 0; i < numPartitions - 1; i++) {
+        char *ringStart = segment + alignUp(sizeof(SegmentHeader), CACHELINE) + i * (sizeof(RingHeader) + ringCapacity);
+        RingHeader *ringHeader = new(ringStart) RingHeader();
+        ringHeader->writePos.store(0);
+        ringHeader->readPos.store(0);
+    }
+    header->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+    return segment;
+}
+
+char *cSharedMemoryCommunications::openSegment(int procId)
+{
+    std::string fname = getSegmentFileName(procId);
+    EV << "cSharedMemoryCommunications: opening shared memory segment '" << fname << "'...\n";
+
+    // wait until the other partition has created and initialized it. The file
+    // may also be a leftover of an earlier (e.g. crashed) run, or it may get
+    // replaced by the other partition after we opened it; in both cases we
+    // retry until we find the segment of the currently running process.
+    const int maxTries = 300;  // 30s
+    for (int k = 0; k < maxTries; k++) {
+        if (k > 0)
+            usleep(100000);
+        int fd = open(fname.c_str(), O_RDWR);
+        if (fd == -1)
+            continue;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < segmentSize) {
+            close(fd);
+            continue;
+        }
+        void *p = mmap(nullptr, segmentSize, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED)
+            throw cRuntimeError("cSharedMemoryCommunications: Cannot map file '%s': %s", fname.c_str(), strerror(errno));
+
+        char *segment = (char *)p;
+        SegmentHeader *header = (SegmentHeader *)segment;
+        bool initialized = header->magic.load(std::memory_order_acquire) == SEGMENT_MAGIC;
+        bool stale = initialized && !isProcessAlive(header->creatorPid);
+
+        // check that the file has not been replaced since we opened it
+        struct stat st2;
+        bool replaced = stat(fname.c_str(), &st2) != 0 || st2.st_ino != st.st_ino || st2.st_dev != st.st_dev;
+
+        if (!initialized || stale || replaced) {
+            munmap(segment, segmentSize);
+            continue;
+        }
+        if ((int)header->numPartitions != numPartitions || header->ringCapacity != ringCapacity) {
+            int otherNumPartitions = header->numPartitions;
+            unsigned long otherRingCapacity = header->ringCapacity;
+            munmap(segment, segmentSize);
+            throw cRuntimeError("cSharedMemoryCommunications: Shared memory segment of procId=%d was created with different "
+                                "number of partitions or ring size (%d, %lu bytes)", procId, otherNumPartitions, otherRingCapacity);
+        }
+        return segment;
+    }
+    throw cRuntimeError("cSharedMemoryCommunications: Shared memory segment in '%s' was not created and initialized by procId=%d in time", fname.c_str(), procId);
+}
+
+void cSharedMemoryCommunications::init()
+{
+    // get numPartitions and myProcId from "-p" command-line option
+    getProcIdFromCommandLineArgs(myProcId, numPartitions, "cSharedMemoryCommunications");
+    EV << "cSharedMemoryCommunications: started as process " << myProcId << " out of " << numPartitions << ".\n";
+
+    spinCount = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SPIN_COUNT : 0;
+    segmentSize = alignUp(sizeof(SegmentHeader), CACHELINE) + (numPartitions - 1) * (sizeof(RingHeader) + ringCapacity);
+    segments.assign(numPartitions, nullptr);
+    segments[myProcId] = createSegment();
+    for (int i = 0; i < numPartitions; i++)
+        if (i != myProcId)
+            segments[i] = openSegment(i);
+
+    inRings.resize(numPartitions);
+    outRings.resize(numPartitions);
+    for (int i = 0; i < numPartitions; i++) {
+        if (i != myProcId) {
+            inRings[i] = getRing(myProcId, i);
+            outRings[i] = getRing(i, myProcId);
+        }
+    }
+}
+
+void cSharedMemoryCommunications::shutdown()
+{
+    for (char *& segment : segments) {
+        if (segment)
+            munmap(segment, segmentSize);
+        segment = nullptr;
+    }
+    inRings.clear();
+    outRings.clear();
+    if (myProcId != -1)
+        unlink(getSegmentFileName(myProcId).c_str());
+}
+
+int cSharedMemoryCommunications::getNumPartitions() const
+{
+    return numPartitions;
+}
+
+int cSharedMemoryCommunications::getProcId() const
+{
+    return myProcId;
+}
+
+cCommBuffer *cSharedMemoryCommunications::createCommBuffer()
+{
+    // send() copies the data into the ring, so the packed objects only need to exist until then
+    cMemCommBuffer *buffer = bufferPool.get();
+    buffer->setZeroCopyEnabled(true);
+    return buffer;
+}
+
+void cSharedMemoryCommunications::recycleCommBuffer(cCommBuffer *buffer)
+{
+    bufferPool.put((cMemCommBuffer *)buffer);
+}
+
+void cSharedMemoryCommunications::send(cCommBuffer *buffer, int tag, int destination)
+{
+    cMemCommBuffer *b = (cMemCommBuffer *)buffer;
+    size_t length = b->getPackedSize();
+    size_t size = recordSize(length);
+    if (size > ringCapacity)
+        throw cRuntimeError("cSharedMemoryCommunications: Message of %d bytes does not fit into the ring buffer "
+                            "to procId=%d, increase parsim-sharedmemorycommunications-ringsize", (int)length, destination);
+
+    // wait for room; meanwhile keep consuming our own rings, because the
+    // destination may be waiting for room in them. Spin for a while, then
+    // yield, then sleep with exponential backoff, checking getEnvir()->idle()
+    Ring& ring = outRings[destination];
+    uint64_t writePos = ring.header->writePos.load(std::memory_order_relaxed);
+    int k = 0;
+    useconds_t backoff = 1;
+    while (writePos + size - ring.header->readPos.load(std::memory_order_acquire) > ringCapacity) {
+        storeIncomingMessages();
+        if (k < spinCount) {
+            cpuRelax();
+            k++;
+        }
+        else if (k < spinCount + YIELD_COUNT) {
+            sched_yield();
+            k++;
+        }
+        else {
+            usleep(backoff);
+            backoff = std::min(2 * backoff, (useconds_t)MAX_BACKOFF_USECS);
+            if (getEnvir()->idle())
+                throw cRuntimeError("cSharedMemoryCommunications: send() to procId=%d interrupted by user", destination);
+        }
+    }
+
+    RecordHeader recordHeader;
+    recordHeader.tag = tag;
+    recordHeader.length = length;
+    copyToRing(ring.data, ringCapacity, writePos, &recordHeader, sizeof(recordHeader));
+    uint64_t pos = writePos + sizeof(recordHeader);
+    b->forEachSegment([&](const char *data, int len) {copyToRing(ring.data, ringCapacity, pos, data, len); pos += len;});
+    ring.header->writePos.store(writePos + size, std::memory_order_release);
+
+    // wake up the receiver if it is sleeping (the fence pairs with the one in receiveBlocking())
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    SegmentHeader *header = getSegmentHeader(destination);
+    if (header->sleeping.load(std::memory_order_relaxed))
+        ringDoorbell(&header->doorbell);
+
+    if (profiler)
+        profiler->bufferSent(destination, tag, length);
+}
+
+bool cSharedMemoryCommunications::pollRings(cMemCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    rrBase = (rrBase + 1) % numPartitions;
+    for (int k = 0; k < numPartitions; k++) {
+        int i = (rrBase + k) % numPartitions;  // shift by rrBase for Round-Robin query
+        if (i == myProcId)
+            continue;
+        Ring& ring = inRings[i];
+        uint64_t readPos = ring.header->readPos.load(std::memory_order_relaxed);
+        if (readPos == ring.header->writePos.load(std::memory_order_acquire))
+            continue;
+
+        RecordHeader recordHeader;
+        copyFromRing(ring.data, ringCapacity, readPos, &recordHeader, sizeof(recordHeader));
+        buffer->reset();
+        buffer->allocateAtLeast(recordHeader.length);
+        buffer->setMessageSize(recordHeader.length);
+        copyFromRing(ring.data, ringCapacity, readPos + sizeof(recordHeader), buffer->getBuffer(), recordHeader.length);
+        ring.header->readPos.store(readPos + recordSize(recordHeader.length), std::memory_order_release);
+
+        receivedTag = recordHeader.tag;
+        sourceProcId = i;
+        return true;
+    }
+    return false;
+}
+
+void cSharedMemoryCommunications::storeIncomingMessages()
+{
+    StoredMessage msg;
+    msg.buffer = bufferPool.get();
+    while (pollRings(msg.buffer, msg.tag, msg.sourceProcId)) {
+        storedMessages.push_back(msg);
+        msg.buffer = bufferPool.get();
+    }
+    bufferPool.put(msg.buffer);
+}
+
+bool cSharedMemoryCommunications::takeStoredMessage(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    for (auto it = storedMessages.begin(); it != storedMessages.end(); ++it) {
+        if (filtTag == PARSIM_ANY_TAG || it->tag == filtTag) {
+            // hand over the data by swapping buffers instead of copying
+            cMemCommBuffer *b = (cMemCommBuffer *)buffer;
+            b->swap(it->buffer);
+            receivedTag = it->tag;
+            sourceProcId = it->sourceProcId;
+            bufferPool.put(it->buffer);
+            storedMessages.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool cSharedMemoryCommunications::receive(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    bool received;
+    if (!storedMessages.empty() && takeStoredMessage(filtTag, buffer, receivedTag, sourceProcId))
+        received = true;
+    else if (filtTag == PARSIM_ANY_TAG)
+        received = pollRings((cMemCommBuffer *)buffer, receivedTag, sourceProcId);
+    else {
+        // tag filtering: store messages with other tags for later
+        storeIncomingMessages();
+        received = takeStoredMessage(filtTag, buffer, receivedTag, sourceProcId);
+    }
+    if (received && profiler)
+        profiler->bufferReceived(sourceProcId, receivedTag, ((cMemCommBuffer *)buffer)->getMessageSize());
+    return received;
+}
+
+bool cSharedMemoryCommunications::receiveBlocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    // spin for a while (unless there is only one CPU), then let other
+    // processes run (the sender may be on the same CPU), and only then go to sleep
+    for (int k = 0; k < spinCount + YIELD_COUNT; k++) {
+        if (receive(filtTag, buffer, receivedTag, sourceProcId))
+            return true;
+        if (k < spinCount)
+            cpuRelax();
+        else
+            sched_yield();
+    }
+
+    SegmentHeader *header = getSegmentHeader(myProcId);
+    while (true) {
+        // announce that we are going to sleep, then check the rings once more
+        // (the fence pairs with the one in send()), so that no wakeup is lost
+        uint32_t doorbell = header->doorbell.load();
+        header->sleeping.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool received = receive(filtTag, buffer, receivedTag, sourceProcId);
+        if (!received)
+            waitOnDoorbell(&header->doorbell, doorbell);
+        header->sleeping.store(0, std::memory_order_relaxed);
+        if (received || receive(filtTag, buffer, receivedTag, sourceProcId))
+            return true;
+        if (getEnvir()->idle())
+            return false;
+    }
+}
+
+bool cSharedMemoryCommunications::receiveNonblocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    return receive(filtTag, buffer, receivedTag, sourceProcId);
+}
+
+}  // namespace omnetpp
+
+#endif /* WITH_SHAREDMEMORYCOMM */
+
@@ -0,0 +1,174 @@
+//=========================================================================
+//  CSHAREDMEMORYCOMM.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2003-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+
+#ifndef __OMNETPP_CSHAREDMEMORYCOMM_H
+#define __OMNETPP_CSHAREDMEMORYCOMM_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include "omnetpp/cparsimcomm.h"
+#include "cmemcommbuffer.h"
+
+// shared memory rings need mmap(); not available on Windows
+#if !defined(_WIN32)
+#define WITH_SHAREDMEMORYCOMM
+#endif
+
+#ifdef WITH_SHAREDMEMORYCOMM
+
+namespace omnetpp {
+
+/**
+ * @brief Implementation of the communications layer for partitions that run
+ * as processes on the same host, using lock-free ring buffers in shared memory.
+ *
+ * Every partition creates a memory-mapped file that contains one
+ * single-producer/single-consumer ring buffer for each other partition.
+ * Sending a message means copying the packed buffer (gathering its external
+ * segments, see cCommBuffer::packExternal()) into the ring of the
+ * destination partition, and publishing it by advancing the ring's write
+ * position; no system call is needed. A blocking receive spins for a short
+ * while (on multi-core hosts), then yields the CPU a few times, then goes to sleep (on Linux, on a futex in the shared memory
+ * region; elsewhere, with short sleeps); senders only wake up the receiver
+ * if it is actually sleeping.
+ *
+ * If the destination's ring is full, the sender waits until there is
+ * enough room, and meanwhile stores the messages arriving to its own rings
+ * to avoid deadlocks. A message that does not fit into an empty ring is
+ * an error; the ring size can be configured.
+ *
+ * Like cNamedPipeCommunications, the processes are expected to be started
+ * with the <tt>-p&lt;procId&gt;,&lt;numPartitions&gt;</tt> command-line
+ * option, e.g. via opp_prun.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cSharedMemoryCommunications : public cParsimCommunications
+{
+  protected:
+    struct SegmentHeader;
+    struct RingHeader;
+    struct Ring {
+        RingHeader *header = nullptr;
+        char *data = nullptr;
+    };
+    struct StoredMessage {
+        cMemCommBuffer *buffer;
+        int tag;
+        int sourceProcId;
+    };
+
+    int numPartitions = 0;
+    int myProcId = -1;
+
+    std::string prefix;
+    size_t ringCapacity;  // bytes of data per ring
+    size_t segmentSize;
+    std::vector<char *> segments;  // mapped segments, indexed by procId of the receiving partition
+    std::vector<Ring> inRings;   // rings others write to us, indexed by source procId
+    std::vector<Ring> outRings;  // rings we write to, indexed by destination procId
+    int rrBase = 0;
+    int spinCount = 0;  // number of busy polls in receiveBlocking() before yielding the CPU
+
+    // messages received while waiting for room to send, or not matching filtTag
+    std::deque<StoredMessage> storedMessages;
+    cMemCommBufferPool bufferPool;
+
+  protected:
+    std::string getSegmentFileName(int procId) const;
+    SegmentHeader *getSegmentHeader(int procId) const {return (SegmentHeader *)segments[procId];}
+    Ring getRing(int receiverProcId, int senderProcId) const;
+    char *createSegment();
+    char *openSegment(int procId);
+    bool pollRings(cMemCommBuffer *buffer, int& receivedTag, int& sourceProcId);
+    void storeIncomingMessages();
+    bool takeStoredMessage(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId);
+    bool receive(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId);
+
+  public:
+    /**
+     * Constructor.
+     */
+    cSharedMemoryCommunications();
+
+    /**
+     * Destructor.
+     */
+    virtual ~cSharedMemoryCommunications();
+
+    /** @name Redefined methods from cParsimCommunications */
+    //@{
+    /**
+     * Init the library. Here we create our shared memory segment, and map the
+     * segments of the other partitions.
+     */
+    virtual void init() override;
+
+    /**
+     * Shutdown the communications library. Unmaps the shared memory segments,
+     * and removes the file of our own one.
+     */
+    virtual void shutdown() override;
+
+    /**
+     * Returns total number of partitions.
+     */
+    virtual int getNumPartitions() const override;
+
+    /**
+     * Returns the id of this partition.
+     */
+    virtual int getProcId() const override;
+
+    /**
+     * Returns an empty buffer of type cMemCommBuffer from the pool, with
+     * zero-copy packing enabled.
+     */
+    virtual cCommBuffer *createCommBuffer() override;
+
+    /**
+     * Returns the buffer to the pool.
+     */
+    virtual void recycleCommBuffer(cCommBuffer *buffer) override;
+
+    /**
+     * Copies the packed data with the given tag into the ring of the destination.
+     */
+    virtual void send(cCommBuffer *buffer, int tag, int destination) override;
+
+    /**
+     * Receives packed data, and also returns tag and source procId.
+     * Normally returns true; false is returned if blocking was interrupted by the user.
+     */
+    virtual bool receiveBlocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId) override;
+
+    /**
+     * Receives packed data, and also returns tag and source procId.
+     * Call is non-blocking -- it returns true if something has been
+     * received, false otherwise.
+     */
+    virtual bool receiveNonblocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId) override;
+    //@}
+};
+
+}  // namespace omnetpp
+
+#endif /* WITH_SHAREDMEMORYCOMM */
+
+#endif
+
@@ -0,0 +1,188 @@
+//=========================================================================
+//  CTHREADCOMM.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2003-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include "cthreadcomm.h"
+
+#ifdef WITH_THREADED_PARSIM
+
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "omnetpp/cexception.h"
+#include "omnetpp/clog.h"
+#include "omnetpp/globals.h"
+#include "omnetpp/regmacros.h"
+#include "omnetpp/cenvir.h"
+#include "omnetpp/csimulation.h"
+#include "cmemcommbuffer.h"
+#include "cparsimprofiler.h"
+
+namespace omnetpp {
+
+Register_Class(cThreadCommunications);
+
+#define WAIT_MSECS         100  // wait at most this long before checking getEnvir()->idle()
+#define MAX_SPARE_BUFFERS  64
+#define INITIAL_CAPACITY   4096
+
+struct cThreadCommunications::Mailbox
+{
+    std::mutex mutex;
+    std::condition_variable cond;  // signalled when an item is added
+    std::deque<Item> items;
+};
+
+std::vector<cThreadCommunications::Mailbox *> cThreadCommunications::mailboxes;
+thread_local int cThreadCommunications::threadProcId = -1;
+
+void cThreadCommunications::createMailboxes(int numPartitions)
+{
+    ASSERT(mailboxes.empty());
+    for (int i = 0; i < numPartitions; i++)
+        mailboxes.push_back(new Mailbox());
+}
+
+void cThreadCommunications::deleteMailboxes()
+{
+    for (Mailbox *mailbox : mailboxes) {
+        for (Item& item : mailbox->items)
+            delete item.buffer;
+        delete mailbox;
+    }
+    mailboxes.clear();
+}
+
+cThreadCommunications::cThreadCommunications() : bufferPool(MAX_SPARE_BUFFERS, INITIAL_CAPACITY)
+{
+}
+
+cThreadCommunications::~cThreadCommunications()
+{
+}
+
+void cThreadCommunications::init()
+{
+    if (threadProcId == -1 || mailboxes.empty())
+        throw cRuntimeError("cThreadCommunications: Partitions must run as threads of the same process, "
+                            "set parsim-threadcommunications-numpartitions in the [General] section");
+    myProcId = threadProcId;
+    numPartitions = mailboxes.size();
+    EV << "cThreadCommunications: started as thread " << myProcId << " out of " << numPartitions << ".\n";
+}
+
+void cThreadCommunications::shutdown()
+{
+    bufferPool.clear();
+}
+
+int cThreadCommunications::getNumPartitions() const
+{
+    return numPartitions;
+}
+
+int cThreadCommunications::getProcId() const
+{
+    return myProcId;
+}
+
+cCommBuffer *cThreadCommunications::createCommBuffer()
+{
+    // send() copies the data, so the packed objects only need to exist until then
+    cMemCommBuffer *buffer = bufferPool.get();
+    buffer->setZeroCopyEnabled(true);
+    return buffer;
+}
+
+void cThreadCommunications::recycleCommBuffer(cCommBuffer *buffer)
+{
+    bufferPool.put((cMemCommBuffer *)buffer);
+}
+
+void cThreadCommunications::send(cCommBuffer *buffer, int tag, int destination)
+{
+    // copy the data, because the caller may reuse the buffer (e.g. in broadcast());
+    // external segments are gathered directly into the copy
+    cMemCommBuffer *b = (cMemCommBuffer *)buffer;
+    int length = b->getPackedSize();
+    Item item;
+    item.buffer = bufferPool.get();
+    item.buffer->allocateAtLeast(length);
+    item.buffer->setMessageSize(length);
+    char *dest = item.buffer->getBuffer();
+    b->forEachSegment([&](const char *data, int size) {memcpy(dest, data, size); dest += size;});
+    item.tag = tag;
+    item.sourceProcId = myProcId;
+
+    Mailbox *mailbox = mailboxes[destination];
+    {
+        std::lock_guard<std::mutex> lock(mailbox->mutex);
+        mailbox->items.push_back(item);
+    }
+    mailbox->cond.notify_one();
+
+    if (profiler)
+        profiler->bufferSent(destination, tag, length);
+}
+
+bool cThreadCommunications::takeItem(Mailbox *mailbox, int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    // note: mailbox must be locked by the caller
+    for (auto it = mailbox->items.begin(); it != mailbox->items.end(); ++it) {
+        if (filtTag == PARSIM_ANY_TAG || it->tag == filtTag) {
+            // hand over the data by swapping buffers; the caller's old buffer becomes a spare one
+            cMemCommBuffer *itemBuffer = it->buffer;
+            itemBuffer->swap((cMemCommBuffer *)buffer);
+            receivedTag = it->tag;
+            sourceProcId = it->sourceProcId;
+            mailbox->items.erase(it);
+            if (profiler)
+                profiler->bufferReceived(sourceProcId, receivedTag, ((cMemCommBuffer *)buffer)->getMessageSize());
+            bufferPool.put(itemBuffer);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool cThreadCommunications::receiveBlocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    Mailbox *mailbox = mailboxes[myProcId];
+    std::unique_lock<std::mutex> lock(mailbox->mutex);
+    while (!takeItem(mailbox, filtTag, buffer, receivedTag, sourceProcId)) {
+        if (mailbox->cond.wait_for(lock, std::chrono::milliseconds(WAIT_MSECS)) == std::cv_status::timeout) {
+            lock.unlock();
+            bool interrupted = getEnvir()->idle();
+            lock.lock();
+            if (interrupted)
+                return false;
+        }
+    }
+    return true;
+}
+
+bool cThreadCommunications::receiveNonblocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    Mailbox *mailbox = mailboxes[myProcId];
+    std::lock_guard<std::mutex> lock(mailbox->mutex);
+    return takeItem(mailbox, filtTag, buffer, receivedTag, sourceProcId);
+}
+
+}  // namespace omnetpp
+
+#endif /* WITH_THREADED_PARSIM */
+
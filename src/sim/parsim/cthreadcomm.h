@@ -0,0 +1,167 @@
+//=========================================================================
+//  CTHREADCOMM.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2003-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+
+#ifndef __OMNETPP_CTHREADCOMM_H
+#define __OMNETPP_CTHREADCOMM_H
+
+#include <vector>
+#include "omnetpp/cparsimcomm.h"
+#include "cmemcommbuffer.h"
+
+#ifdef WITH_THREADED_PARSIM
+
+namespace omnetpp {
+
+/**
+ * @brief Implementation of the communications layer for partitions that run
+ * as threads of the same process.
+ *
+ * Every partition has a mailbox: a queue protected by a mutex, with a
+ * condition variable to wait on. Sending a message copies the packed data
+ * (including external segments, see cCommBuffer::packExternal()) into a
+ * spare buffer, and appends it to the mailbox of the destination.
+ * Receiving hands the buffer over to the caller by swapping its contents
+ * with the caller's buffer, so the data is copied only once, and neither
+ * system calls nor files are involved.
+ *
+ * The partitions are not started by opp_prun, but by the user interface,
+ * as threads (see the <tt>parsim-threadcommunications-numpartitions</tt>
+ * configuration option). It creates the mailboxes before starting the threads,
+ * and tells each thread its partition via setThreadProcId().
+ *
+ * This class is only available if \opp was built with WITH_THREADED_PARSIM,
+ * because the partitions can only share the process if the global state of
+ * the simulation kernel is thread-local.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cThreadCommunications : public cParsimCommunications
+{
+  protected:
+    struct Mailbox;
+    struct Item {
+        cMemCommBuffer *buffer;
+        int tag;
+        int sourceProcId;
+    };
+
+    static std::vector<Mailbox*> mailboxes;  // indexed by procId
+    static thread_local int threadProcId;
+
+    int numPartitions = 0;
+    int myProcId = -1;
+    cMemCommBufferPool bufferPool;  // for createCommBuffer() and send(); filled by receiving
+    bool takeItem(Mailbox *mailbox, int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId);
+
+  public:
+    /** @name Starting the partitions */
+    //@{
+    /**
+     * Creates the mailboxes for the given number of partitions. Must be called
+     * before the threads of the partitions are started.
+     */
+    static void createMailboxes(int numPartitions);
+
+    /**
+     * Deletes the mailboxes, and the messages that are still in them.
+     * Must be called after all partitions have terminated.
+     */
+    static void deleteMailboxes();
+
+    /**
+     * Sets the partition that runs in the calling thread.
+     */
+    static void setThreadProcId(int procId) {threadProcId = procId;}
+
+    /**
+     * Returns the partition that runs in the calling thread, or -1 if the
+     * calling thread does not run a partition.
+     */
+    static int getThreadProcId() {return threadProcId;}
+    //@}
+
+    /**
+     * Constructor.
+     */
+    cThreadCommunications();
+
+    /**
+     * Destructor.
+     */
+    virtual ~cThreadCommunications();
+
+    /** @name Redefined methods from cParsimCommunications */
+    //@{
+    /**
+     * Init the library. Takes the procId of the partition from the calling
+     * thread, and the number of partitions from the number of mailboxes.
+     */
+    virtual void init() override;
+
+    /**
+     * Shutdown the communications library.
+     */
+    virtual void shutdown() override;
+
+    /**
+     * Returns total number of partitions.
+     */
+    virtual int getNumPartitions() const override;
+
+    /**
+     * Returns the id of this partition.
+     */
+    virtual int getProcId() const override;
+
+    /**
+     * Returns an empty buffer of type cMemCommBuffer from the pool, with
+     * zero-copy packing enabled.
+     */
+    virtual cCommBuffer *createCommBuffer() override;
+
+    /**
+     * Returns the buffer to the pool.
+     */
+    virtual void recycleCommBuffer(cCommBuffer *buffer) override;
+
+    /**
+     * Appends a copy of the packed data with the given tag to the mailbox
+     * of the destination.
+     */
+    virtual void send(cCommBuffer *buffer, int tag, int destination) override;
+
+    /**
+     * Receives packed data, and also returns tag and source procId.
+     * Normally returns true; false is returned if blocking was interrupted by the user.
+     */
+    virtual bool receiveBlocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId) override;
+
+    /**
+     * Receives packed data, and also returns tag and source procId.
+     * Call is non-blocking -- it returns true if something has been
+     * received, false otherwise.
+     */
+    virtual bool receiveNonblocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId) override;
+    //@}
+};
+
+}  // namespace omnetpp
+
+#endif /* WITH_THREADED_PARSIM */
+
+#endif
+
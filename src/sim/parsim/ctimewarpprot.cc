@@ -0,0 +1,702 @@
+//=========================================================================
+//  CTIMEWARPPROT.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2003-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include "omnetpp/cmessage.h"
+#include "omnetpp/csimplemodule.h"
+#include "omnetpp/cenvir.h"
+#include "omnetpp/cconfiguration.h"
+#include "omnetpp/cparsimcomm.h"
+#include "omnetpp/ccommbuffer.h"
+#include "omnetpp/ceventheap.h"
+#include "omnetpp/cclassdescriptor.h"
+#include "omnetpp/cstatesaving.h"
+#include "omnetpp/globals.h"
+#include "omnetpp/cconfigoption.h"
+#include "omnetpp/regmacros.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/errmsg.h"
+#include "omnetpp/opp_string.h"
+#include "ctimewarpprot.h"
+#include "cmemcommbuffer.h"
+#include "cparsimpartition.h"
+#include "messagetags.h"
+
+namespace omnetpp {
+
+Register_Class(cTimeWarpProtocol);
+
+Register_GlobalConfigOption(CFGID_PARSIM_TIMEWARP_GVT_INTERVAL, "parsim-timewarp-gvt-interval", CFG_INT, "1000", "When `cTimeWarpProtocol` is selected as parsim synchronization class: the number of events a partition executes between GVT (Global Virtual Time) computations. GVT computation requires all partitions to exchange a message, and records of events before GVT are discarded after it, so this setting trades synchronization overhead against memory usage.");
+extern cConfigOption *CFGID_PARSIM_DEBUG;  // registered in cparsimpartition.cc
+
+#define MAX_SPARE_BUFFERS  1024
+
+cTimeWarpProtocol::cTimeWarpProtocol() : cParsimProtocolBase()
+{
+    currentEvent = nullptr;
+    nextSeqNum = 0;
+    minSentTime = SIMTIME_MAX;
+    heapUsedCb = false;
+    gvt = SIMTIME_ZERO;
+    gvtRound = 0;
+    gvtReports[0] = gvtReports[1] = {0, SIMTIME_MAX};
+    eventsSinceGVT = 0;
+    numEvents = numRollbacks = numRolledBackEvents = numAntiMessages = 0;
+
+    debug = getEnvir()->getConfig()->getAsBool(CFGID_PARSIM_DEBUG);
+    gvtInterval = getEnvir()->getConfig()->getAsInt(CFGID_PARSIM_TIMEWARP_GVT_INTERVAL);
+    if (gvtInterval < 1)
+        throw cRuntimeError("cTimeWarpProtocol: Invalid value %d for parsim-timewarp-gvt-interval, must be positive", gvtInterval);
+}
+
+cTimeWarpProtocol::~cTimeWarpProtocol()
+{
+    clear();
+    for (cMemCommBuffer *buffer : spareBuffers)
+        delete buffer;
+    if (sim && sim->getFESListener() == this)
+        sim->setFESListener(nullptr);
+}
+
+void cTimeWarpProtocol::startRun()
+{
+    EV << "starting Time Warp Protocol...\n";
+
+    clear();
+    nextSeqNum = 0;
+    minSentTime = SIMTIME_MAX;
+    gvt = SIMTIME_ZERO;
+    gvtRound = 0;
+    gvtReports[0] = gvtReports[1] = {0, SIMTIME_MAX};
+    eventsSinceGVT = 0;
+    numEvents = numRollbacks = numRolledBackEvents = numAntiMessages = 0;
+    moduleInfos.clear();
+
+    // rollbacks move simulation time backwards, which the circular buffer of
+    // cEventHeap (used for events at the current simulation time) cannot handle
+    cEventHeap *heap = dynamic_cast<cEventHeap *>(sim->getFES());
+    heapUsedCb = heap && heap->getUseCb();
+    if (heapUsedCb)
+        heap->setUseCb(false);
+
+    sim->setFESListener(this);
+
+    EV << "  setup done.\n";
+}
+
+void cTimeWarpProtocol::endRun()
+{
+    clear();
+    if (sim->getFESListener() == this)
+        sim->setFESListener(nullptr);
+    if (heapUsedCb)
+        static_cast<cEventHeap *>(sim->getFES())->setUseCb(true);
+
+    EV << "cTimeWarpProtocol: " << numEvents << " events executed, " << numRolledBackEvents << " of them rolled back in "
+       << numRollbacks << " rollbacks, " << numAntiMessages << " anti-messages sent, " << gvtRound << " GVT rounds\n";
+}
+
+void cTimeWarpProtocol::clear()
+{
+    currentEvent = nullptr;
+    while (!processedEvents.empty()) {
+        commitEvent(processedEvents.front());
+        processedEvents.pop_front();
+    }
+    for (auto& item : receivedMessages)
+        releaseRef(item.second.ref);
+    receivedMessages.clear();
+    ASSERT(eventRefs.empty());
+}
+
+cMemCommBuffer *cTimeWarpProtocol::createBuffer()
+{
+    if (spareBuffers.empty())
+        return new cMemCommBuffer();
+    cMemCommBuffer *buffer = spareBuffers.back();
+    spareBuffers.pop_back();
+    return buffer;
+}
+
+void cTimeWarpProtocol::recycleBuffer(cMemCommBuffer *buffer)
+{
+    if (spareBuffers.size() < MAX_SPARE_BUFFERS) {
+        buffer->reset();
+        spareBuffers.push_back(buffer);
+    }
+    else {
+        delete buffer;
+    }
+}
+
+//----
+
+cTimeWarpProtocol::EventRef *cTimeWarpProtocol::getRef(cEvent *event)
+{
+    auto it = eventRefs.find(event);
+    if (it != eventRefs.end()) {
+        it->second->refCount++;
+        return it->second;
+    }
+    EventRef *ref = new EventRef {event, 1};
+    eventRefs[event] = ref;
+    event->setTracked(true);
+    return ref;
+}
+
+void cTimeWarpProtocol::releaseRef(EventRef *ref)
+{
+    if (--ref->refCount > 0)
+        return;
+    if (ref->event) {
+        ref->event->setTracked(false);
+        eventRefs.erase(ref->event);
+    }
+    delete ref;
+}
+
+void cTimeWarpProtocol::replaceRef(EventRef *ref, cEvent *event)
+{
+    // let the references point to another object that stands for the original one
+    if (ref->event) {
+        ref->event->setTracked(false);
+        eventRefs.erase(ref->event);
+    }
+    ref->event = event;
+    eventRefs[event] = ref;
+    event->setTracked(true);
+}
+
+void cTimeWarpProtocol::deleteEvent(EventRef *ref)
+{
+    cEvent *event = ref->event;
+    event->setTracked(false);
+    eventRefs.erase(event);
+    ref->event = nullptr;
+    if (event->isScheduled())
+        sim->getFES()->remove(event);
+    delete event;
+}
+
+void cTimeWarpProtocol::trackedEventDeleted(cEvent *event)
+{
+    auto it = eventRefs.find(event);
+    if (it != eventRefs.end()) {
+        it->second->event = nullptr;
+        eventRefs.erase(it);
+    }
+}
+
+//----
+
+void cTimeWarpProtocol::eventInserted(cEvent *event)
+{
+    if (!currentEvent)
+        return;
+    if (!event->isMessage())
+        throw cRuntimeError("cTimeWarpProtocol: Scheduling events that are not messages is not supported");
+    bool isNew = static_cast<cMessage *>(event)->getId() > currentEvent->backup->getId();
+    currentEvent->fesChanges.push_back(FESChange {FESChange::INSERTED, getRef(event), SIMTIME_ZERO, SIMTIME_ZERO, isNew});
+}
+
+void cTimeWarpProtocol::eventRescheduled(cEvent *event, simtime_t oldTime)
+{
+    if (!currentEvent)
+        return;
+    if (!event->isMessage())
+        throw cRuntimeError("cTimeWarpProtocol: Rescheduling events that are not messages is not supported");
+    cMessage *msg = static_cast<cMessage *>(event);
+    bool isNew = msg->getId() > currentEvent->backup->getId();
+    currentEvent->fesChanges.push_back(FESChange {FESChange::RESCHEDULED, getRef(event), oldTime, msg->getSendingTime(), isNew});
+}
+
+void cTimeWarpProtocol::eventCancelled(cEvent *event)
+{
+    if (!currentEvent)
+        return;
+    if (!event->isMessage())
+        throw cRuntimeError("cTimeWarpProtocol: Cancelling events that are not messages is not supported");
+    bool isNew = static_cast<cMessage *>(event)->getId() > currentEvent->backup->getId();
+    currentEvent->fesChanges.push_back(FESChange {FESChange::CANCELLED, getRef(event), event->getArrivalTime(), SIMTIME_ZERO, isNew});
+}
+
+//----
+
+cTimeWarpProtocol::ModuleInfo& cTimeWarpProtocol::getModuleInfo(cSimpleModule *module)
+{
+    int id = module->getId();
+    if (id >= (int)moduleInfos.size())
+        moduleInfos.resize(id + 1);
+    ModuleInfo& info = moduleInfos[id];
+    if (info.resolved)
+        return info;
+
+    if (module->usesActivity())
+        throw cRuntimeError(module, "cTimeWarpProtocol: Modules that use activity() are not supported");
+
+    info.hooks = dynamic_cast<cIStateSaving *>(module);
+    if (!info.hooks) {
+        // the state consists of the fields declared in the module class (and not in cSimpleModule or its base classes)
+        cClassDescriptor *desc = cClassDescriptor::getDescriptorFor(module);
+        cClassDescriptor *simpleModuleDesc = cClassDescriptor::getDescriptorFor("omnetpp::cSimpleModule");
+        cClassDescriptor *baseDesc = desc;
+        while (baseDesc && baseDesc != simpleModuleDesc)
+            baseDesc = baseDesc->getBaseClassDescriptor();
+        int firstField = baseDesc ? baseDesc->getFieldCount() : 0;
+        if (desc && firstField < desc->getFieldCount()) {
+            for (int i = firstField; i < desc->getFieldCount(); i++) {
+                unsigned int flags = desc->getFieldTypeFlags(i);
+                if ((flags & (cClassDescriptor::FD_ISCOMPOUND | cClassDescriptor::FD_ISPOINTER)) || !(flags & cClassDescriptor::FD_ISEDITABLE))
+                    throw cRuntimeError(module, "cTimeWarpProtocol: Cannot save field '%s' of class %s, only editable fields of basic types "
+                                                "are supported; implement cIStateSaving in the module class instead",
+                                                desc->getFieldName(i), desc->getFullName());
+            }
+            info.descriptor = desc;
+            info.firstField = firstField;
+        }
+    }
+    info.resolved = true;
+    return info;
+}
+
+cMemCommBuffer *cTimeWarpProtocol::saveModuleState(cSimpleModule *module)
+{
+    ModuleInfo& info = getModuleInfo(module);
+    if (!info.hooks && !info.descriptor)
+        return nullptr;  // stateless
+
+    cMemCommBuffer *buffer = createBuffer();
+    if (info.hooks)
+        info.hooks->saveState(buffer);
+    else {
+        cClassDescriptor *desc = info.descriptor;
+        for (int i = info.firstField; i < desc->getFieldCount(); i++) {
+            if (!desc->getFieldIsArray(i))
+                buffer->pack(desc->getFieldValueAsString(module, i, 0).c_str());
+            else {
+                int size = desc->getFieldArraySize(module, i);
+                buffer->pack(size);
+                for (int k = 0; k < size; k++)
+                    buffer->pack(desc->getFieldValueAsString(module, i, k).c_str());
+            }
+        }
+    }
+    return buffer;
+}
+
+void cTimeWarpProtocol::restoreModuleState(cSimpleModule *module, cMemCommBuffer *buffer)
+{
+    ModuleInfo& info = getModuleInfo(module);
+    if (info.hooks)
+        info.hooks->restoreState(buffer);
+    else {
+        cClassDescriptor *desc = info.descriptor;
+        opp_string value;
+        for (int i = info.firstField; i < desc->getFieldCount(); i++) {
+            if (!desc->getFieldIsArray(i)) {
+                buffer->unpack(value);
+                desc->setFieldValueAsString(module, i, 0, value.c_str());
+            }
+            else {
+                int size;
+                buffer->unpack(size);
+                if (desc->getFieldArraySize(module, i) != size) {
+                    if (!desc->getFieldIsResizable(i))
+                        throw cRuntimeError(module, "cTimeWarpProtocol: Cannot restore array field '%s' of class %s, its size has changed",
+                                                    desc->getFieldName(i), desc->getFullName());
+                    desc->setFieldArraySize(module, i, size);
+                }
+                for (int k = 0; k < size; k++) {
+                    buffer->unpack(value);
+                    desc->setFieldValueAsString(module, i, k, value.c_str());
+                }
+            }
+        }
+    }
+    buffer->assertBufferEmpty();
+}
+
+//----
+
+void cTimeWarpProtocol::beginEvent(cMessage *msg)
+{
+    cSimpleModule *module = static_cast<cSimpleModule *>(msg->getArrivalModule());
+
+    ProcessedEvent *event = new ProcessedEvent();
+    event->arrivalTime = msg->getArrivalTime();
+    event->priority = msg->getSchedulingPriority();
+    event->moduleId = module->getId();
+    event->msgRef = getRef(msg);
+    event->state = saveModuleState(module);
+
+    // the module may modify or delete the message, so we keep a copy. Its ID is also
+    // used to tell which messages were created by the event: they have larger IDs.
+    cMessage *backup = msg->dup();
+    backup->setArrival(msg->getArrivalModuleId(), msg->getArrivalGateId(), msg->getArrivalTime());
+    backup->setSchedulingPriority(msg->getSchedulingPriority());
+    event->backup = backup;
+
+    processedEvents.push_back(event);
+    currentEvent = event;
+    numEvents++;
+}
+
+void cTimeWarpProtocol::commitEvent(ProcessedEvent *event)
+{
+    for (FESChange& change : event->fesChanges)
+        releaseRef(change.ref);
+    releaseRef(event->msgRef);
+    delete event->backup;
+    if (event->state)
+        recycleBuffer(event->state);
+    delete event;
+}
+
+void cTimeWarpProtocol::fossilCollect(simtime_t t)
+{
+    while (!processedEvents.empty() && processedEvents.front()->arrivalTime < t) {
+        commitEvent(processedEvents.front());
+        processedEvents.pop_front();
+    }
+
+    // messages before GVT cannot be cancelled any more
+    for (auto it = receivedMessages.begin(); it != receivedMessages.end(); ) {
+        if (it->second.arrivalTime < t) {
+            releaseRef(it->second.ref);
+            it = receivedMessages.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+void cTimeWarpProtocol::rollback(simtime_t t, short priority, bool inclusive)
+{
+    auto isAfter = [&](ProcessedEvent *event) {
+        return event->arrivalTime > t || (event->arrivalTime == t && (event->priority > priority || (inclusive && event->priority == priority)));
+    };
+
+    if (processedEvents.empty() || !isAfter(processedEvents.back()))
+        return;
+    if (t < gvt)
+        throw cRuntimeError("cTimeWarpProtocol: Rollback to t=%s requested, which is before GVT=%s", SIMTIME_STR(t), SIMTIME_STR(gvt));
+
+    {if (debug) EV << "rolling back to t=" << t << "\n";}
+
+    numRollbacks++;
+    while (!processedEvents.empty() && isAfter(processedEvents.back())) {
+        ProcessedEvent *event = processedEvents.back();
+        processedEvents.pop_back();
+        undoEvent(event);
+        delete event;
+        numRolledBackEvents++;
+    }
+
+    // continue from the last event that remained (events before GVT have been committed)
+    sim->setSimTime(processedEvents.empty() ? gvt : processedEvents.back()->arrivalTime);
+}
+
+void cTimeWarpProtocol::undoEvent(ProcessedEvent *event)
+{
+    cFutureEventSet *fes = sim->getFES();
+
+    // undo the changes to the FES, in reverse order
+    for (auto it = event->fesChanges.rbegin(); it != event->fesChanges.rend(); ++it) {
+        FESChange& change = *it;
+        cEvent *e = change.ref->event;
+        if (!e) {
+            // objects created by the event may have been deleted by it as well
+            if (!change.isNew)
+                throw cRuntimeError("cTimeWarpProtocol: Cannot roll back event at t=%s: A self-message it cancelled or rescheduled "
+                                    "has been deleted since (self-messages must not be deleted during the simulation)",
+                                    SIMTIME_STR(event->arrivalTime));
+        }
+        else {
+            switch (change.type) {
+                case FESChange::INSERTED:
+                    fes->remove(e);
+                    if (change.isNew)
+                        deleteEvent(change.ref);
+                    break;
+                case FESChange::RESCHEDULED: {
+                    fes->reschedule(e, change.oldTime);
+                    cMessage *msg = static_cast<cMessage *>(e);
+                    msg->setSentFrom(msg->getSenderModule(), msg->getSenderGateId(), change.oldSendingTime);
+                    break;
+                }
+                case FESChange::CANCELLED:
+                    e->setArrivalTime(change.oldTime);
+                    fes->insert(e);
+                    break;
+            }
+        }
+        releaseRef(change.ref);
+    }
+    event->fesChanges.clear();
+
+    // restore the state of the module
+    cSimpleModule *module = static_cast<cSimpleModule *>(sim->getModule(event->moduleId));
+    if (event->state) {
+        restoreModuleState(module, event->state);
+        recycleBuffer(event->state);
+        event->state = nullptr;
+    }
+
+    // put back the message into the FES. Self-messages are kept, because the
+    // module may hold a pointer to them; other messages are replaced by the copy
+    // made before the delivery, as the module may have modified or deleted them
+    cMessage *backup = event->backup;
+    event->backup = nullptr;
+    cMessage *msg = static_cast<cMessage *>(event->msgRef->event);
+    if (msg && backup->isSelfMessage()) {
+        msg->setArrival(backup->getArrivalModuleId(), backup->getArrivalGateId(), backup->getArrivalTime());
+        msg->setSchedulingPriority(backup->getSchedulingPriority());
+        msg->setSentFrom(sim->getModule(backup->getSenderModuleId()), backup->getSenderGateId(), backup->getSendingTime());
+        delete backup;
+    }
+    else {
+        if (msg)
+            deleteEvent(event->msgRef);
+        replaceRef(event->msgRef, backup);
+        msg = backup;
+    }
+    fes->insert(msg);
+    releaseRef(event->msgRef);
+    event->msgRef = nullptr;
+
+    // cancel the messages sent to other partitions
+    for (auto it = event->sentMessages.rbegin(); it != event->sentMessages.rend(); ++it)
+        sendAntiMessage(*it);
+}
+
+//----
+
+void cTimeWarpProtocol::processOutgoingMessage(cMessage *msg, int destProcId, int destModuleId, int destGateId, void *)
+{
+    long seqNum = nextSeqNum++;
+    simtime_t arrivalTime = msg->getArrivalTime();
+    if (currentEvent)
+        currentEvent->sentMessages.push_back(SentMessage {destProcId, seqNum, arrivalTime, msg->getSchedulingPriority()});
+    if (arrivalTime < minSentTime)
+        minSentTime = arrivalTime;
+
+    {if (debug) EV << "sending '" << msg->getName() << "' (#" << seqNum << ") to " << destProcId << ", arrival time " << arrivalTime << "\n";}
+
+    cCommBuffer *buffer = comm->createCommBuffer();
+    buffer->pack(destModuleId);
+    buffer->pack(destGateId);
+    buffer->pack(seqNum);
+    buffer->packObject(msg);
+    comm->send(buffer, TAG_TIMEWARP_MESSAGE, destProcId);
+    comm->recycleCommBuffer(buffer);
+}
+
+void cTimeWarpProtocol::sendAntiMessage(const SentMessage& sentMessage)
+{
+    {if (debug) EV << "sending anti-message for #" << sentMessage.seqNum << " to " << sentMessage.destProcId << "\n";}
+
+    if (sentMessage.arrivalTime < minSentTime)
+        minSentTime = sentMessage.arrivalTime;
+
+    cCommBuffer *buffer = comm->createCommBuffer();
+    buffer->pack(sentMessage.seqNum);
+    buffer->pack(sentMessage.arrivalTime);
+    buffer->pack(sentMessage.priority);
+    comm->send(buffer, TAG_TIMEWARP_ANTIMESSAGE, sentMessage.destProcId);
+    comm->recycleCommBuffer(buffer);
+    numAntiMessages++;
+}
+
+void cTimeWarpProtocol::processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId)
+{
+    int destModuleId;
+    int destGateId;
+    long seqNum;
+    long round;
+    simtime_t time;
+    short priority;
+    cMessage *msg;
+
+    switch (tag) {
+        case TAG_TIMEWARP_MESSAGE:
+            buffer->unpack(destModuleId);
+            buffer->unpack(destGateId);
+            buffer->unpack(seqNum);
+            msg = (cMessage *)buffer->unpackObject();
+            processReceivedMessage(msg, destModuleId, destGateId, seqNum, sourceProcId);
+            break;
+
+        case TAG_TIMEWARP_ANTIMESSAGE:
+            buffer->unpack(seqNum);
+            buffer->unpack(time);
+            buffer->unpack(priority);
+            processReceivedAntiMessage(sourceProcId, seqNum, time, priority);
+            break;
+
+        case TAG_TIMEWARP_GVT:
+            buffer->unpack(round);
+            buffer->unpack(time);
+            {if (debug) EV << "GVT report for round #" << round << " received from " << sourceProcId << ": " << time << "\n";}
+            processReceivedGVTReport(round, time);
+            break;
+
+        default:
+            cParsimProtocolBase::processReceivedBuffer(buffer, tag, sourceProcId);
+            return;
+    }
+    buffer->assertBufferEmpty();
+}
+
+void cTimeWarpProtocol::processReceivedMessage(cMessage *msg, int destModuleId, int destGateId, long seqNum, int sourceProcId)
+{
+    {if (debug) EV << "received '" << msg->getName() << "' (#" << seqNum << ") from " << sourceProcId << ", arrival time " << msg->getArrivalTime() << "\n";}
+
+    // a straggler: undo the events that should have come after it
+    rollback(msg->getArrivalTime(), msg->getSchedulingPriority(), false);
+
+    receivedMessages[std::make_pair(sourceProcId, seqNum)] = ReceivedMessage {getRef(msg), msg->getArrivalTime()};
+    partition->processReceivedMessage(msg, destModuleId, destGateId, sourceProcId);
+}
+
+void cTimeWarpProtocol::processReceivedAntiMessage(int sourceProcId, long seqNum, simtime_t arrivalTime, short priority)
+{
+    {if (debug) EV << "received anti-message for #" << seqNum << " from " << sourceProcId << "\n";}
+
+    auto it = receivedMessages.find(std::make_pair(sourceProcId, seqNum));
+    if (it == receivedMessages.end())
+        throw cRuntimeError("cTimeWarpProtocol: Anti-message from partition %d refers to unknown message #%ld", sourceProcId, seqNum);
+
+    // if the message has already been executed, roll back until it is back in the FES
+    rollback(arrivalTime, priority, true);
+
+    EventRef *ref = it->second.ref;
+    if (ref->event)
+        deleteEvent(ref);
+    releaseRef(ref);
+    receivedMessages.erase(it);
+}
+
+void cTimeWarpProtocol::processReceivedGVTReport(long round, simtime_t minTime)
+{
+    // other partitions may be at most one round ahead of us, because they
+    // cannot finish the next round without our report
+    ASSERT(round == gvtRound || round == gvtRound + 1);
+    GVTReport& report = gvtReports[round % 2];
+    report.count++;
+    if (minTime < report.minTime)
+        report.minTime = minTime;
+}
+
+bool cTimeWarpProtocol::computeGVT()
+{
+    // the earliest time at which we may still execute an event or cause one in
+    // other partitions: messages and anti-messages we sent since our previous
+    // report may still be in transit
+    cEvent *first = sim->getFES()->peekFirst();
+    simtime_t minTime = first ? first->getArrivalTime() : SIMTIME_MAX;
+    if (minSentTime < minTime)
+        minTime = minSentTime;
+
+    {if (debug) EV << "GVT round #" << gvtRound << ", sending report: " << minTime << "\n";}
+
+    cCommBuffer *buffer = comm->createCommBuffer();
+    buffer->pack(gvtRound);
+    buffer->pack(minTime);
+    comm->broadcast(buffer, TAG_TIMEWARP_GVT);
+    comm->recycleCommBuffer(buffer);
+    minSentTime = SIMTIME_MAX;
+
+    // wait for the reports of all partitions (including ours). Channels are
+    // FIFO, so messages sent before a report are received before it, and any
+    // straggler among them is accounted for in the sender's report.
+    processReceivedGVTReport(gvtRound, minTime);
+    GVTReport& report = gvtReports[gvtRound % 2];
+    while (report.count < comm->getNumPartitions())
+        if (!receiveBlocking())
+            return false;
+
+    ASSERT(report.minTime >= gvt);
+    gvt = report.minTime;
+    report = {0, SIMTIME_MAX};
+    gvtRound++;
+    eventsSinceGVT = 0;
+
+    {if (debug) EV << "GVT is now " << gvt << "\n";}
+
+    fossilCollect(gvt);
+
+    if (gvt == SIMTIME_MAX)
+        throw cTerminationException(E_ENDEDOK);
+    return true;
+}
+
+cEvent *cTimeWarpProtocol::takeNextEvent()
+{
+    // the previous event is over, stop recording FES changes
+    currentEvent = nullptr;
+
+    while (true) {
+        receiveNonblocking();
+
+        if (eventsSinceGVT >= gvtInterval) {
+            if (!computeGVT())
+                return nullptr;
+            continue;
+        }
+
+        cEvent *event = sim->getFES()->peekFirst();
+        if (!event) {
+            // nothing to do until other partitions send us something
+            if (!computeGVT())
+                return nullptr;
+            continue;
+        }
+
+        if (!event->isMessage()) {
+            // such events cannot be rolled back, so they are only executed when
+            // they are known to be safe
+            if (event->getArrivalTime() > gvt) {
+                if (!computeGVT())
+                    return nullptr;
+                continue;
+            }
+            return sim->getFES()->removeFirst();
+        }
+
+        if (event->isDeferred())
+            throw cRuntimeError("cTimeWarpProtocol: cTimeoutTimer is not supported");
+
+        cMessage *msg = static_cast<cMessage *>(sim->getFES()->removeFirst());
+        beginEvent(msg);
+        eventsSinceGVT++;
+        return msg;
+    }
+}
+
+void cTimeWarpProtocol::putBackEvent(cEvent *event)
+{
+    if (currentEvent && currentEvent->msgRef->event == event) {
+        // forget the records made in takeNextEvent()
+        processedEvents.pop_back();
+        commitEvent(currentEvent);
+        currentEvent = nullptr;
+        numEvents--;
+        eventsSinceGVT--;
+    }
+    sim->getFES()->putBackFirst(event);
+}
+
+}  // namespace omnetpp
+
@@ -0,0 +1,269 @@
+//=========================================================================
+//  CTIMEWARPPROT.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2003-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CTIMEWARPPROT_H
+#define __OMNETPP_CTIMEWARPPROT_H
+
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "omnetpp/cfutureeventset.h"
+#include "cparsimprotocolbase.h"
+
+namespace omnetpp {
+
+class cCommBuffer;
+class cMemCommBuffer;
+class cClassDescriptor;
+class cIStateSaving;
+class cSimpleModule;
+
+/**
+ * @brief Experimental implementation of the optimistic Time Warp
+ * synchronization protocol.
+ *
+ * Partitions execute their events without waiting for each other. When
+ * a message arrives from another partition with a timestamp smaller than
+ * that of events already executed (a "straggler"), the partition rolls back
+ * those events: it restores the state of the affected modules and the
+ * future event set, and sends anti-messages to cancel the messages these
+ * events sent to other partitions. An anti-message that arrives for an
+ * already executed message causes a rollback as well. This works without
+ * lookahead, so it is useful for models where the lookahead is too small
+ * for the conservative protocols.
+ *
+ * State saving is incremental: before delivering a message to a module,
+ * only the state of that module is saved. Modules may provide their own
+ * save/restore code by implementing cIStateSaving; other modules are saved
+ * via their class descriptor (the fields declared in the module class
+ * itself). Changes to the FES are recorded via the cIFutureEventSetListener
+ * interface of the simulation kernel.
+ *
+ * Partitions periodically compute Global Virtual Time (GVT), the time
+ * before which no rollback can occur, in synchronous rounds over the
+ * communication channels (which are FIFO). The saved states and other
+ * records of events before GVT are then discarded. Events which are not
+ * messages (e.g. the one that ends the simulation at the time limit) are
+ * only executed when they are before or at GVT.
+ *
+ * Restrictions: modules must use handleMessage() and have a declared state
+ * (see above); self-messages that modules store pointers to must be created
+ * in initialize() and must not be deleted until the end of the simulation;
+ * modules must not keep other messages across events; modules and
+ * connections must not be created or deleted dynamically; channels are
+ * assumed to have no state (e.g. no datarate channels); cTimeoutTimer is
+ * not supported. Events with equal arrival time and priority may be executed
+ * in a different order after a rollback, as they are re-inserted into the FES.
+ * Output (log, statistics) produced by events which are later rolled back is
+ * not retracted, so results should be recorded in finish().
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cTimeWarpProtocol : public cParsimProtocolBase, public cIFutureEventSetListener
+{
+  protected:
+    // an event object referenced by the records of processed events; it may
+    // get deleted, or replaced by a copy during rollback
+    struct EventRef
+    {
+        cEvent *event;  // nullptr if the object has been deleted
+        int refCount;
+    };
+
+    // a change to the FES done by an event
+    struct FESChange
+    {
+        enum Type {INSERTED, RESCHEDULED, CANCELLED} type;
+        EventRef *ref;
+        simtime_t oldTime;  // arrival time before the change (RESCHEDULED, CANCELLED)
+        simtime_t oldSendingTime;  // sending time before the change (RESCHEDULED)
+        bool isNew;         // whether the event object was created by the event
+    };
+
+    // a message sent to another partition by an event
+    struct SentMessage
+    {
+        int destProcId;
+        long seqNum;
+        simtime_t arrivalTime;
+        short priority;
+    };
+
+    // record of an executed but not yet committed event
+    struct ProcessedEvent
+    {
+        simtime_t arrivalTime;
+        short priority;
+        int moduleId;
+        EventRef *msgRef;        // the message delivered to the module
+        cMessage *backup;        // copy of the message, as it was before delivery
+        cMemCommBuffer *state;   // state of the module before the event, or nullptr if stateless
+        std::vector<FESChange> fesChanges;
+        std::vector<SentMessage> sentMessages;
+    };
+
+    // how to save the state of a module
+    struct ModuleInfo
+    {
+        bool resolved = false;
+        cIStateSaving *hooks = nullptr;
+        cClassDescriptor *descriptor = nullptr;  // used if there are no hooks
+        int firstField = 0;  // fields of the descriptor before this index belong to cSimpleModule
+    };
+
+    // a message received from another partition which may still be cancelled by an anti-message
+    struct ReceivedMessage
+    {
+        EventRef *ref;
+        simtime_t arrivalTime;
+    };
+
+    struct GVTReport
+    {
+        int count;          // number of reports received
+        simtime_t minTime;  // minimum of the reported times
+    };
+
+    std::deque<ProcessedEvent *> processedEvents;  // in execution order
+    ProcessedEvent *currentEvent;                  // the event being executed, or nullptr
+    std::unordered_map<cEvent *, EventRef *> eventRefs;  // event objects being tracked
+    std::map<std::pair<int,long>, ReceivedMessage> receivedMessages;  // by (sourceProcId, seqNum)
+    std::vector<ModuleInfo> moduleInfos;  // indexed by module ID
+    std::vector<cMemCommBuffer *> spareBuffers;
+
+    long nextSeqNum;        // sequence number for the next message sent to another partition
+    simtime_t minSentTime;  // earliest timestamp of messages and anti-messages sent since the last GVT report
+
+    simtime_t gvt;
+    long gvtRound;          // index of the current GVT round
+    GVTReport gvtReports[2];  // reports of the current and the next round
+    int gvtInterval;        // number of events between GVT rounds
+    int eventsSinceGVT;
+
+    bool heapUsedCb;  // whether we turned off the circular buffer of cEventHeap
+
+    bool debug;
+
+    // statistics
+    long numEvents;
+    long numRollbacks;
+    long numRolledBackEvents;
+    long numAntiMessages;
+
+  protected:
+    // process buffers coming from other partitions
+    virtual void processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId) override;
+
+    // insert a message received from another partition into the FES; roll back if needed
+    virtual void processReceivedMessage(cMessage *msg, int destModuleId, int destGateId, long seqNum, int sourceProcId);
+
+    // cancel a message received earlier; roll back if it has already been executed
+    virtual void processReceivedAntiMessage(int sourceProcId, long seqNum, simtime_t arrivalTime, short priority);
+
+    // store the contents of a GVT report received from another partition
+    virtual void processReceivedGVTReport(long round, simtime_t minTime);
+
+    // performs a GVT round, and discards records of events before GVT; returns false if interrupted
+    virtual bool computeGVT();
+
+    // undo all processed events that come after (or, if inclusive, at) the given time and priority
+    virtual void rollback(simtime_t t, short priority, bool inclusive);
+
+    // undo a processed event
+    virtual void undoEvent(ProcessedEvent *event);
+
+    // discard the records of a processed event that cannot be rolled back any more
+    virtual void commitEvent(ProcessedEvent *event);
+
+    // commit processed events before the given time
+    virtual void fossilCollect(simtime_t t);
+
+    // record the state needed for rolling back the delivery of the message
+    virtual void beginEvent(cMessage *msg);
+
+    virtual void sendAntiMessage(const SentMessage& sentMessage);
+
+    // module state saving
+    virtual ModuleInfo& getModuleInfo(cSimpleModule *module);
+    virtual cMemCommBuffer *saveModuleState(cSimpleModule *module);
+    virtual void restoreModuleState(cSimpleModule *module, cMemCommBuffer *buffer);
+
+    // tracking of event objects
+    EventRef *getRef(cEvent *event);
+    void releaseRef(EventRef *ref);
+    void replaceRef(EventRef *ref, cEvent *event);
+    void deleteEvent(EventRef *ref);
+
+    cMemCommBuffer *createBuffer();
+    void recycleBuffer(cMemCommBuffer *buffer);
+
+    // discard all records, e.g. at the end of the run
+    void clear();
+
+  public:
+    /**
+     * Constructor.
+     */
+    cTimeWarpProtocol();
+
+    /**
+     * Destructor.
+     */
+    virtual ~cTimeWarpProtocol();
+
+    /**
+     * Called at the beginning of a simulation run.
+     */
+    virtual void startRun() override;
+
+    /**
+     * Called at the end of a simulation run.
+     */
+    virtual void endRun() override;
+
+    /**
+     * Scheduler function. Processes messages from other partitions (which
+     * may cause rollbacks), performs GVT rounds when due, and returns the
+     * next event optimistically.
+     */
+    virtual cEvent *takeNextEvent() override;
+
+    /**
+     * Undo takeNextEvent() -- it comes from the cScheduler interface.
+     */
+    virtual void putBackEvent(cEvent *event) override;
+
+    /**
+     * Sends the message out immediately, and records it in case it has
+     * to be cancelled by an anti-message later. Message batching is not
+     * used with this protocol.
+     */
+    virtual void processOutgoingMessage(cMessage *msg, int procId, int moduleId, int gateId, void *data) override;
+
+    /** @name cIFutureEventSetListener methods; they record the FES changes of the current event. */
+    //@{
+    virtual void eventInserted(cEvent *event) override;
+    virtual void eventRescheduled(cEvent *event, simtime_t oldTime) override;
+    virtual void eventCancelled(cEvent *event) override;
+    virtual void trackedEventDeleted(cEvent *event) override;
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
@@ -0,0 +1,232 @@
+//=========================================================================
+//  CYAWNSPROT.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2003-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include "omnetpp/cmessage.h"
+#include "omnetpp/cenvir.h"
+#include "omnetpp/cconfiguration.h"
+#include "omnetpp/cparsimcomm.h"
+#include "omnetpp/ccommbuffer.h"
+#include "omnetpp/globals.h"
+#include "omnetpp/cconfigoption.h"
+#include "omnetpp/regmacros.h"
+#include "omnetpp/cfutureeventset.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/errmsg.h"
+#include "cyawnsprot.h"
+#include "cnmplookahead.h"
+#include "cparsimpartition.h"
+#include "messagetags.h"
+
+namespace omnetpp {
+
+Register_Class(cYAWNSProtocol);
+
+Register_GlobalConfigOption(CFGID_PARSIM_YAWNSPROTOCOL_LOOKAHEAD_CLASS, "parsim-yawnsprotocol-lookahead-class", CFG_STRING, "cLinkDelayLookahead", "When `cYAWNSProtocol` is selected as parsim synchronization class: specifies the C++ class that calculates lookahead. The class should subclass from `cNMPLookahead`. The width of the time windows is the smallest lookahead of all partitions.");
+extern cConfigOption *CFGID_PARSIM_DEBUG;  // registered in cparsimpartition.cc
+
+cYAWNSProtocol::cYAWNSProtocol() : cParsimProtocolBase()
+{
+    windowIndex = 0;
+    windowEnd = SIMTIME_ZERO;
+    minSentTime = SIMTIME_MAX;
+    resetBarrier(barriers[0]);
+    resetBarrier(barriers[1]);
+
+    debug = getEnvir()->getConfig()->getAsBool(CFGID_PARSIM_DEBUG);
+    std::string lookhClass = getEnvir()->getConfig()->getAsString(CFGID_PARSIM_YAWNSPROTOCOL_LOOKAHEAD_CLASS);
+    lookaheadcalc = dynamic_cast<cNMPLookahead *>(createOne(lookhClass.c_str()));
+    if (!lookaheadcalc)
+        throw cRuntimeError("Class \"%s\" is not subclassed from cNMPLookahead", lookhClass.c_str());
+}
+
+cYAWNSProtocol::~cYAWNSProtocol()
+{
+    delete lookaheadcalc;
+}
+
+void cYAWNSProtocol::setContext(cSimulation *sim, cParsimPartition *seg, cParsimCommunications *co)
+{
+    cParsimProtocolBase::setContext(sim, seg, co);
+    lookaheadcalc->setContext(sim, seg, co);
+}
+
+void cYAWNSProtocol::resetBarrier(BarrierInfo& barrier)
+{
+    barrier.count = 0;
+    barrier.minTime = SIMTIME_MAX;
+    barrier.minLookahead = SIMTIME_MAX;
+}
+
+void cYAWNSProtocol::startRun()
+{
+    EV << "starting YAWNS Protocol...\n";
+
+    // the first window is empty: it ends with a barrier which determines
+    // where the simulation actually starts
+    windowIndex = 0;
+    windowEnd = SIMTIME_ZERO;
+    minSentTime = SIMTIME_MAX;
+    resetBarrier(barriers[0]);
+    resetBarrier(barriers[1]);
+
+    lookaheadcalc->startRun();
+
+    EV << "  setup done.\n";
+}
+
+void cYAWNSProtocol::endRun()
+{
+    lookaheadcalc->endRun();
+    EV << "cYAWNSProtocol: " << windowIndex << " time windows\n";
+}
+
+simtime_t cYAWNSProtocol::getLookahead()
+{
+    simtime_t lookahead = SIMTIME_MAX;
+    int myProcId = comm->getProcId();
+    for (int i = 0; i < comm->getNumPartitions(); i++) {
+        if (i != myProcId) {
+            simtime_t lookaheadToPartition = lookaheadcalc->getCurrentLookahead(i);
+            if (lookaheadToPartition < lookahead)
+                lookahead = lookaheadToPartition;
+        }
+    }
+    return lookahead;
+}
+
+void cYAWNSProtocol::processOutgoingMessage(cMessage *msg, int destProcId, int destModuleId, int destGateId, void *data)
+{
+    simtime_t arrivalTime = msg->getArrivalTime();
+    if (arrivalTime < windowEnd)
+        throw cRuntimeError("cYAWNSProtocol: Message (%s)%s sent to partition %d would arrive at t=%s, "
+                            "which is inside the current time window that ends at t=%s (lookahead violated)",
+                            msg->getClassName(), msg->getName(), destProcId, SIMTIME_STR(arrivalTime), SIMTIME_STR(windowEnd));
+    if (arrivalTime < minSentTime)
+        minSentTime = arrivalTime;
+
+    {if (debug) EV << "sending '" << msg->getName() << "' to " << destProcId << ", arrival time " << arrivalTime << "\n";}
+
+    cParsimProtocolBase::processOutgoingMessage(msg, destProcId, destModuleId, destGateId, data);
+}
+
+void cYAWNSProtocol::processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId)
+{
+    long index;
+    simtime_t minTime;
+    simtime_t lookahead;
+
+    switch (tag) {
+        case TAG_WINDOW_BARRIER:
+            buffer->unpack(index);
+            buffer->unpack(minTime);
+            buffer->unpack(lookahead);
+            {if (debug) EV << "barrier message for window #" << index << " received from " << sourceProcId << ": earliest event at " << minTime << ", lookahead=" << lookahead << "\n";}
+            processReceivedBarrier(index, minTime, lookahead);
+            buffer->assertBufferEmpty();
+            break;
+
+        default:
+            cParsimProtocolBase::processReceivedBuffer(buffer, tag, sourceProcId);
+            break;
+    }
+}
+
+void cYAWNSProtocol::processReceivedBarrier(long index, simtime_t minTime, simtime_t lookahead)
+{
+    // other partitions may be at most one window ahead of us, because they
+    // cannot finish the next window without our barrier message
+    ASSERT(index == windowIndex || index == windowIndex + 1);
+    BarrierInfo& barrier = barriers[index % 2];
+    barrier.count++;
+    if (minTime < barrier.minTime)
+        barrier.minTime = minTime;
+    if (lookahead < barrier.minLookahead)
+        barrier.minLookahead = lookahead;
+}
+
+bool cYAWNSProtocol::advanceWindow()
+{
+    // messages held back for other partitions must go out before our barrier message
+    flushOutgoingMessages();
+
+    // the earliest event we may still execute, or cause in other partitions
+    cEvent *event = sim->getFES()->peekFirst();
+    simtime_t minTime = event ? event->getArrivalTime() : SIMTIME_MAX;
+    if (minSentTime < minTime)
+        minTime = minSentTime;
+    simtime_t lookahead = getLookahead();
+
+    {if (debug) EV << "end of window #" << windowIndex << ", sending barrier message: earliest event at " << minTime << ", lookahead=" << lookahead << "\n";}
+
+    cCommBuffer *buffer = comm->createCommBuffer();
+    buffer->pack(windowIndex);
+    buffer->pack(minTime);
+    buffer->pack(lookahead);
+    comm->broadcast(buffer, TAG_WINDOW_BARRIER);
+    comm->recycleCommBuffer(buffer);
+
+    // wait until we have the barrier messages of all partitions (including ours).
+    // Channels are FIFO, so this also means we have received all messages sent to us
+    // during the window.
+    processReceivedBarrier(windowIndex, minTime, lookahead);
+    BarrierInfo& barrier = barriers[windowIndex % 2];
+    while (barrier.count < comm->getNumPartitions())
+        if (!receiveBlocking())
+            return false;
+
+    // all partitions compute the same next window from the same data
+    simtime_t windowStart = barrier.minTime;
+    simtime_t windowWidth = barrier.minLookahead;
+    resetBarrier(barrier);
+    windowIndex++;
+    minSentTime = SIMTIME_MAX;
+
+    if (windowStart == SIMTIME_MAX)
+        throw cTerminationException(E_ENDEDOK);
+    if (windowWidth <= SIMTIME_ZERO)
+        throw cRuntimeError("cYAWNSProtocol: Zero lookahead, time windows cannot advance");
+
+    windowEnd = (windowWidth >= SIMTIME_MAX - windowStart) ? SIMTIME_MAX : windowStart + windowWidth;
+
+    {if (debug) EV << "window #" << windowIndex << ": [" << windowStart << ", " << windowEnd << ")\n";}
+    return true;
+}
+
+cEvent *cYAWNSProtocol::takeNextEvent()
+{
+    // send out messages batched during the previous event; with lookahead
+    // batching, they are only sent out at the end of the window
+    if (batching == BATCHING_EVENT)
+        flushOutgoingMessages();
+
+    while (true) {
+        cEvent *event = sim->getFES()->peekFirst();
+        if (event && event->getArrivalTime() < windowEnd)
+            return sim->getFES()->removeFirst();
+
+        // end of the window: synchronize with the other partitions
+        if (!advanceWindow())
+            return nullptr;
+    }
+}
+
+void cYAWNSProtocol::putBackEvent(cEvent *event)
+{
+    // the event is inside the current window, so this is safe
+    sim->getFES()->putBackFirst(event);
+}
+
+}  // namespace omnetpp
@@ -0,0 +1,141 @@
+//=========================================================================
+//  CYAWNSPROT.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2003-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CYAWNSPROT_H
+#define __OMNETPP_CYAWNSPROT_H
+
+#include "cparsimprotocolbase.h"
+
+namespace omnetpp {
+
+class cCommBuffer;
+class cNMPLookahead;
+
+/**
+ * @brief Implements a windowed conservative synchronization protocol,
+ * in the style of YAWNS ("Yet Another Windowing Network Simulator").
+ *
+ * All partitions advance together in time windows. Within a window, each
+ * partition executes its events independently, without any synchronization
+ * messages. When a partition reaches the end of the window, it broadcasts
+ * a barrier message that contains the timestamp of its earliest pending
+ * event, taking into account the messages it has sent to other partitions
+ * during the window, and its current lookahead. After receiving the barrier
+ * messages of all other partitions, every partition computes the same next
+ * window: it starts at the global minimum of the reported timestamps, and
+ * its width is the smallest of the reported lookaheads. Windows that would
+ * contain no events are skipped this way.
+ *
+ * Since the communication channels between partitions are FIFO, all messages
+ * that a partition sent during a window are received before its barrier
+ * message.
+ *
+ * The protocol works best if lookahead is fairly uniform across the links
+ * between partitions; then it requires far fewer synchronization messages
+ * than the null message algorithm (cNullMessageProtocol). Lookahead
+ * calculation is done by a cNMPLookahead object, like with the null message
+ * protocol.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cYAWNSProtocol : public cParsimProtocolBase
+{
+  protected:
+    struct BarrierInfo
+    {
+        int count;               // number of barrier messages received
+        simtime_t minTime;       // minimum of the reported earliest event times
+        simtime_t minLookahead;  // minimum of the reported lookaheads
+    };
+
+    // barrier messages received for the current and the next window;
+    // other partitions may already be one window ahead of us
+    BarrierInfo barriers[2];
+
+    long windowIndex;        // index of the current window
+    simtime_t windowEnd;     // events before this time are safe to execute
+    simtime_t minSentTime;   // earliest arrival time of messages sent out in the current window
+
+    bool debug;
+
+    cNMPLookahead *lookaheadcalc;
+
+  protected:
+    // process buffers coming from other partitions
+    virtual void processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId) override;
+
+    // store the contents of a barrier message received from another partition
+    virtual void processReceivedBarrier(long index, simtime_t minTime, simtime_t lookahead);
+
+    // returns the minimum lookahead of this partition to other partitions
+    virtual simtime_t getLookahead();
+
+    // sends our barrier message, waits for those of the other partitions, and calculates
+    // the next window; returns false if interrupted, or if there are no more events
+    virtual bool advanceWindow();
+
+    // resets the given barrier info
+    static void resetBarrier(BarrierInfo& barrier);
+
+  public:
+    /**
+     * Constructor.
+     */
+    cYAWNSProtocol();
+
+    /**
+     * Destructor.
+     */
+    virtual ~cYAWNSProtocol();
+
+    /**
+     * Redefined because we have to pass the same data to the lookahead calculator object
+     * (cNMPLookahead) too.
+     */
+    virtual void setContext(cSimulation *sim, cParsimPartition *seg, cParsimCommunications *co) override;
+
+    /**
+     * Called at the beginning of a simulation run.
+     */
+    virtual void startRun() override;
+
+    /**
+     * Called at the end of a simulation run.
+     */
+    virtual void endRun() override;
+
+    /**
+     * Scheduler function. Returns events of the current window, and
+     * performs the barrier synchronization at the end of the window.
+     */
+    virtual cEvent *takeNextEvent() override;
+
+    /**
+     * Undo takeNextEvent() -- it comes from the cScheduler interface.
+     */
+    virtual void putBackEvent(cEvent *event) override;
+
+    /**
+     * Checks that the message does not arrive within the current window,
+     * and records its timestamp, then sends it out.
+     */
+    virtual void processOutgoingMessage(cMessage *msg, int procId, int moduleId, int gateId, void *data) override;
+};
+
+}  // namespace omnetpp
+
+
+#endif
@@ -31,7 +31,13 @@ enum {
      TAG_NULLMESSAGE,
      TAG_CMESSAGE_WITH_NULLMESSAGE,
      TAG_TERMINATIONEXCEPTION,
-     TAG_EXCEPTION
+     TAG_EXCEPTION,
+     TAG_CMESSAGE_BATCH,
+     TAG_CMESSAGE_BATCH_WITH_NULLMESSAGE,
+     TAG_WINDOW_BARRIER,
+     TAG_TIMEWARP_MESSAGE,
+     TAG_TIMEWARP_ANTIMESSAGE,
+     TAG_TIMEWARP_GVT
 };
 
 #endif
@@ -22,6 +22,7 @@
 #include "omnetpp/checkandcast.h"
 #include "omnetpp/cpsquare.h"
 #include "omnetpp/cksplit.h"
+#include "omnetpp/cstringtokenizer.h"
 #include "omnetpp/resultrecorders.h"
 #include "common/stringutil.h"
 
@@ -400,6 +401,165 @@ std::string TimeAverageRecorder::str() const
 
 //---
 
+static const struct {
+    const char *name;
+    FusedRecorder::Mode mode;
+} fusedModes[] = {
+    {"count", FusedRecorder::COUNT},
+    {"sum", FusedRecorder::SUM},
+    {"mean", FusedRecorder::MEAN},
+    {"min", FusedRecorder::MIN},
+    {"max", FusedRecorder::MAX},
+    {"avg", FusedRecorder::AVG},
+    {"last", FusedRecorder::LAST},
+    {"timeavg", FusedRecorder::TIMEAVG},
+    {"vector", FusedRecorder::VECTOR},
+};
+
+bool FusedRecorder::supportsMode(const char *mode)
+{
+    for (auto& entry : fusedModes)
+        if (strcmp(entry.name, mode) == 0)
+            return true;
+    return false;
+}
+
+void FusedRecorder::init(cComponent *component, const char *statsName, const char *recordingMode, cProperty *attrsProperty, opp_string_map *manualAttrs)
+{
+    cNumericResultRecorder::init(component, statsName, recordingMode, attrsProperty, manualAttrs);
+
+    cStringTokenizer tokenizer(recordingMode, ",");
+    while (const char *token = tokenizer.nextToken()) {
+        bool found = false;
+        for (auto& entry : fusedModes) {
+            if (strcmp(entry.name, token) == 0) {
+                modes.push_back(std::make_pair(entry.mode, getPooled(token)));
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            throw cRuntimeError("%s: Unsupported recording mode '%s'", getClassName(), token);
+    }
+
+    // same as in MeanRecorder
+    opp_string_map attrs = getStatisticAttributes();
+    auto it = attrs.find("timeWeighted");
+    timeWeighted = it != attrs.end() && (it->second != "0" && it->second != "false");
+
+    for (auto& mode : modes) {
+        if (mode.first == TIMEAVG || (mode.first == MEAN && timeWeighted))
+            needsTimeWeighted = true;
+        if (mode.first == VECTOR)
+            hasVector = true;
+    }
+}
+
+FusedRecorder::~FusedRecorder()
+{
+    if (handle != nullptr)
+        getEnvir()->deregisterOutputVector(handle);
+}
+
+void FusedRecorder::subscribedTo(cResultFilter *prev)
+{
+    cNumericResultRecorder::subscribedTo(prev);
+
+    // register the output vector like VectorRecorder does
+    if (hasVector) {
+        currentMode = "vector";
+        opp_string_map attributes = getStatisticAttributes();
+        handle = getEnvir()->registerOutputVector(getComponent()->getFullPath().c_str(), getResultName().c_str());
+        ASSERT(handle != nullptr);
+        for (auto & attribute : attributes)
+            getEnvir()->setVectorAttribute(handle, attribute.first.c_str(), attribute.second.c_str());
+        currentMode = nullptr;
+    }
+}
+
+void FusedRecorder::collect(simtime_t_cref t, double value, cObject *details)
+{
+    if (hasVector && t < lastTime) {
+        throw cRuntimeError("%s: Cannot record data with an earlier timestamp (t=%s) "
+                            "than the previously recorded value (t=%s)",
+                getClassName(), SIMTIME_STR(t), SIMTIME_STR(lastTime));
+    }
+
+    if (!std::isnan(value)) {
+        count++;
+        sum += value;
+        if (value < min)
+            min = value;
+        if (value > max)
+            max = value;
+        last = value;
+    }
+    if (needsTimeWeighted) {
+        if (!std::isnan(lastValue)) {
+            totalTime += t - lastTime;
+            weightedSum += lastValue * SIMTIME_DBL(t - lastTime);
+        }
+        lastValue = value;
+    }
+    lastTime = t;
+
+    if (hasVector)
+        getEnvir()->recordInOutputVector(handle, t, value);
+}
+
+double FusedRecorder::getTimeAverage() const
+{
+    simtime_t tmpTotalTime = totalTime;
+    double tmpWeightedSum = weightedSum;
+
+    if (!std::isnan(lastValue)) {
+        simtime_t t = getSimulation()->getSimTime();
+        tmpTotalTime += t - lastTime;
+        tmpWeightedSum += lastValue * SIMTIME_DBL(t - lastTime);
+    }
+    return tmpWeightedSum / tmpTotalTime;
+}
+
+double FusedRecorder::getResult(Mode mode) const
+{
+    switch (mode) {
+        case COUNT: return count;
+        case SUM: return sum;
+        case MEAN: return timeWeighted ? getTimeAverage() : sum / count;
+        case MIN: return isPositiveInfinity(min) ? NaN : min;
+        case MAX: return isNegativeInfinity(max) ? NaN : max;
+        case AVG: return sum / count;
+        case LAST: return last;
+        case TIMEAVG: return getTimeAverage();
+        default: return NaN;
+    }
+}
+
+void FusedRecorder::finish(cResultFilter *prev)
+{
+    // record the results in the order and with the names and attributes of the individual recorders
+    for (auto& mode : modes) {
+        if (mode.first == VECTOR)
+            continue;
+        currentMode = mode.second;
+        opp_string_map attributes = getStatisticAttributes();
+        getEnvir()->recordScalar(getComponent(), getResultName().c_str(), getResult(mode.first), &attributes);
+    }
+    currentMode = nullptr;
+}
+
+std::string FusedRecorder::str() const
+{
+    std::stringstream os;
+    os << getResultName() << ":";
+    for (auto& mode : modes)
+        if (mode.first != VECTOR)
+            os << " " << mode.second << "=" << getResult(mode.first);
+    return os.str();
+}
+
+//---
+
 StatisticsRecorder::StatisticsRecorder()
 {
 }
@@ -0,0 +1,109 @@
+//
+// This file is part of an OMNeT++/OMNEST simulation example.
+//
+// Copyright (C) 2010 Andras Varga
+//
+// This file is distributed WITHOUT ANY WARRANTY. See the file
+// `license' for details on this and other legal matters.
+//
+
+#include <chrono>
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+// implements cIStateSaving, so that it can be used with cTimeWarpProtocol
+class Node : public cSimpleModule, public cIStateSaving
+{
+  protected:
+    cMessage *timer = nullptr;
+    uint64_t state = 0;     // generates the intervals, destinations and kinds of sent packets
+    long numSent = 0;
+    long numReceived = 0;
+    uint64_t checksum = 0;  // sum of hashes of received packets (independent of their order)
+
+  public:
+    virtual ~Node();
+
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+    virtual void finish() override;
+    virtual void saveState(cCommBuffer *buffer) const override;
+    virtual void restoreState(cCommBuffer *buffer) override;
+    uint64_t next();
+};
+
+Define_Module(Node);
+
+Node::~Node()
+{
+    cancelAndDelete(timer);
+}
+
+uint64_t Node::next()
+{
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state >> 33;
+}
+
+void Node::initialize()
+{
+    state = getIndex() + 1;
+    timer = new cMessage("timer");
+    scheduleAt(SimTime(next() % 1000000, SIMTIME_NS), timer);
+}
+
+void Node::handleMessage(cMessage *msg)
+{
+    double eventCost = par("eventCost").doubleValue();
+    if (eventCost > 0) {
+        auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds((int64_t)(eventCost * 1e9));
+        while (std::chrono::steady_clock::now() < until)
+            ;
+    }
+
+    if (msg == timer) {
+        cPacket *pkt = new cPacket("data", next() % 4);
+        pkt->setByteLength(100 + next() % 100);
+        send(pkt, "out", next() % gateSize("out"));
+        if (++numSent < (long)par("numMessages"))
+            scheduleAt(simTime() + SimTime(1 + next() % 1000000, SIMTIME_NS), timer);
+    }
+    else {
+        numReceived++;
+        checksum += ((uint64_t)msg->getArrivalTime().raw() * 31 + msg->getKind()) * 1000003 + check_and_cast<cPacket *>(msg)->getByteLength();
+
+        // kind=0 packets delay the next packet of this node
+        if (msg->getKind() == 0 && timer->isScheduled()) {
+            cancelEvent(timer);
+            scheduleAt(timer->getArrivalTime() + SimTime(100, SIMTIME_US), timer);
+        }
+        delete msg;
+    }
+}
+
+void Node::saveState(cCommBuffer *buffer) const
+{
+    buffer->pack(state);
+    buffer->pack(numSent);
+    buffer->pack(numReceived);
+    buffer->pack(checksum);
+}
+
+void Node::restoreState(cCommBuffer *buffer)
+{
+    buffer->unpack(state);
+    buffer->unpack(numSent);
+    buffer->unpack(numReceived);
+    buffer->unpack(checksum);
+}
+
+void Node::finish()
+{
+    EV << getFullPath() << ": sent=" << numSent << " received=" << numReceived << " checksum=" << checksum << endl;
+    recordScalar("sent", numSent);
+    recordScalar("received", numReceived);
+    recordScalar("checksum", checksum % 1000000007);
+}
+